@@ -0,0 +1 @@
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -o cpu_tests cpu_tests.c
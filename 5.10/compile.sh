@@ -1 +1,3 @@
-gcc -O2 -fno-tree-vectorize -march=native -std=c11 -Wall -o ht_test ht_test.c 
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o ht_test ht_test.c ../common/isa.c ../common/topology.c ../common/sysfs.c ../common/corun.c ../common/perturb.c ../common/timing.c ../common/preflight.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o smt_matrix smt_matrix.c ../common/timing.c ../common/jit.c ../common/chase.c ../common/isa.c ../common/topology.c ../common/sysfs.c ../common/corun.c ../common/perturb.c ../common/preflight.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o covert_bench covert_bench.c ../common/jit.c ../common/chase.c ../common/clock.c ../common/pmu.c ../common/topology.c ../common/sysfs.c ../common/corun.c ../common/perturb.c ../common/preflight.c -lm -lpthread
@@ -0,0 +1,395 @@
+// covert_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds covert_bench)
+// Run:     ./covert_bench [port|l1d|btb|tlb|all] [smt|llc|socket | rxCPU txCPU]
+//          (default: all resources on an SMT sibling pair from topology.h)
+//
+// Covert-channel bandwidth between two threads through one shared
+// resource, to put numbers on sibling-to-sibling leakage. The sender
+// (tx) encodes a known bit stream in TSC-aligned symbol slots: for a 1 it
+// hammers the resource until the slot ends, for a 0 it pauses. The
+// receiver (rx) times a small probe of the same resource throughout
+// each slot and decodes the slot's mean probe time against a threshold
+// learned from an alternating preamble:
+//   port   8 imul chains (p1 only)          rx times 32 imuls
+//   l1d    16 lines of one L1D set          rx times its 8 lines of that set
+//   btb    2048 jitted taken jmps           rx times 256 taken jmps
+//   tlb    chase over 2048 pages            rx times a chase over 128 pages
+// Every resource is swept over symbol durations. For each it reports
+// raw bit rate (1/T), bit error rate over PAYLOAD_BITS of a balanced
+// pseudo-random payload, and capacity as the mutual information between
+// sent and decoded bits per symbol over T (for a symmetric channel this
+// is (1 - H(p)) / T; a receiver stuck on one value scores 0 whatever its
+// error rate). The plug-in estimate over PAYLOAD_BITS is biased upward,
+// so its finite-sample bias is subtracted, and a point is only credited
+// when a G-test rejects independence of sent and decoded bits at
+// p < 0.001; otherwise its capacity is 0.
+// Both threads are created pinned; the slot clock is the shared
+// (invariant) TSC.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <immintrin.h>
+#include "jit.h"
+#include "chase.h"
+#include "topology.h"
+#include "corun.h"
+#include "clock.h"
+#include "preflight.h"
+
+#define PREAMBLE_BITS 64      // 1010... for the threshold
+#define PAYLOAD_BITS  512
+#define TOTAL_BITS    (PREAMBLE_BITS + PAYLOAD_BITS)
+#define G_CRITICAL    10.83   // chi-square, 1 dof, p = 0.001
+#define START_US      200     // lead time before slot 0
+
+#define PAGE          4096
+#define L1D_RX_LINES  8
+#define L1D_TX_LINES  16
+#define BTB_RX_JUMPS  256
+#define BTB_TX_JUMPS  2048
+#define JMP_SPACING   16
+#define TLB_RX_PAGES  128
+#define TLB_TX_PAGES  2048
+
+static const double symbol_us[] = { 0.5, 1, 2, 5, 10, 20, 50, 100 };
+#define N_SYMBOLS ((int)(sizeof(symbol_us) / sizeof(symbol_us[0])))
+
+// ------------------ Buffers ------------------
+// chase over n fresh 4 KB pages; a fixed seed per buffer keeps the
+// orders the same from run to run
+static void **chase_pages(int n, size_t skew, uint64_t seed) {
+    uint8_t *base = chase_map_pages((size_t)n * PAGE);
+    void **start = base ? chase_build(base, n, PAGE, skew, &seed) : NULL;
+    if (!start) { perror("chase"); exit(1); }
+    return start;
+}
+
+// returns where it stopped, so a sender can resume a long chain
+static void **chase(void **p, int steps) {
+    for (int i = 0; i < steps; i++) p = (void **)*p;
+    return p;
+}
+
+// n taken jmps JMP_SPACING bytes apart, then ret
+static void (*build_jumps(jit_buf *code, int n))(void) {
+    if (jit_alloc(code, (size_t)n * JMP_SPACING + 64)) { perror("jit_alloc"); exit(1); }
+    for (int i = 0; i < n; i++) {
+        jit_seek(code, (size_t)i * JMP_SPACING);
+        jit_jmp(code, (size_t)(i + 1) * JMP_SPACING);
+    }
+    jit_seek(code, (size_t)n * JMP_SPACING);
+    jit_ret(code);
+    if (jit_seal(code)) { perror("jit_seal"); exit(1); }
+    return (void (*)(void))jit_ptr(code, 0);
+}
+
+// one per side. The _Alignas puts each on its own cache lines, so a
+// timed probe never touches a line the other thread writes and the
+// channel cannot be carried by coherence traffic on the shared state
+typedef struct {
+    _Alignas(64) void **l1d;
+    void   **tlb;
+    void   (*btb)(void);
+    jit_buf  btb_code;
+    void    *sink;
+} channel_end;
+
+static channel_end tx_side, rx_side;
+
+static void channel_init(void) {
+    // rx and tx lines share page offset 0, so all 24 fall in one L1D set
+    rx_side.l1d = chase_pages(L1D_RX_LINES, 0, 11);
+    tx_side.l1d = chase_pages(L1D_TX_LINES, 0, 13);
+    rx_side.tlb = chase_pages(TLB_RX_PAGES, 64, 17);
+    tx_side.tlb = chase_pages(TLB_TX_PAGES, 64, 19);
+    rx_side.btb = build_jumps(&rx_side.btb_code, BTB_RX_JUMPS);
+    tx_side.btb = build_jumps(&tx_side.btb_code, BTB_TX_JUMPS);
+}
+
+// ------------------ Resources ------------------
+// tx: one burst of pressure; rx: one probe (timed by the caller)
+static void port_tx(void) {
+    uint64_t a = 3, b = 5, c = 7, d = 9, e = 11, f = 13, g = 15, h = 17;
+    for (int i = 0; i < 16; i++)
+        __asm__ volatile("imul %0, %0\n\timul %1, %1\n\timul %2, %2\n\timul %3, %3\n\t"
+                         "imul %4, %4\n\timul %5, %5\n\timul %6, %6\n\timul %7, %7"
+                         : "+r"(a), "+r"(b), "+r"(c), "+r"(d), "+r"(e), "+r"(f), "+r"(g), "+r"(h));
+    tx_side.sink = (void *)(a ^ b ^ c ^ d ^ e ^ f ^ g ^ h);
+}
+
+static void port_rx(void) {
+    uint64_t a = 3, b = 5, c = 7, d = 9;
+    for (int i = 0; i < 8; i++)
+        __asm__ volatile("imul %0, %0\n\timul %1, %1\n\timul %2, %2\n\timul %3, %3"
+                         : "+r"(a), "+r"(b), "+r"(c), "+r"(d));
+    rx_side.sink = (void *)(a ^ b ^ c ^ d);
+}
+
+static void l1d_tx(void) { tx_side.sink = chase(tx_side.l1d, L1D_TX_LINES); }
+static void l1d_rx(void) { rx_side.sink = chase(rx_side.l1d, L1D_RX_LINES); }
+static void btb_tx(void) { tx_side.btb(); }
+static void btb_rx(void) { rx_side.btb(); }
+static void tlb_tx(void) { tx_side.tlb = chase(tx_side.tlb, 64); }
+static void tlb_rx(void) { rx_side.sink = chase(rx_side.tlb, TLB_RX_PAGES); }
+
+#define RESOURCES(X) \
+    X(port)          \
+    X(l1d)           \
+    X(btb)           \
+    X(tlb)
+
+static const struct {
+    const char *name;
+    void (*tx)(void);
+    void (*rx)(void);
+} resources[] = {
+#define RESOURCE_ENTRY(name) { #name, name##_tx, name##_rx },
+    RESOURCES(RESOURCE_ENTRY)
+#undef RESOURCE_ENTRY
+};
+#define N_RESOURCES ((int)(sizeof(resources) / sizeof(resources[0])))
+
+// ------------------ Bit Stream ------------------
+// preamble 1010..., then exactly PAYLOAD_BITS / 2 ones in a fixed-seed
+// shuffle: a short window of a PRBS is not balanced, and an unbalanced
+// payload lets a receiver stuck on the majority value beat 50% errors
+static void make_bits(uint8_t *bits) {
+    for (int i = 0; i < PREAMBLE_BITS; i++) bits[i] = !(i & 1);
+    uint8_t *payload = bits + PREAMBLE_BITS;
+    for (int i = 0; i < PAYLOAD_BITS; i++) payload[i] = i < PAYLOAD_BITS / 2;
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (int i = PAYLOAD_BITS - 1; i > 0; i--) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        int j = (int)(x % (uint64_t)(i + 1));
+        uint8_t t = payload[i]; payload[i] = payload[j]; payload[j] = t;
+    }
+}
+
+// ------------------ Sender / Receiver ------------------
+typedef struct {
+    int             resource;
+    uint64_t        slot_ticks;
+    const uint8_t  *bits;
+    double          metric[TOTAL_BITS];   // rx: mean probe ticks per slot
+    int             probes[TOTAL_BITS];
+    corun_barrier   ready;
+    _Atomic uint64_t t0;                  // slot 0 start, published by tx
+} channel_run;
+
+static void *sender_main(void *arg) {
+    channel_run *r = arg;
+    void (*tx)(void) = resources[r->resource].tx;
+    // locals: the receiver writes metric[] on the lines after these fields
+    const uint64_t slot = r->slot_ticks;
+    const uint8_t *bits = r->bits;
+    corun_barrier_wait(&r->ready);
+    uint64_t t0 = clk_tsc() + (uint64_t)(START_US * 1000 * clk_tsc_ghz());
+    atomic_store(&r->t0, t0);
+    for (int i = 0; i < TOTAL_BITS; i++) {
+        uint64_t end = t0 + (uint64_t)(i + 1) * slot;
+        while (clk_tsc() < t0 + (uint64_t)i * slot) _mm_pause();
+        if (bits[i]) while (clk_tsc() < end) tx();
+        else            while (clk_tsc() < end) _mm_pause();
+    }
+    return NULL;
+}
+
+static void *receiver_main(void *arg) {
+    channel_run *r = arg;
+    void (*rx)(void) = resources[r->resource].rx;
+    const uint64_t slot = r->slot_ticks;
+    rx();
+    corun_barrier_wait(&r->ready);
+    uint64_t t0;
+    while (!(t0 = atomic_load(&r->t0))) _mm_pause();
+    while (clk_tsc() < t0) _mm_pause();
+    for (int i = 0; i < TOTAL_BITS; i++) {
+        uint64_t end = t0 + (uint64_t)(i + 1) * slot, sum = 0, now;
+        int n = 0;
+        while ((now = clk_tsc()) < end) {
+            rx();
+            uint64_t done = clk_tsc();
+            if (done > end) break;    // probe straddled the boundary
+            sum += done - now;
+            n++;
+        }
+        r->probes[i] = n;
+        r->metric[i] = n ? (double)sum / n : 0.0;
+    }
+    return NULL;
+}
+
+typedef struct {
+    double raw_bps, error_rate, capacity_bps;
+    double gap;          // (mean '1' - mean '0') / mean '0' over the preamble
+    double probes;       // mean probes per slot
+    double g_stat;       // G-test of sent vs decoded; credited above G_CRITICAL
+} channel_result;
+
+static double entropy2(double p) {
+    if (p <= 0.0 || p >= 1.0) return 0.0;
+    return -p * log2(p) - (1.0 - p) * log2(1.0 - p);
+}
+
+// I(sent; decoded) in bits per symbol = H(decoded) - H(decoded | sent)
+static double mutual_info(int count[2][2]) {
+    double n = count[0][0] + count[0][1] + count[1][0] + count[1][1];
+    double n0 = count[0][0] + count[0][1], n1 = count[1][0] + count[1][1];
+    double h_cond = 0.0;
+    if (n0 > 0) h_cond += n0 / n * entropy2(count[0][1] / n0);
+    if (n1 > 0) h_cond += n1 / n * entropy2(count[1][1] / n1);
+    return entropy2((count[0][1] + count[1][1]) / n) - h_cond;
+}
+
+// expected plug-in MI of independent bits: (2-1)(2-1) / (2 n ln 2)
+static double mutual_info_bias(double n) {
+    return 1.0 / (2.0 * n * log(2.0));
+}
+
+static channel_result run_channel(int resource, double us, int rx_cpu, int tx_cpu, const uint8_t *bits) {
+    static channel_run r;
+    memset(&r, 0, sizeof(r));
+    r.resource = resource;
+    r.slot_ticks = (uint64_t)(us * 1000.0 * clk_tsc_ghz());
+    r.bits = bits;
+    corun_barrier_init(&r.ready, 2);
+
+    pthread_t tx, rx;
+    int err = corun_spawn_pinned(&rx, rx_cpu, receiver_main, &r);
+    if (!err) err = corun_spawn_pinned(&tx, tx_cpu, sender_main, &r);
+    if (err) {
+        fprintf(stderr, "cannot start threads on CPUs %d/%d: %s\n", rx_cpu, tx_cpu, strerror(err));
+        exit(1);
+    }
+    pthread_join(tx, NULL);
+    pthread_join(rx, NULL);
+
+    // threshold halfway between the preamble's 1 and 0 means; the sign
+    // of the gap says which side is a 1
+    double m1 = 0.0, m0 = 0.0, probes = 0.0;
+    for (int i = 0; i < PREAMBLE_BITS; i++) {
+        if (bits[i]) m1 += r.metric[i]; else m0 += r.metric[i];
+    }
+    m1 /= PREAMBLE_BITS / 2;
+    m0 /= PREAMBLE_BITS / 2;
+    double threshold = (m0 + m1) / 2.0;
+    int count[2][2] = { { 0, 0 }, { 0, 0 } };   // [sent][decoded]
+    for (int i = PREAMBLE_BITS; i < TOTAL_BITS; i++) {
+        int bit = m1 >= m0 ? r.metric[i] > threshold : r.metric[i] < threshold;
+        if (!r.probes[i]) bit = 0;
+        count[bits[i]][bit]++;
+        probes += r.probes[i];
+    }
+
+    channel_result res;
+    res.raw_bps = 1e6 / us;
+    res.error_rate = (double)(count[0][1] + count[1][0]) / PAYLOAD_BITS;
+    double mi = mutual_info(count);
+    res.g_stat = 2.0 * PAYLOAD_BITS * log(2.0) * mi;
+    mi -= mutual_info_bias(PAYLOAD_BITS);
+    res.capacity_bps = res.g_stat > G_CRITICAL && mi > 0.0 ? res.raw_bps * mi : 0.0;
+    res.gap = m0 > 0.0 ? (m1 - m0) / m0 : 0.0;
+    res.probes = probes / PAYLOAD_BITS;
+    return res;
+}
+
+// ------------------ Main ------------------
+int main(int argc, char **argv) {
+    int only = -1;
+    if (argc > 1 && strcmp(argv[1], "all")) {
+        for (int k = 0; k < N_RESOURCES; k++)
+            if (!strcmp(argv[1], resources[k].name)) only = k;
+        if (only < 0) {
+            fprintf(stderr, "Usage: %s [port|l1d|btb|tlb|all] [smt|llc|socket | rxCPU txCPU]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static topology topo;
+    if (topo_load(&topo)) {
+        fprintf(stderr, "Could not read the CPU topology\n");
+        return 1;
+    }
+    int rx_cpu, tx_cpu;
+    const char *placement = "explicit";
+    if (argc > 3) {
+        rx_cpu = atoi(argv[2]);
+        tx_cpu = atoi(argv[3]);
+    } else {
+        int p = argc > 2 ? topo_placement_parse(argv[2]) : TOPO_SMT_PAIR;
+        if (p < 0 || topo_pair(&topo, p, &rx_cpu, &tx_cpu)) {
+            fprintf(stderr, "No %s pair among the allowed CPUs; pass rxCPU txCPU explicitly\n",
+                    p < 0 ? argv[2] : topo_placement_name(p));
+            return 1;
+        }
+        placement = topo_placement_name(p);
+    }
+
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+    clk_calibrate();
+    channel_init();
+    static uint8_t bits[TOTAL_BITS];
+    make_bits(bits);
+
+    static preflight pf;
+    if (preflight_gate(&pf, rx_cpu, stdout)) return 1;
+
+    FILE *fp = fopen("results_covert.txt", "w");
+    FILE *csv = fopen("covert_results.csv", "w");
+    if (!fp || !csv) {
+        fprintf(stderr, "Could not open results files\n");
+        return 1;
+    }
+    topo_describe(&topo, fp);
+    fprintf(fp, "Host %s: receiver on CPU %d, sender on CPU %d (%s), TSC %.3f GHz\n",
+            host, rx_cpu, tx_cpu, placement, clk_tsc_ghz());
+    fprintf(fp, "%d preamble + %d payload bits per run\n", PREAMBLE_BITS, PAYLOAD_BITS);
+    fprintf(csv, "host,placement,resource,symbol_us,raw_bps,error_rate,capacity_bps,gap,probes_per_slot,g_stat\n");
+
+    for (int k = 0; k < N_RESOURCES; k++) {
+        if (only >= 0 && k != only) continue;
+        fprintf(fp, "\n=== %s ===\n", resources[k].name);
+        fprintf(fp, "| Symbol (us) | Raw kbit/s | Error rate | Capacity kbit/s | 1/0 gap | Probes/slot |\n");
+        fprintf(fp, "|-------------|------------|------------|-----------------|---------|-------------|\n");
+        double best = 0.0, best_us = 0.0;
+        for (int s = 0; s < N_SYMBOLS; s++) {
+            channel_result c = run_channel(k, symbol_us[s], rx_cpu, tx_cpu, bits);
+            fprintf(fp, "| %-11.1f | %-10.1f | %-10.4f | %-15.2f | %+6.1f%% | %-11.1f |\n",
+                    symbol_us[s], c.raw_bps / 1e3, c.error_rate, c.capacity_bps / 1e3,
+                    100.0 * c.gap, c.probes);
+            fprintf(csv, "%s,%s,%s,%.1f,%.1f,%.5f,%.1f,%.4f,%.1f,%.2f\n", host, placement,
+                    resources[k].name, symbol_us[s], c.raw_bps, c.error_rate, c.capacity_bps,
+                    c.gap, c.probes, c.g_stat);
+            printf("%-5s %6.1f us: error %.4f, capacity %.2f kbit/s\n", resources[k].name,
+                   symbol_us[s], c.error_rate, c.capacity_bps / 1e3);
+            if (c.capacity_bps > best) {
+                best = c.capacity_bps;
+                best_us = symbol_us[s];
+            }
+        }
+        if (best > 0.0)
+            fprintf(fp, "Best: %.2f kbit/s at %.1f us symbols\n", best / 1e3, best_us);
+        else
+            fprintf(fp, "Best: no usable channel\n");
+    }
+    if (rx_cpu == tx_cpu)
+        fprintf(fp, "\nNote: sender and receiver on the same CPU time-slice; this is not an SMT measurement\n");
+
+    fclose(fp);
+    fclose(csv);
+    preflight_save(&pf, "covert_results.csv");
+    printf("All results written to results_covert.txt and covert_results.csv\n");
+    return 0;
+}
@@ -0,0 +1,130 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+#include <x86intrin.h>
+#include "isa.h"
+#include "topology.h"
+#include "corun.h"
+#include "timing.h"
+#include "preflight.h"
+
+#define DEFAULT_WINDOWS 200   // baseline + stress, interleaved by corun
+
+// --- Dependent AVX2 add chain, built for AVX2 and dispatched at run time
+static ISA_TARGET_AVX2 void avx2_chain(long n) {
+    __m256i x = _mm256_set1_epi32(1);
+    for (long i = 0; i < n; i++) {
+        x = _mm256_add_epi32(x, x); // dependency chain
+    }
+    __asm__ volatile("" :: "x"(x));
+}
+
+// --- Many conditional branches with short periodic patterns
+static void branch_loop(long n) {
+    volatile int sum = 0;
+    for (long i = 0; i < n; i++) {
+        if (i & 1) sum++;
+        if (i & 2) sum++;
+        if (i & 4) sum++;
+        if (i & 8) sum++;
+    }
+}
+
+// ROB: dependent ops fill the reorder buffer; BTB: many branch targets
+static void rob_kernel(void *state, long iters) { (void)state; avx2_chain(iters); }
+static void btb_kernel(void *state, long iters) { (void)state; branch_loop(iters); }
+
+static void log_windows(FILE *fp, const char *mode, const char *cond, const uint64_t *ticks, int n) {
+    for (int t = 0; t < n; t++)
+        fprintf(fp, "%s,%s,%d,%lu\n", mode, cond, t, (unsigned long)ticks[t]);
+}
+
+static int is_number(const char *s) {
+    char *end;
+    strtol(s, &end, 10);
+    return end != s && *end == '\0';
+}
+
+int main(int argc, char **argv) {
+    // ht_test <mode:R|B> [windows] [smt|llc|socket | coreA coreB]
+    // (coreA runs the stressor, coreB the measurement)
+    if (argc < 2 || (argv[1][0] != 'R' && argv[1][0] != 'B')) {
+        fprintf(stderr, "Usage: %s <mode:R|B> [windows] [smt|llc|socket | coreA coreB]\n", argv[0]);
+        return 1;
+    }
+    char mode = argv[1][0];
+    int windows = argc > 2 ? atoi(argv[2]) : DEFAULT_WINDOWS;
+    if (windows < 2) windows = DEFAULT_WINDOWS;
+    if (mode == 'R' && !isa_require(ISA_AVX2, "ROB test", NULL))
+        return 0;
+
+    int coreA, coreB;
+    const char *placement = "explicit";
+    if (argc > 4 && is_number(argv[3]) && is_number(argv[4])) {
+        coreA = atoi(argv[3]);
+        coreB = atoi(argv[4]);
+    } else {
+        static topology topo;
+        int p = argc > 3 ? topo_placement_parse(argv[3]) : TOPO_SMT_PAIR;
+        if (p < 0 || topo_load(&topo) || topo_pair(&topo, p, &coreA, &coreB)) {
+            fprintf(stderr, "No %s pair among the allowed CPUs; pass <coreA> <coreB> explicitly\n",
+                    p < 0 ? argv[3] : topo_placement_name(p));
+            return 1;
+        }
+        placement = topo_placement_name(p);
+    }
+    printf("%s pair: stressor on CPU %d, measurement on CPU %d, %d windows\n",
+           placement, coreA, coreB, windows);
+
+    static preflight pf;
+    if (preflight_gate(&pf, coreB, stdout)) return 1;
+
+    // Open results file; header only when it is new
+    FILE *fp = fopen("ht_results.csv", "a");
+    if (!fp) {
+        perror("fopen");
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    if (ftell(fp) == 0)
+        fprintf(fp, "Mode,Condition,Trial,Cycles\n");
+
+    void (*kernel)(void *, long) = mode == 'R' ? rob_kernel : btb_kernel;
+    uint64_t *baseline = malloc((windows + 1) / 2 * sizeof(uint64_t));
+    uint64_t *stressed = malloc((windows + 1) / 2 * sizeof(uint64_t));
+    corun_plan plan = {
+        .victim_cpu = coreB, .stressor_cpu = coreA, .windows = windows,
+        .victim   = { kernel, NULL, 10000000 },
+        .stressor = { kernel, NULL, 1000000 },
+        .baseline = baseline, .stressed = stressed,
+    };
+    static perturb screen;
+    if (perturb_open(&screen, coreB) == 0) plan.screen = &screen;
+    int err = corun_run(&plan);
+    if (err) {
+        fprintf(stderr, "cannot start threads on CPUs %d/%d: %s\n", coreA, coreB, strerror(err));
+        return 1;
+    }
+
+    const char *name = mode == 'R' ? "ROB" : "BTB";
+    if (plan.screen) {
+        perturb_summary(&screen, stdout, "Windows screened");
+        perturb_close(&screen);
+    }
+    log_windows(fp, name, "Baseline", baseline, plan.n_baseline);
+    log_windows(fp, name, "Stress", stressed, plan.n_stressed);
+    fclose(fp);
+    preflight_save(&pf, "ht_results.csv");
+
+    uint64_t base_med = median_u64(baseline, plan.n_baseline);
+    uint64_t stress_med = median_u64(stressed, plan.n_stressed);
+    printf("%s [Baseline] median of %d: %lu cycles\n", name, plan.n_baseline, (unsigned long)base_med);
+    printf("%s [Stress]   median of %d: %lu cycles\n", name, plan.n_stressed, (unsigned long)stress_med);
+    printf("%s slowdown: %.3f\n", name, (double)stress_med / base_med);
+    free(baseline);
+    free(stressed);
+    return 0;
+}
@@ -0,0 +1,379 @@
+// smt_matrix.c
+// ===============================================================
+// Compile: ./compile.sh   (builds smt_matrix)
+// Run:     ./smt_matrix [smt|llc|socket]   (pair picked from topology.h)
+//          ./smt_matrix cpuA cpuB          (explicit CPUs)
+//
+// SMT contention matrix. Every kernel below is run as the *victim* on
+// cpuA while every kernel (itself included) runs as the *stressor* on
+// its sibling cpuB (llc / socket pairs give the cross-core reference
+// for the same kernels); the cell is the victim's slowdown against running
+// with the sibling idle:
+//   alu         8 independent add chains          integer ALU ports
+//   shuffle     8 independent vpermq ymm chains   vector shuffle port (p5)
+//   load        8 L1-resident loads               load ports
+//   store       8 stores walking 256 KB           store buffer / L1 fills
+//   l1d_sets    chase 8 lines 4 KB apart          one L1D set (8 + 8 > ways)
+//   l1i_dsb     24 KB of runtime-generated nops   L1I / decoded-uop cache
+//   divider     dependent 64-bit div chain        divider
+//   branch      random 2048-long taken pattern    branch predictor tables
+//   tlb         chase 1024 pages, one line each   STLB capacity
+//   page_walk   chase 16384 pages                 page walker
+// Pairs run through corun.h: each cell is TRIALS baseline and TRIALS
+// stressed ~1 ms victim windows, interleaved, and the slowdown is the
+// ratio of their medians, so every cell has its own adjacent baseline.
+// Row = victim, column = stressor; (a,b) and (b,a) together say whether
+// two workloads can share a physical core.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "timing.h"
+#include "isa.h"
+#include "jit.h"
+#include "chase.h"
+#include "topology.h"
+#include "corun.h"
+#include "preflight.h"
+
+#define TRIALS        15
+#define WINDOW_TICKS  2000000.0   // victim window, ~1 ms at 2 GHz
+#define CAL_ITERS     2000
+#define SHARE_OK      1.10        // both directions at most 10% slower
+#define SHARE_AVOID   1.50
+
+#define PAGE          4096
+#define L1D_WAYS_USED 8
+#define STORE_BYTES   (256 << 10)
+#define L1I_BYTES     (24 << 10)
+#define BRANCH_PERIOD 2048
+#define TLB_PAGES     1024
+#define WALK_PAGES    16384
+
+static inline uint64_t rdtscp_serialized(void) {
+    unsigned lo, hi, aux;
+    __asm__ __volatile__("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux) :: "memory");
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// ------------------ Per-thread State ------------------
+// Victim and stressor each have their own buffers, so a kernel paired with itself
+// contends for the shared structure rather than sharing the data.
+typedef struct {
+    uint64_t  rng;
+    uint8_t  *load_buf;                 // 4 KB, L1-resident
+    uint8_t  *store_buf;                // STORE_BYTES
+    size_t    store_pos;
+    void    **l1d_chase, **tlb_chase, **walk_chase;
+    void     *l1d_mem, *tlb_mem, *walk_mem;
+    uint8_t   bits[BRANCH_PERIOD];
+    jit_buf   code;
+    void    (*l1i_loop)(long iters);
+    void     *sink;
+} kstate;
+
+static uint64_t next_rand(uint64_t *s) {
+    *s ^= *s << 13; *s ^= *s >> 7; *s ^= *s << 17;
+    return *s;
+}
+
+// top: L1I_BYTES of nops; dec %rdi; jnz top; ret
+static void build_l1i_loop(kstate *s) {
+    static const uint8_t dec_rdi[] = { 0x48, 0xFF, 0xCF };
+    if (jit_alloc(&s->code, L1I_BYTES + 64)) { perror("jit_alloc"); exit(1); }
+    jit_nops(&s->code, L1I_BYTES);
+    jit_emit(&s->code, dec_rdi, sizeof(dec_rdi));
+    jit_jcc(&s->code, JIT_CC_NE, 0);
+    jit_ret(&s->code);
+    if (jit_seal(&s->code)) { perror("jit_seal"); exit(1); }
+    s->l1i_loop = (void (*)(long))jit_ptr(&s->code, 0);
+}
+
+static void kstate_init(kstate *s, uint64_t seed) {
+    memset(s, 0, sizeof(*s));
+    s->rng = seed;
+    // 4 KB pages on purpose: the TLB kernels need one translation per page
+    s->load_buf  = chase_map_pages(PAGE);
+    s->store_buf = chase_map_pages(STORE_BYTES);
+    s->l1d_mem   = chase_map_pages((size_t)L1D_WAYS_USED * PAGE);
+    s->tlb_mem   = chase_map_pages((size_t)TLB_PAGES * PAGE);
+    s->walk_mem  = chase_map_pages((size_t)WALK_PAGES * PAGE);
+    if (!s->load_buf || !s->store_buf || !s->l1d_mem || !s->tlb_mem || !s->walk_mem) { perror("mmap"); exit(1); }
+    s->l1d_chase  = chase_build(s->l1d_mem, L1D_WAYS_USED, PAGE, 0, &s->rng);
+    s->tlb_chase  = chase_build(s->tlb_mem, TLB_PAGES, PAGE, 64, &s->rng);
+    s->walk_chase = chase_build(s->walk_mem, WALK_PAGES, PAGE, 64, &s->rng);
+    if (!s->l1d_chase || !s->tlb_chase || !s->walk_chase) { perror("chase_build"); exit(1); }
+    for (int i = 0; i < BRANCH_PERIOD; i++) s->bits[i] = next_rand(&s->rng) & 1;
+    build_l1i_loop(s);
+}
+
+static void kstate_free(kstate *s) {
+    munmap(s->load_buf, PAGE);
+    munmap(s->store_buf, STORE_BYTES);
+    munmap(s->l1d_mem, (size_t)L1D_WAYS_USED * PAGE);
+    munmap(s->tlb_mem, (size_t)TLB_PAGES * PAGE);
+    munmap(s->walk_mem, (size_t)WALK_PAGES * PAGE);
+    jit_free(&s->code);
+}
+
+// ------------------ Kernels ------------------
+static void run_alu(kstate *s, long iters) {
+    uint64_t a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7, h = 8;
+    for (long i = 0; i < iters; i++)
+        __asm__ volatile("add %0, %0\n\tadd %1, %1\n\tadd %2, %2\n\tadd %3, %3\n\t"
+                         "add %4, %4\n\tadd %5, %5\n\tadd %6, %6\n\tadd %7, %7"
+                         : "+r"(a), "+r"(b), "+r"(c), "+r"(d), "+r"(e), "+r"(f), "+r"(g), "+r"(h));
+    s->sink = (void *)(a ^ b ^ c ^ d ^ e ^ f ^ g ^ h);
+}
+
+// lane-crossing vpermq only issues on the shuffle port (p5) since Haswell
+static ISA_TARGET_AVX2 void run_shuffle(kstate *s, long iters) {
+    (void)s;
+    for (long i = 0; i < iters; i++)
+        __asm__ volatile("vpermq $0x1b, %%ymm0, %%ymm0\n\tvpermq $0x1b, %%ymm1, %%ymm1\n\t"
+                         "vpermq $0x1b, %%ymm2, %%ymm2\n\tvpermq $0x1b, %%ymm3, %%ymm3\n\t"
+                         "vpermq $0x1b, %%ymm4, %%ymm4\n\tvpermq $0x1b, %%ymm5, %%ymm5\n\t"
+                         "vpermq $0x1b, %%ymm6, %%ymm6\n\tvpermq $0x1b, %%ymm7, %%ymm7"
+                         ::: "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7");
+    __asm__ volatile("vzeroupper");
+}
+
+static void run_load(kstate *s, long iters) {
+    const uint8_t *p = s->load_buf;
+    for (long i = 0; i < iters; i++)
+        __asm__ volatile("mov (%0), %%rax\n\tmov 64(%0), %%rcx\n\tmov 128(%0), %%rdx\n\t"
+                         "mov 192(%0), %%r8\n\tmov 256(%0), %%r9\n\tmov 320(%0), %%r10\n\t"
+                         "mov 384(%0), %%r11\n\tmov 448(%0), %%rax"
+                         :: "r"(p) : "rax", "rcx", "rdx", "r8", "r9", "r10", "r11", "memory");
+}
+
+// consecutive lines of an L2-resident region: stores drain slowly and
+// keep the store buffer full
+static void run_store(kstate *s, long iters) {
+    size_t pos = s->store_pos;
+    for (long i = 0; i < iters; i++) {
+        uint8_t *p = s->store_buf + pos;
+        __asm__ volatile("mov %1, (%0)\n\tmov %1, 64(%0)\n\tmov %1, 128(%0)\n\tmov %1, 192(%0)\n\t"
+                         "mov %1, 256(%0)\n\tmov %1, 320(%0)\n\tmov %1, 384(%0)\n\tmov %1, 448(%0)"
+                         :: "r"(p), "r"((uint64_t)i) : "memory");
+        pos = (pos + 512) & (STORE_BYTES - 1);
+    }
+    s->store_pos = pos;
+}
+
+// returns where it stopped; kernels keep it as their cursor so short
+// stressor chunks still cover the whole chain
+static void **chase(void **p, long steps) {
+    for (long i = 0; i < steps; i++) p = (void **)*p;
+    return p;
+}
+
+static void run_l1d_sets(kstate *s, long iters) { s->l1d_chase = chase(s->l1d_chase, iters * 8); }
+static void run_tlb(kstate *s, long iters)      { s->tlb_chase = chase(s->tlb_chase, iters * 8); }
+static void run_page_walk(kstate *s, long iters) { s->walk_chase = chase(s->walk_chase, iters * 8); }
+
+static void run_l1i_dsb(kstate *s, long iters) { s->l1i_loop(iters); }
+
+static void run_divider(kstate *s, long iters) {
+    uint64_t q = 0x123456789abcdefULL, top = 1ULL << 62, d = 7;
+    for (long i = 0; i < iters; i++)
+        __asm__ volatile("xor %%edx, %%edx\n\tor %2, %0\n\tdivq %1\n\t"
+                         "xor %%edx, %%edx\n\tor %2, %0\n\tdivq %1"
+                         : "+a"(q) : "r"(d), "r"(top) : "rdx");
+    s->sink = (void *)q;
+}
+
+// the asm keeps it a real conditional branch (no cmov)
+static void run_branch(kstate *s, long iters) {
+    uint64_t x = 0;
+    for (long i = 0; i < iters; i++)
+        for (int j = 0; j < 8; j++) {
+            uint64_t b = s->bits[(i * 8 + j) & (BRANCH_PERIOD - 1)];
+            __asm__ volatile("test %1, %1\n\tjz 1f\n\tadd $1, %0\n1:" : "+r"(x) : "r"(b));
+        }
+    s->sink = (void *)x;
+}
+
+// X(name, isa)
+#define KERNELS(X)                 \
+    X(alu,       ISA_BASELINE)     \
+    X(shuffle,   ISA_AVX2)         \
+    X(load,      ISA_BASELINE)     \
+    X(store,     ISA_BASELINE)     \
+    X(l1d_sets,  ISA_BASELINE)     \
+    X(l1i_dsb,   ISA_BASELINE)     \
+    X(divider,   ISA_BASELINE)     \
+    X(branch,    ISA_BASELINE)     \
+    X(tlb,       ISA_BASELINE)     \
+    X(page_walk, ISA_BASELINE)
+
+static const struct {
+    const char *name;
+    isa_feature isa;
+    void (*run)(kstate *s, long iters);
+} kernels[] = {
+#define KERNEL_ENTRY(name, isa) { #name, isa, run_##name },
+    KERNELS(KERNEL_ENTRY)
+#undef KERNEL_ENTRY
+};
+#define N_KERNELS ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+// ------------------ Co-run ------------------
+typedef struct {
+    int     kernel;
+    kstate *state;
+} task_ctx;
+
+static void run_task(void *arg, long iters) {
+    task_ctx *c = arg;
+    kernels[c->kernel].run(c->state, iters);
+}
+
+static kstate victim_state, stressor_state;
+static long iters_for[N_KERNELS];    // calibrated window per kernel
+
+// victim_k on cpuA against stress_k on cpuB over 2 x TRIALS interleaved
+// windows; *base and *stressed are median ticks per iteration
+static void run_pair(int victim_k, int stress_k, int cpuA, int cpuB, double *base, double *stressed) {
+    task_ctx vc = { victim_k, &victim_state }, sc = { stress_k, &stressor_state };
+    uint64_t b[TRIALS], st[TRIALS];
+    corun_plan plan = {
+        .victim_cpu = cpuA, .stressor_cpu = cpuB, .windows = 2 * TRIALS,
+        .victim   = { run_task, &vc, iters_for[victim_k] },
+        .stressor = { run_task, &sc, iters_for[stress_k] / 16 + 1 },
+        .baseline = b, .stressed = st,
+    };
+    int err = corun_run(&plan);
+    if (err) {
+        fprintf(stderr, "cannot start threads on CPUs %d/%d: %s\n", cpuA, cpuB, strerror(err));
+        exit(1);
+    }
+    *base = (double)median_u64(b, plan.n_baseline) / iters_for[victim_k];
+    *stressed = (double)median_u64(st, plan.n_stressed) / iters_for[victim_k];
+}
+
+static double ticks_alone(int k, long iters) {
+    uint64_t t[TRIALS];
+    kernels[k].run(&victim_state, iters);
+    for (int i = 0; i < TRIALS; i++) {
+        uint64_t t0 = rdtscp_serialized();
+        kernels[k].run(&victim_state, iters);
+        t[i] = rdtscp_serialized() - t0;
+    }
+    return (double)median_u64(t, TRIALS) / iters;
+}
+
+// ------------------ Main ------------------
+int main(int argc, char **argv) {
+    static topology topo;
+    int cpuA, cpuB;
+    const char *placement = "explicit";
+    if (topo_load(&topo)) {
+        fprintf(stderr, "Could not read the CPU topology\n");
+        return 1;
+    }
+    topo_describe(&topo, stdout);
+    if (argc >= 3) {
+        cpuA = atoi(argv[1]);
+        cpuB = atoi(argv[2]);
+    } else {
+        int p = argc > 1 ? topo_placement_parse(argv[1]) : TOPO_SMT_PAIR;
+        if (p < 0) {
+            fprintf(stderr, "Usage: %s [smt|llc|socket | cpuA cpuB]\n", argv[0]);
+            return 1;
+        }
+        placement = topo_placement_name(p);
+        if (topo_pair(&topo, p, &cpuA, &cpuB)) {
+            fprintf(stderr, "No %s pair among the allowed CPUs; pass two CPUs explicitly\n", placement);
+            return 1;
+        }
+    }
+    printf("Victim on CPU %d, stressor on CPU %d (%s)\n", cpuA, cpuB, placement);
+
+    static preflight pf;
+    if (preflight_gate(&pf, cpuA, stdout)) return 1;
+
+    FILE *fp = fopen("results_smt_matrix.txt", "w");
+    FILE *csv = fopen("smt_matrix.csv", "w");
+    if (!fp || !csv) {
+        fprintf(stderr, "Could not open results files\n");
+        return 1;
+    }
+
+    int avail[N_KERNELS];
+    for (int k = 0; k < N_KERNELS; k++)
+        avail[k] = isa_require(kernels[k].isa, kernels[k].name, fp);
+
+    // buffers are first touched on the victim's CPU; size every window to
+    // about WINDOW_TICKS there
+    topo_pin_self(cpuA);
+    kstate_init(&victim_state, 0x2545F4914F6CDD1DULL);
+    kstate_init(&stressor_state, 0x9E3779B97F4A7C15ULL);
+    for (int k = 0; k < N_KERNELS; k++)
+        if (avail[k]) iters_for[k] = (long)(WINDOW_TICKS / ticks_alone(k, CAL_ITERS)) + 1;
+
+    static double base[N_KERNELS], slow[N_KERNELS][N_KERNELS];
+    fprintf(csv, "victim,stressor,baseline_ticks_per_iter,stressed_ticks_per_iter,slowdown\n");
+    for (int v = 0; v < N_KERNELS; v++) {
+        if (!avail[v]) continue;
+        double row_base[N_KERNELS];
+        int n_base = 0;
+        for (int s = 0; s < N_KERNELS; s++) {
+            if (!avail[s]) continue;
+            double b, t;
+            run_pair(v, s, cpuA, cpuB, &b, &t);
+            row_base[n_base++] = b;
+            slow[v][s] = t / b;
+            fprintf(csv, "%s,%s,%.3f,%.3f,%.3f\n",
+                    kernels[v].name, kernels[s].name, b, t, slow[v][s]);
+            printf("%-10s vs %-10s %.3f\n", kernels[v].name, kernels[s].name, slow[v][s]);
+        }
+        base[v] = median(row_base, n_base);
+    }
+
+    topo_describe(&topo, fp);
+    fprintf(fp, "=== Slowdown Matrix (victim on CPU %d, stressor on CPU %d, %s) ===\n",
+            cpuA, cpuB, placement);
+    fprintf(fp, "Rows: victim; columns: stressor; cell: victim time / time with sibling idle\n\n");
+    fprintf(fp, "| %-10s | %9s |", "Victim", "Base t/it");
+    for (int s = 0; s < N_KERNELS; s++)
+        if (avail[s]) fprintf(fp, " %9s |", kernels[s].name);
+    fprintf(fp, "\n|------------|-----------|");
+    for (int s = 0; s < N_KERNELS; s++)
+        if (avail[s]) fprintf(fp, "-----------|");
+    fprintf(fp, "\n");
+    for (int v = 0; v < N_KERNELS; v++) {
+        if (!avail[v]) continue;
+        fprintf(fp, "| %-10s | %9.2f |", kernels[v].name, base[v]);
+        for (int s = 0; s < N_KERNELS; s++)
+            if (avail[s]) fprintf(fp, " %9.2f |", slow[v][s]);
+        fprintf(fp, "\n");
+    }
+
+    // a pair shares well only if neither side slows the other down
+    fprintf(fp, "\n=== Core Sharing (worse of the two directions) ===\n");
+    fprintf(fp, "share <= %.2f < caution <= %.2f < avoid\n\n", SHARE_OK, SHARE_AVOID);
+    fprintf(fp, "| %-10s | %-10s | Worst | Verdict |\n", "A", "B");
+    fprintf(fp, "|------------|------------|-------|---------|\n");
+    for (int a = 0; a < N_KERNELS; a++)
+        for (int b = a; b < N_KERNELS; b++) {
+            if (!avail[a] || !avail[b]) continue;
+            double worst = slow[a][b] > slow[b][a] ? slow[a][b] : slow[b][a];
+            fprintf(fp, "| %-10s | %-10s | %5.2f | %-7s |\n", kernels[a].name, kernels[b].name, worst,
+                    worst <= SHARE_OK ? "share" : worst <= SHARE_AVOID ? "caution" : "avoid");
+        }
+
+    if (cpuA == cpuB)
+        fprintf(fp, "\nNote: victim and stressor on the same CPU time-slice; this is not an SMT measurement\n");
+    kstate_free(&victim_state);
+    kstate_free(&stressor_state);
+    fclose(fp);
+    fclose(csv);
+    preflight_save(&pf, "smt_matrix.csv");
+    printf("All results written to results_smt_matrix.txt and smt_matrix.csv\n");
+    return 0;
+}
@@ -0,0 +1 @@
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o prefetching prefetching.c ../common/isolate.c ../common/topology.c ../common/sysfs.c -lpthread
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <immintrin.h>
 #include <x86intrin.h>
+#include "isolate.h"
 
 #define N 10000000
 
@@ -35,6 +36,14 @@ int main() {
         return 1;
     }
 
+    // BENCH_ISOLATE=1: arr is faulted in here instead of inside streaming_access()
+    static isolate iso;
+    if (isolate_requested()) {
+        isolate_enter(&iso, -1);
+        isolate_prefault(arr, sizeof(arr));
+        isolate_report(&iso, fp);
+    }
+
     unsigned long long begin = rdtscp_serialized();
     streaming_access();
     unsigned long long finish = rdtscp_serialized();
@@ -46,6 +55,7 @@ int main() {
     fprintf(fp, "Streaming access time: %llu cycles\n", (finish - begin));
     fprintf(fp, "Randomized access time: %llu cycles\n", (finish_random - begin_random));
 
+    isolate_leave(&iso);
     fclose(fp);
     return 0;
 }
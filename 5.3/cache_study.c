@@ -1,9 +1,11 @@
-// cache_bench.c
+// cache_study.c
 // ===============================================================
-// Compile: gcc -O2 -fno-tree-vectorize -march=native -o cache_bench cache_bench.c
+// Compile: ./compile.sh   (builds cache_study)
 // Run:     sudo cpupower frequency-set -g performance
 //          sudo sh -c "echo 1 > /sys/devices/system/cpu/intel_pstate/no_turbo"
-//          taskset -c 0 ./cache_bench
+//          ./cache_study      (pins itself to topo_quiet_cpu())
+//          BENCH_STRICT=1 ./cache_study   refuses to run if preflight finds noise
+//          BENCH_ISOLATE=1 ./cache_study  mlockall + SCHED_FIFO + IRQs moved away
 //
 // Produces measurements for 5.3 questions:
 //   Q1: Cache hierarchy enumeration
@@ -24,6 +26,11 @@
 #include <sched.h>
 #include <unistd.h>
 #include <string.h>
+#include "topology.h"
+#include "preflight.h"
+#include "perturb.h"
+#include "isolate.h"
+#include "clock.h"
 
 // ---------- timing helpers ----------
 static inline uint64_t rdtsc_begin(void) {
@@ -62,15 +69,23 @@ static double median(double *vals, int n) {
     return med;
 }
 
-// ---------- pin to core 0 ----------
-static void pin_core0(void) {
-    cpu_set_t mask;
-    CPU_ZERO(&mask);
-    CPU_SET(0, &mask);
-    if (sched_setaffinity(0, sizeof(mask), &mask))
-        fprintf(stderr, "⚠️ Could not pin to core 0.\n");
+// ---------- pin to a quiet core ----------
+static void pin_quiet_cpu(FILE *fp) {
+    static topology topo;
+    if (topo_load(&topo)) {
+        fprintf(stderr, "⚠️ Could not read CPU topology; running unpinned.\n");
+        return;
+    }
+    int cpu = topo_quiet_cpu(&topo);
+    if (topo_pin_self(cpu))
+        fprintf(stderr, "⚠️ Could not pin to CPU %d.\n", cpu);
+    topo_describe(&topo, fp);
+    fprintf(fp, "Pinned to CPU %d\n\n", cpu);
 }
 
+// samples hit by a context switch, interrupt or SMI are rerun
+static perturb pt;
+
 // ---------- build pointer-chase buffer ----------
 static size_t *build_chase(size_t buf_bytes, size_t stride_bytes) {
     size_t n = buf_bytes / sizeof(size_t);
@@ -97,11 +112,13 @@ static double measure_seq(size_t buf_bytes, size_t stride, int hops, int trials)
     volatile uint8_t tmp = 0;
     double *s = malloc(trials * sizeof(double));
     for (int t = 0; t < trials; t++) {
-        uint64_t start = rdtsc_begin();
-        for (int h = 0; h < hops; h++)
-            tmp += buf[(h * stride) % buf_bytes];
-        uint64_t end = rdtsc_end();
-        s[t] = (double)(end - start) / hops;
+        PERTURB_SAMPLE(&pt, {
+            uint64_t start = rdtsc_begin();
+            for (int h = 0; h < hops; h++)
+                tmp += buf[(h * stride) % buf_bytes];
+            uint64_t end = rdtsc_end();
+            s[t] = (double)(end - start) / hops;
+        });
     }
     double med = median(s, trials);
     free(s); free(buf);
@@ -114,10 +131,12 @@ static double measure_chase(size_t buf_bytes, size_t stride, int hops, int trial
     volatile size_t idx = 0;
     double *s = malloc(trials * sizeof(double));
     for (int t = 0; t < trials; t++) {
-        uint64_t start = rdtsc_begin();
-        for (int h = 0; h < hops; h++) idx = buf[idx];
-        uint64_t end = rdtsc_end();
-        s[t] = (double)(end - start) / hops;
+        PERTURB_SAMPLE(&pt, {
+            uint64_t start = rdtsc_begin();
+            for (int h = 0; h < hops; h++) idx = buf[idx];
+            uint64_t end = rdtsc_end();
+            s[t] = (double)(end - start) / hops;
+        });
     }
     double med = median(s, trials);
     free(s); free(buf);
@@ -151,9 +170,26 @@ static void enumerate_cache_levels(FILE *fp) {
 // ---------- main ----------
 int main(void) {
     srand(time(NULL));
-    pin_core0();
     FILE *fp = fopen("results_cache.txt", "w");
     if (!fp) fp = stdout;
+    pin_quiet_cpu(fp);
+    static isolate iso;
+    if (isolate_requested()) {
+        isolate_enter(&iso, -1);
+        isolate_report(&iso, fp);
+    }
+    static preflight pf;
+    if (preflight_gate(&pf, -1, fp)) {
+        isolate_leave(&iso);
+        if (fp != stdout) fclose(fp);
+        return 1;
+    }
+    fprintf(fp, "\n");
+    clk_calibrate();
+    clk_open();
+    fprintf(fp, "Core clock source: %s (TSC %.3f GHz)\n\n", clk_source_name(clk_src()), clk_tsc_ghz());
+    if (perturb_open(&pt, -1))
+        fprintf(stderr, "⚠️ No context-switch or interrupt counters; samples are not screened.\n");
 
     enumerate_cache_levels(fp);
 
@@ -166,26 +202,42 @@ int main(void) {
     int trials = 50, hops = 20000;
 
     fprintf(fp, "=== Q2–Q5: Cache Access Characterization ===\n");
-    fprintf(fp, "Table Columns: size(bytes), stride(bytes), seq_cycles/access, prefetch_ratio, chase_cycles/access, inflection\n\n");
-    fprintf(fp, "| %-12s | %-10s | %-20s | %-18s | %-20s | %-10s |\n", 
-            "Size (bytes)", "Stride", "Seq Cycles/access", "Prefetch Ratio", "Chase Cycles/access", "Inflect?");
-    fprintf(fp, "|--------------|------------|----------------------|--------------------|----------------------|------------|\n");
+    fprintf(fp, "Table Columns: size(bytes), stride(bytes), seq per access, prefetch_ratio, chase per access, inflection, core GHz\n");
+    fprintf(fp, "Per-access figures are TSC ticks / core cycles / ns; '*' marks a core clock change mid-row\n\n");
+    fprintf(fp, "| %-12s | %-10s | %-22s | %-14s | %-22s | %-8s | %-9s |\n",
+            "Size (bytes)", "Stride", "Seq tk/cyc/ns", "Prefetch Ratio", "Chase tk/cyc/ns", "Inflect?", "Core GHz");
+    fprintf(fp, "|--------------|------------|------------------------|----------------|------------------------|----------|-----------|\n");
 
     static double prev = 0.0;
     for (int si = 0; si < n_sizes; si++) {
         for (int st = 0; st < n_strides; st++) {
+            clk_span cs, cc;
+            clk_begin(&cs);
             double seq = measure_seq(sizes[si], strides[st], hops, trials);
+            clk_end(&cs);
+            clk_begin(&cc);
             double chase = measure_chase(sizes[si], strides[st], hops, trials);
-            double ratio = (chase > 0.0) ? seq / chase : 0.0;
-            int inflect = detect_inflection(prev, chase);
+            clk_end(&cc);
+            double seq_cyc = clk_cycles(&cs, seq), chase_cyc = clk_cycles(&cc, chase);
+            double ratio = (chase_cyc > 0.0) ? seq_cyc / chase_cyc : 0.0;
+            int inflect = detect_inflection(prev, chase_cyc);
             if (st == 0) prev = 0.0;
-            fprintf(fp, "| %-12zu | %-10d | %-20.3f | %-18.3f | %-20.3f | %-10s |\n",
-                    sizes[si], strides[st], seq, ratio, chase, inflect ? "YES" : "NO");
-            prev = chase;
+            char seq_s[32], chase_s[32], ghz_s[16];
+            snprintf(seq_s, sizeof(seq_s), "%.2f/%.2f/%.2f", seq, seq_cyc, clk_ns(seq));
+            snprintf(chase_s, sizeof(chase_s), "%.2f/%.2f/%.2f", chase, chase_cyc, clk_ns(chase));
+            snprintf(ghz_s, sizeof(ghz_s), "%.3f%s", cc.ghz, cs.freq_changed || cc.freq_changed ? "*" : "");
+            fprintf(fp, "| %-12zu | %-10d | %-22s | %-14.3f | %-22s | %-8s | %-9s |\n",
+                    sizes[si], strides[st], seq_s, ratio, chase_s, inflect ? "YES" : "NO", ghz_s);
+            prev = chase_cyc;
         }
-        fprintf(fp, "---------------------------------------------------------------------------------------------\n");
+        fprintf(fp, "-----------------------------------------------------------------------------------------------------------------------\n");
     }
 
+    perturb_summary(&pt, fp, "\nPerturbation screening");
+    perturb_close(&pt);
+    clk_close();
+    isolate_leave(&iso);
+
     // Also append clean CSV at bottom for plotting (optional)
     fprintf(fp, "\n=== CSV (for Python/Excel plotting) ===\n");
     fprintf(fp, "size, stride, seq_cycles, prefetch_ratio, chase_cycles, inflection\n");
@@ -196,7 +248,7 @@ int main(void) {
     printf("✅ Results written to results_cache.txt\n");
     printf("Interpretation:\n");
     printf(" Q2: Cache-line size → stride at which latency increases (~64B)\n");
-    printf(" Q3: L1/L2 miss latencies from pointer-chase timing\n");
+    printf(" Q3: L1/L2 miss latencies from pointer-chase timing (core cycles, not TSC ticks)\n");
     printf(" Q4: 'YES' inflection rows ≈ cache capacity boundary → LLC inclusivity\n");
     printf(" Q5: Use CSV data to plot latency vs working set size/stride\n");
     return 0;
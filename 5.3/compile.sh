@@ -0,0 +1,2 @@
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o cache_study cache_study.c ../common/topology.c ../common/sysfs.c ../common/preflight.c ../common/perturb.c ../common/isolate.c ../common/clock.c ../common/pmu.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o misalign_bench misalign_bench.c ../common/timing.c ../common/isa.c ../common/preflight.c ../common/sysfs.c -lpthread
@@ -0,0 +1,199 @@
+// misalign_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds misalign_bench)
+// Run:     taskset -c 0 ./misalign_bench
+//
+// Unaligned access cost. build_chase/build_seqbuf in cache_study.c only
+// ever touch 64-byte-aligned data; this sweeps every byte offset 0..63
+// within a line for 2, 4, 8, 16, 32 and 64-byte accesses:
+//   load_tp    8 independent loads per iteration, one per 4 KB page
+//   store_tp   8 independent stores per iteration, one per 4 KB page
+//   load_lat   load -> (value & 0) -> next load address, one chain
+// at two placements of the line inside its page:
+//   mid_page   line at page offset 2048: offset + width > 64 is a
+//              cache-line split
+//   page_end   last line of the page: the same offsets are also 4 KB
+//              page splits
+// All numbers are TSC ticks per access. "extra" columns are the cost
+// over offset 0 at the same width and placement.
+// Store -> load forwarding across splits is covered by 5.8/stlf_bench.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "timing.h"
+#include "isa.h"
+#include "preflight.h"
+
+#define PAGE     4096
+#define SLOTS    8        // pages per throughput iteration; all hit one L1 set, keep < ways
+#define ITERS    20000
+#define TRIALS   5
+
+typedef void (*access_fn)(uint8_t *base, long iters);
+
+// ------------------ Access Templates ------------------
+// D is the displacement expression from base
+#define LD_2(D)  "movzwl " D "(%[b]), %%eax\n\t"
+#define LD_4(D)  "mov " D "(%[b]), %%eax\n\t"
+#define LD_8(D)  "mov " D "(%[b]), %%rax\n\t"
+#define LD_16(D) "vmovdqu " D "(%[b]), %%xmm1\n\t"
+#define LD_32(D) "vmovdqu " D "(%[b]), %%ymm1\n\t"
+#define LD_64(D) "vmovdqu64 " D "(%[b]), %%zmm1\n\t"
+
+#define ST_2(D)  "mov %%ax, " D "(%[b])\n\t"
+#define ST_4(D)  "mov %%eax, " D "(%[b])\n\t"
+#define ST_8(D)  "mov %%rax, " D "(%[b])\n\t"
+#define ST_16(D) "vmovdqu %%xmm0, " D "(%[b])\n\t"
+#define ST_32(D) "vmovdqu %%ymm0, " D "(%[b])\n\t"
+#define ST_64(D) "vmovdqu64 %%zmm0, " D "(%[b])\n\t"
+
+// loaded value back in rax for the latency chain
+#define TO_RAX_2  ""
+#define TO_RAX_4  ""
+#define TO_RAX_8  ""
+#define TO_RAX_16 "vmovq %%xmm1, %%rax\n\t"
+#define TO_RAX_32 "vmovq %%xmm1, %%rax\n\t"
+#define TO_RAX_64 "vmovq %%xmm1, %%rax\n\t"
+
+#define SLOT_LIST "0,1,2,3,4,5,6,7"
+
+#define DEFINE_ACCESS_KERNELS(w)                                              \
+static void load_tp_##w(uint8_t *base, long iters) {                          \
+    __asm__ volatile("1:\n\t"                                                 \
+                     ".irp s," SLOT_LIST "\n\t"                               \
+                     LD_##w("\\s*4096")                                       \
+                     ".endr\n\t"                                              \
+                     "dec %[n]\n\t"                                           \
+                     "jnz 1b\n\t"                                             \
+                     "vzeroupper\n\t"                                         \
+                     : [n] "+r"(iters) : [b] "r"(base)                        \
+                     : "rax", "xmm0", "xmm1", "cc", "memory");                \
+}                                                                             \
+static void store_tp_##w(uint8_t *base, long iters) {                         \
+    __asm__ volatile("xor %%eax, %%eax\n\t"                                   \
+                     "vpxor %%xmm0, %%xmm0, %%xmm0\n\t"                       \
+                     "1:\n\t"                                                 \
+                     ".irp s," SLOT_LIST "\n\t"                               \
+                     ST_##w("\\s*4096")                                       \
+                     ".endr\n\t"                                              \
+                     "dec %[n]\n\t"                                           \
+                     "jnz 1b\n\t"                                             \
+                     "vzeroupper\n\t"                                         \
+                     : [n] "+r"(iters) : [b] "r"(base)                        \
+                     : "rax", "xmm0", "xmm1", "cc", "memory");                \
+}                                                                             \
+static void load_lat_##w(uint8_t *base, long iters) {                         \
+    __asm__ volatile("1:\n\t"                                                 \
+                     LD_##w("0")                                              \
+                     TO_RAX_##w                                               \
+                     "and $0, %%rax\n\t"                                      \
+                     "add %%rax, %[b]\n\t"                                    \
+                     "dec %[n]\n\t"                                           \
+                     "jnz 1b\n\t"                                             \
+                     "vzeroupper\n\t"                                         \
+                     : [b] "+r"(base), [n] "+r"(iters) :                      \
+                     : "rax", "xmm0", "xmm1", "cc", "memory");                \
+}
+
+// every kernel ends in vzeroupper, so even the GPR widths need AVX;
+// the isa column decides at run time which ones this host can take
+#define WIDTHS(X) X(2, ISA_AVX) X(4, ISA_AVX) X(8, ISA_AVX) X(16, ISA_AVX) \
+                  X(32, ISA_AVX) X(64, ISA_AVX512)
+
+#define DEFINE_WIDTH(w, isa) DEFINE_ACCESS_KERNELS(w)
+WIDTHS(DEFINE_WIDTH)
+
+#define WIDTH_ENTRY(w, isa) { w, isa, load_tp_##w, store_tp_##w, load_lat_##w },
+static const struct {
+    int width;
+    isa_feature isa;
+    access_fn load_tp, store_tp, load_lat;
+} kernels[] = { WIDTHS(WIDTH_ENTRY) };
+#define N_KERNELS (int)(sizeof(kernels) / sizeof(kernels[0]))
+
+// ------------------ Measurement ------------------
+static double ticks_per_access(access_fn fn, uint8_t *base, int per_iter) {
+    double s[TRIALS];
+    fn(base, ITERS / 10); // warm up
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t start = rdtsc_begin();
+        fn(base, ITERS);
+        uint64_t end = rdtsc_end();
+        s[t] = (double)(end - start) / ((double)ITERS * per_iter);
+    }
+    return median(s, TRIALS);
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    static const struct { const char *name; long line; } placements[] = {
+        { "mid_page", 2048 }, { "page_end", PAGE - 64 },
+    };
+    uint8_t *buf = aligned_alloc(PAGE, (SLOTS + 2) * PAGE);
+    memset(buf, 0, (SLOTS + 2) * PAGE);
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("misalign_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening misalign_results.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_misalign.txt", "w");
+    if (!log_fp) log_fp = stdout;
+    fprintf(fp, "placement,width,offset,line_split,page_split,load_tp,store_tp,load_lat,"
+                "load_tp_extra,store_tp_extra,load_lat_extra\n");
+
+    fprintf(log_fp, "=== Misaligned Access Cost (TSC ticks per access, worst case per class) ===\n");
+    fprintf(log_fp, "| %-5s | %-11s | %-7s | %-8s | %-8s |\n",
+            "Width", "Class", "Load TP", "Store TP", "Load Lat");
+    fprintf(log_fp, "|-------|-------------|---------|----------|----------|\n");
+
+    for (int k = 0; k < N_KERNELS; k++) {
+        int w = kernels[k].width;
+        char name[32];
+        snprintf(name, sizeof(name), "%d-byte accesses", w);
+        if (!isa_require(kernels[k].isa, name, log_fp)) continue;
+        // worst case per class: aligned, unaligned in-line, line split, page split
+        double worst[4][3] = { { 0 } };
+        for (int p = 0; p < 2; p++) {
+            double ref[3] = { 0 };
+            for (int off = 0; off < 64; off++) {
+                uint8_t *base = buf + placements[p].line + off;
+                double ltp = ticks_per_access(kernels[k].load_tp, base, SLOTS);
+                double stp = ticks_per_access(kernels[k].store_tp, base, SLOTS);
+                double lat = ticks_per_access(kernels[k].load_lat, base, 1);
+                if (off == 0) { ref[0] = ltp; ref[1] = stp; ref[2] = lat; }
+
+                int line_split = off + w > 64;
+                int page_split = line_split && placements[p].line == PAGE - 64;
+                fprintf(fp, "%s,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", placements[p].name,
+                        w, off, line_split, page_split, ltp, stp, lat,
+                        ltp - ref[0], stp - ref[1], lat - ref[2]);
+
+                int cls = page_split ? 3 : line_split ? 2 : off % w ? 1 : 0;
+                double v[3] = { ltp, stp, lat };
+                for (int m = 0; m < 3; m++)
+                    if (v[m] > worst[cls][m]) worst[cls][m] = v[m];
+            }
+        }
+        static const char *cls_name[] = { "aligned", "unaligned", "line split", "page split" };
+        for (int c = 0; c < 4; c++) {
+            if (worst[c][0] == 0.0) continue;   // class not reached at this width
+            fprintf(log_fp, "| %-5d | %-11s | %-7.2f | %-8.2f | %-8.2f |\n", w, cls_name[c],
+                    worst[c][0], worst[c][1], worst[c][2]);
+        }
+    }
+
+    fclose(fp);
+    preflight_save(&pf, "misalign_results.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    free(buf);
+    printf("All results written to results_misalign.txt and misalign_results.csv\n");
+    return 0;
+}
@@ -0,0 +1,416 @@
+// bp_history_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds bp_history)
+// Run:     taskset -c 0 ./bp_history
+//
+// Conditional-branch (direction) predictor characterization:
+//   1: Periodic patterns of length 1..4096, both loop-exit style
+//      (T..TN) and random bits repeated with period L
+//   2: Global history length: a random branch, D always-taken
+//      branches, then a branch that copies the first outcome
+//   3: Effective PHT capacity: W distinct static branches, each
+//      with its own period-P pattern, all sharing global history
+//
+// Mispredicts come from the PMU (branch-misses) when perf is usable;
+// otherwise they are estimated from cycles with a penalty calibrated
+// against a non-repeating random branch. A timing estimate carries a
+// resolution taken from the run-to-run spread of a perfectly predicted
+// run; a verdict that the resolution cannot separate from its limit is
+// printed as unknown. Every pattern comes from a seeded xorshift
+// generator, so runs are repeatable across hosts.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "preflight.h"
+
+#define ROWS          262144  // dynamic iterations per measurement
+#define TRIALS        5
+#define MAX_PERIOD    4096
+#define PERFECT_RATE  0.01    // mispredicts/branch still counted as "learned"
+#define NOISE_RUNS    7       // repeated baselines that set the timing resolution
+
+typedef uint64_t (*bp_kernel_fn)(const uint8_t *bits, size_t rows);
+
+typedef struct {
+    uint64_t cycles;       // median TSC cycles over TRIALS
+    uint64_t pmu_misses;   // median branch-misses (0 without PMU)
+} bp_sample;
+
+// Perfectly predicted runs with every outcome 0 (jz taken) or 1 (falls
+// through); the timing fallback interpolates between them by the pattern's
+// share of ones, since taken and not-taken paths do not cost the same.
+typedef struct {
+    bp_sample zeros, ones;
+} bp_baseline;
+
+static pmu_counter misses_ctr = { -1 };
+static double miss_penalty = 0.0;   // cycles per mispredict (timing fallback)
+static double noise_frac = 0.0;     // relative spread of a perfectly predicted run
+static FILE *csv_fp;
+
+// ------------------ Deterministic Pattern Generator ------------------
+static uint64_t pattern_state;
+
+static void pattern_seed(uint64_t a, uint64_t b) {
+    pattern_state = (a * 0x9E3779B97F4A7C15ull) ^ (b * 0xD1B54A32D192ED03ull) ^ 0x2545F4914F6CDD1Dull;
+    if (!pattern_state) pattern_state = 1;
+}
+
+static int pattern_bit(void) {
+    pattern_state ^= pattern_state >> 12;
+    pattern_state ^= pattern_state << 25;
+    pattern_state ^= pattern_state >> 27;
+    return (int)((pattern_state * 0x2545F4914F6CDD1Dull) >> 63);
+}
+
+// ------------------ Kernels ------------------
+// Each branch under test is an inline-asm jz so the compiler cannot
+// turn it into a cmov; every .rept copy is its own static branch.
+static uint64_t single_kernel(const uint8_t *bits, size_t rows) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < rows; i++) {
+        uint64_t b = bits[i];
+        __asm__ volatile("test %1, %1\n\t"
+                         "jz 1f\n\t"
+                         "add $1, %0\n"
+                         "1:\n\t"
+                         : "+r"(acc) : "r"(b) : "cc");
+    }
+    return acc;
+}
+
+#define DEFINE_STATIC_KERNEL(w)                                          \
+static uint64_t static_kernel_##w(const uint8_t *bits, size_t rows) {    \
+    uint64_t acc = 0;                                                    \
+    const uint8_t *p = bits;                                             \
+    for (size_t i = 0; i < rows; i++) {                                  \
+        __asm__ volatile(".rept " #w "\n\t"                              \
+                         "movzbl (%1), %%eax\n\t"                        \
+                         "add $1, %1\n\t"                                \
+                         "test %%eax, %%eax\n\t"                         \
+                         "jz 1f\n\t"                                     \
+                         "add $1, %0\n"                                  \
+                         "1:\n\t"                                        \
+                         ".endr\n\t"                                     \
+                         : "+r"(acc), "+r"(p) : : "eax", "cc", "memory");\
+    }                                                                    \
+    return acc;                                                          \
+}
+
+#define DEFINE_HISTORY_KERNEL(d)                                         \
+static uint64_t history_kernel_##d(const uint8_t *bits, size_t rows) {   \
+    uint64_t acc = 0, one = 1;                                           \
+    for (size_t i = 0; i < rows; i++) {                                  \
+        uint64_t b = bits[i];                                            \
+        __asm__ volatile("test %1, %1\n\t"                               \
+                         "jz 1f\n\t"                                     \
+                         "add $1, %0\n"                                  \
+                         "1:\n\t"                                        \
+                         ".rept " #d "\n\t"                              \
+                         "test %2, %2\n\t"                               \
+                         "jnz 2f\n\t"                                    \
+                         "nop\n"                                         \
+                         "2:\n\t"                                        \
+                         ".endr\n\t"                                     \
+                         "test %1, %1\n\t"                               \
+                         "jz 3f\n\t"                                     \
+                         "add $2, %0\n"                                  \
+                         "3:\n\t"                                        \
+                         : "+r"(acc) : "r"(b), "r"(one) : "cc");         \
+    }                                                                    \
+    return acc;                                                          \
+}
+
+#define STATIC_WIDTHS(X) X(1) X(2) X(4) X(8) X(16) X(32) X(64) X(128) X(256) X(512) X(1024)
+#define HISTORY_DEPTHS(X) X(0) X(4) X(8) X(16) X(24) X(32) X(48) X(64) X(80) X(96) X(112) \
+                          X(128) X(160) X(192) X(224) X(256) X(320) X(384) X(512) X(768) X(1024)
+
+STATIC_WIDTHS(DEFINE_STATIC_KERNEL)
+HISTORY_DEPTHS(DEFINE_HISTORY_KERNEL)
+
+#define KERNEL_ENTRY_STATIC(w)  { w, static_kernel_##w },
+#define KERNEL_ENTRY_HISTORY(d) { d, history_kernel_##d },
+
+static const struct { int param; bp_kernel_fn fn; } static_kernels[] = {
+    STATIC_WIDTHS(KERNEL_ENTRY_STATIC)
+};
+static const struct { int param; bp_kernel_fn fn; } history_kernels[] = {
+    HISTORY_DEPTHS(KERNEL_ENTRY_HISTORY)
+};
+
+// ------------------ Measurement ------------------
+static volatile uint64_t sink;
+
+static bp_sample bp_measure(bp_kernel_fn fn, const uint8_t *bits, size_t rows) {
+    uint64_t cyc[TRIALS], miss[TRIALS];
+
+    sink += fn(bits, rows); // training pass
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t m0 = pmu_read(&misses_ctr);
+        uint64_t start = rdtsc_begin();
+        sink += fn(bits, rows);
+        uint64_t end = rdtsc_end();
+        miss[t] = pmu_read(&misses_ctr) - m0;
+        cyc[t] = end - start;
+    }
+    bp_sample s = { median_u64(cyc, TRIALS), median_u64(miss, TRIALS) };
+    return s;
+}
+
+static bp_baseline bp_measure_baseline(bp_kernel_fn fn, size_t rows, size_t width) {
+    bp_baseline b;
+    uint8_t *flat = malloc(rows * width);
+    memset(flat, 0, rows * width);
+    b.zeros = bp_measure(fn, flat, rows);
+    memset(flat, 1, rows * width);
+    b.ones = bp_measure(fn, flat, rows);
+    free(flat);
+    return b;
+}
+
+static double ones_fraction(const uint8_t *bits, size_t n) {
+    size_t ones = 0;
+    for (size_t i = 0; i < n; i++) ones += bits[i];
+    return n ? (double)ones / n : 0.0;
+}
+
+// Mispredicts in s; the baseline is only consulted when there is no PMU.
+static double bp_misses(bp_sample s, const bp_baseline *base, double ones) {
+    if (pmu_ok(&misses_ctr)) return (double)s.pmu_misses;
+    double expect = base->zeros.cycles + ones * ((double)base->ones.cycles - base->zeros.cycles);
+    if (miss_penalty <= 0.0 || s.cycles <= expect) return 0.0;
+    return (s.cycles - expect) / miss_penalty;
+}
+
+// Mispredicts the timing estimate cannot tell from noise (0 with PMU).
+static double bp_resolution(const bp_baseline *base, double ones) {
+    if (pmu_ok(&misses_ctr)) return 0.0;
+    if (miss_penalty <= 0.0) return 1e300;
+    double expect = base->zeros.cycles + ones * ((double)base->ones.cycles - base->zeros.cycles);
+    return noise_frac * expect / miss_penalty;
+}
+
+typedef enum { BP_LEARNED, BP_MISSED, BP_UNKNOWN } bp_verdict;
+
+// misses per branch against `limit`, decided only when the resolution
+// puts the whole interval on one side of it
+static bp_verdict bp_judge(double misses, double resolution, uint64_t branches, double limit) {
+    double rate = misses / branches, res = resolution / branches;
+    if (rate > limit + res) return BP_MISSED;
+    if (rate + res <= limit) return BP_LEARNED;
+    return BP_UNKNOWN;
+}
+
+static void log_row(const char *test, int p1, int p2, uint64_t branches,
+                    double misses, double resolution, uint64_t cycles) {
+    fprintf(csv_fp, "%s,%d,%d,%llu,%.1f,%.5f,%.5f,%.3f,%s\n", test, p1, p2,
+            (unsigned long long)branches, misses, misses / branches, resolution / branches,
+            (double)cycles / branches, pmu_ok(&misses_ctr) ? "pmu" : "timing");
+}
+
+// ------------------ Penalty Calibration ------------------
+static void calibrate_penalty(uint8_t *bits) {
+    bp_baseline base = bp_measure_baseline(single_kernel, ROWS, 1);
+
+    pattern_seed(0xCA1, 0);
+    for (size_t i = 0; i < ROWS; i++) bits[i] = (uint8_t)pattern_bit();
+    bp_sample rnd = bp_measure(single_kernel, bits, ROWS);
+
+    double expect = base.zeros.cycles + ones_fraction(bits, ROWS) *
+                    ((double)base.ones.cycles - base.zeros.cycles);
+    if (rnd.cycles > expect)
+        miss_penalty = (rnd.cycles - expect) / (0.5 * ROWS);
+    printf("Mispredict penalty (timing calibration): %.1f cycles\n", miss_penalty);
+    if (pmu_ok(&misses_ctr)) {
+        printf("Random branch miss rate (PMU): %.3f\n", (double)rnd.pmu_misses / ROWS);
+        return;
+    }
+
+    // the full range of NOISE_RUNS medians of the same perfect run
+    uint64_t runs[NOISE_RUNS];
+    memset(bits, 0, ROWS);
+    for (int r = 0; r < NOISE_RUNS; r++) runs[r] = bp_measure(single_kernel, bits, ROWS).cycles;
+    uint64_t lo = runs[0], hi = runs[0];
+    for (int r = 1; r < NOISE_RUNS; r++) {
+        if (runs[r] < lo) lo = runs[r];
+        if (runs[r] > hi) hi = runs[r];
+    }
+    noise_frac = (double)(hi - lo) / median_u64(runs, NOISE_RUNS);
+    double res = miss_penalty > 0.0 ? noise_frac * base.zeros.cycles / miss_penalty / ROWS : 1.0;
+    printf("Timing resolution: %.4f mispredicts/branch (limit for \"learned\": %.2f)\n",
+           res, PERFECT_RATE);
+    if (res > PERFECT_RATE)
+        printf("  coarser than the limit: a pattern can be reported missed, never learned\n");
+}
+
+// ------------------ Test 1: Periodic Patterns ------------------
+static void fill_periodic(uint8_t *bits, size_t rows, int family, int len) {
+    uint8_t pat[MAX_PERIOD];
+    pattern_seed(family, len);
+    for (int i = 0; i < len; i++)
+        pat[i] = family == 0 ? (i != len - 1) : (uint8_t)pattern_bit();
+    for (size_t i = 0; i < rows; i++) bits[i] = pat[i % len];
+}
+
+static void periodic_test(uint8_t *bits) {
+    static const char *family_name[] = { "loop", "random" };
+    static const int lengths[] = { 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 32,
+                                   40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256,
+                                   320, 384, 448, 512, 640, 768, 1024, 1536, 2048, 3072, 4096 };
+    int n_lengths = sizeof(lengths) / sizeof(lengths[0]);
+
+    printf("=== Test 1: Periodic Patterns ===\n");
+    bp_baseline base = bp_measure_baseline(single_kernel, ROWS, 1);
+
+    for (int family = 0; family < 2; family++) {
+        int longest = 0;
+        bp_verdict stop = BP_LEARNED;
+        for (int li = 0; li < n_lengths; li++) {
+            int len = lengths[li];
+            fill_periodic(bits, ROWS, family, len);
+            bp_sample s = bp_measure(single_kernel, bits, ROWS);
+            double ones = ones_fraction(bits, ROWS);
+            double misses = bp_misses(s, &base, ones), res = bp_resolution(&base, ones);
+            log_row(family_name[family], len, 1, ROWS, misses, res, s.cycles);
+            if (stop != BP_LEARNED) continue;
+            stop = bp_judge(misses, res, ROWS, PERFECT_RATE);
+            if (stop == BP_LEARNED) longest = len;
+        }
+
+        if (stop == BP_UNKNOWN)
+            printf("Longest %-6s pattern learned perfectly: unknown (>= %d; timing cannot resolve the limit)\n",
+                   family_name[family], longest);
+        else
+            printf("Longest %-6s pattern learned perfectly: %d\n", family_name[family], longest);
+    }
+}
+
+// ------------------ Test 2: Global History Length ------------------
+static void history_test(uint8_t *bits) {
+    int n = sizeof(history_kernels) / sizeof(history_kernels[0]);
+    int history = 0;
+    bp_verdict stop = BP_LEARNED;
+    double first_only = 0.0, first_res = 0.0;
+
+    printf("=== Test 2: Global History Length ===\n");
+    pattern_seed(0x415, 0);
+    for (size_t i = 0; i < ROWS; i++) bits[i] = (uint8_t)pattern_bit();
+
+    double ones = ones_fraction(bits, ROWS);
+
+    for (int k = 0; k < n; k++) {
+        int depth = history_kernels[k].param;
+        bp_baseline base = bp_measure_baseline(history_kernels[k].fn, ROWS, 1);
+        bp_sample s = bp_measure(history_kernels[k].fn, bits, ROWS);
+        double per_row = bp_misses(s, &base, ones) / ROWS;
+        double res = bp_resolution(&base, ones);
+        // depth 0 is the reference: only the first branch misses (0.5/row);
+        // the copy adds another 0.5/row once its source falls out of history
+        log_row("history", depth, depth + 2, (uint64_t)ROWS * 2, per_row * ROWS, res, s.cycles);
+        if (k == 0) {
+            first_only = per_row;
+            first_res = res;
+        }
+        if (stop != BP_LEARNED) continue;
+        stop = bp_judge((per_row - first_only) * ROWS, res + first_res, ROWS, 0.25);
+        if (stop == BP_LEARNED) history = depth;
+    }
+
+    if (stop == BP_UNKNOWN)
+        printf("Copied outcome still predicted across: unknown (>= %d taken branches; timing cannot resolve)\n",
+               history);
+    else
+        printf("Copied outcome still predicted across %d taken branches\n", history);
+}
+
+// ------------------ Test 3: Effective PHT Capacity ------------------
+static void capacity_test(void) {
+    static const int periods[] = { 2, 4, 8, 16, 32 };
+    int nw = sizeof(static_kernels) / sizeof(static_kernels[0]);
+    int np = sizeof(periods) / sizeof(periods[0]);
+    int best_w = 0, best_p = 0, any_unknown = 0;
+
+    printf("=== Test 3: Static Branches Sharing History ===\n");
+    for (int pi = 0; pi < np; pi++) {
+        int period = periods[pi], fit = 0;
+        bp_verdict stop = BP_LEARNED;
+        for (int k = 0; k < nw; k++) {
+            int width = static_kernels[k].param;
+            size_t rows = (size_t)(1 << 20) / width;
+            if (rows < (size_t)period * 64) rows = (size_t)period * 64;
+            rows -= rows % period;
+
+            bp_baseline base = bp_measure_baseline(static_kernels[k].fn, rows, width);
+            uint8_t *bits = malloc(rows * width);
+
+            // per-branch pattern, seeded by (period, branch index)
+            for (int b = 0; b < width; b++) {
+                pattern_seed(period, b + 1);
+                uint8_t pat[32];
+                for (int i = 0; i < period; i++) pat[i] = (uint8_t)pattern_bit();
+                for (size_t r = 0; r < rows; r++) bits[r * width + b] = pat[r % period];
+            }
+            bp_sample s = bp_measure(static_kernels[k].fn, bits, rows);
+            uint64_t branches = (uint64_t)rows * width;
+            double ones = ones_fraction(bits, branches);
+            double misses = bp_misses(s, &base, ones), res = bp_resolution(&base, ones);
+            log_row("static", width, period, branches, misses, res, s.cycles);
+            if (stop == BP_LEARNED) {
+                stop = bp_judge(misses, res, branches, 2 * PERFECT_RATE);
+                if (stop == BP_LEARNED) fit = k + 1;
+            }
+            free(bits);
+        }
+        int w = fit > 0 ? static_kernels[fit - 1].param : 0;
+        if (w * period > best_w * best_p) { best_w = w; best_p = period; }
+        if (stop == BP_UNKNOWN) {
+            any_unknown = 1;
+            printf("Period %2d: >= %4d static branches predicted, unknown beyond (timing cannot resolve the limit)\n",
+                   period, w);
+        } else if (fit > 0) {
+            printf("Period %2d: %4d static branches predicted (%d patterns)\n", period, w, w * period);
+        } else {
+            printf("Period %2d: not learned even for one branch\n", period);
+        }
+    }
+    if (any_unknown)
+        printf("Effective PHT capacity: unknown (>= %d (branch, history) patterns)\n", best_w * best_p);
+    else
+        printf("Effective PHT capacity ~ %d (branch, history) patterns\n", best_w * best_p);
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    csv_fp = fopen("bp_history.csv", "w");
+    if (!csv_fp) {
+        fprintf(stderr, "Error opening bp_history.csv\n");
+        return 1;
+    }
+    fprintf(csv_fp, "test,param,param2,branches,mispredicts,mispredicts_per_branch,resolution_per_branch,cycles_per_branch,source\n");
+
+    if (pmu_open(&misses_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES))
+        printf("branch-misses counter unavailable, estimating from cycles\n");
+
+    uint8_t *bits = malloc(ROWS);
+    calibrate_penalty(bits);
+    periodic_test(bits);
+    history_test(bits);
+    capacity_test();
+    free(bits);
+
+    pmu_close(&misses_ctr);
+    fclose(csv_fp);
+    preflight_save(&pf, "bp_history.csv");
+    printf("All results written to bp_history.csv\n");
+    return 0;
+}
@@ -1 +1,5 @@
-gcc -O2 -fno-tree-vectorize -march=native -std=c11 -Wall -o btb_test btb_bench.c
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -o btb_test btb_bench.c
+
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o bp_history bp_history_bench.c ../common/timing.c ../common/pmu.c ../common/preflight.c ../common/sysfs.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o indirect_test indirect_bench.c ../common/timing.c ../common/pmu.c ../common/jit.c ../common/preflight.c ../common/sysfs.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o rsb_test rsb_bench.c ../common/timing.c ../common/pmu.c ../common/jit.c ../common/preflight.c ../common/sysfs.c -lpthread
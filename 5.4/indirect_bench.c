@@ -0,0 +1,232 @@
+// indirect_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds indirect_test)
+// Run:     taskset -c 0 ./indirect_test [target_stride_bytes]
+//
+// Indirect-branch predictor capacity. One `jmp rax` site is emitted at
+// runtime, followed by K targets spaced target_stride bytes apart
+// (default 64). A table of target addresses drives the site: the same
+// sequence of length L is replayed until the run ends. Sweeps:
+//   1: cyclic sequences (t0 t1 .. tK-1) for K = 1..4096
+//   2: random sequences over K targets, for every L up to 4096
+// A (K, L) point is "learned" when the site mispredicts < 2% of jumps.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "jit.h"
+#include "preflight.h"
+
+#define JUMPS         (1 << 19)   // indirect jumps per measurement
+#define TRIALS        5
+#define MAX_TARGETS   4096
+#define LEARNED_RATE  0.02
+
+// void site(const void **seq, uint64_t jumps, const void **seq_end)
+typedef void (*indirect_site_fn)(const void **seq, uint64_t jumps, const void **seq_end);
+
+typedef struct {
+    jit_buf code;
+    indirect_site_fn site;
+    const void *targets[MAX_TARGETS];
+    int n_targets;
+} indirect_layout;
+
+static pmu_counter misses_ctr = { -1 };
+static double miss_penalty = 0.0;
+static uint64_t base_cycles = 0;    // K = 1, L = 1: always predicted
+static FILE *csv_fp;
+
+// ------------------ Deterministic Sequence Generator ------------------
+static uint64_t seq_state;
+
+static void seq_seed(uint64_t a, uint64_t b) {
+    seq_state = (a * 0x9E3779B97F4A7C15ull) ^ (b * 0xD1B54A32D192ED03ull) ^ 0x2545F4914F6CDD1Dull;
+}
+
+static uint32_t seq_next(uint32_t bound) {
+    seq_state ^= seq_state >> 12;
+    seq_state ^= seq_state << 25;
+    seq_state ^= seq_state >> 27;
+    return (uint32_t)(((seq_state * 0x2545F4914F6CDD1Dull) >> 32) % bound);
+}
+
+// ------------------ Code Generation ------------------
+// site:    mov rcx, rdi
+// loop:    mov rax, [rdi] ; add rdi, 8 ; jmp rax      <- site under test
+// cont:    cmp rdi, rdx ; jne 1f ; mov rdi, rcx
+// 1:       dec rsi ; jnz loop ; ret
+// target_k (at targets_off + k*stride): jmp cont
+static int build_layout(indirect_layout *l, int n_targets, size_t stride) {
+    static const uint8_t prologue[] = { 0x48, 0x89, 0xF9 };                 // mov rcx, rdi
+    static const uint8_t dispatch[] = { 0x48, 0x8B, 0x07,                   // mov rax, [rdi]
+                                        0x48, 0x83, 0xC7, 0x08,             // add rdi, 8
+                                        0xFF, 0xE0 };                       // jmp rax
+    static const uint8_t wrap[]     = { 0x48, 0x39, 0xD7,                   // cmp rdi, rdx
+                                        0x75, 0x03,                         // jne +3
+                                        0x48, 0x89, 0xCF,                   // mov rdi, rcx
+                                        0x48, 0xFF, 0xCE };                 // dec rsi
+    size_t targets_off = 4096;
+    size_t size = targets_off + (size_t)n_targets * stride + 4096;
+    size = (size + 4095) & ~(size_t)4095;
+    if (jit_alloc(&l->code, size)) return -1;
+
+    jit_emit(&l->code, prologue, sizeof(prologue));
+    size_t loop = jit_here(&l->code);
+    jit_emit(&l->code, dispatch, sizeof(dispatch));
+    size_t cont = jit_here(&l->code);
+    jit_emit(&l->code, wrap, sizeof(wrap));
+    jit_jcc(&l->code, JIT_CC_NE, loop);
+    jit_ret(&l->code);
+
+    for (int k = 0; k < n_targets; k++) {
+        size_t off = targets_off + (size_t)k * stride;
+        jit_seek(&l->code, off);
+        jit_jmp(&l->code, cont);
+        l->targets[k] = jit_ptr(&l->code, off);
+    }
+    l->n_targets = n_targets;
+    l->site = (indirect_site_fn)jit_ptr(&l->code, 0);
+    return jit_seal(&l->code);
+}
+
+// ------------------ Measurement ------------------
+typedef struct {
+    uint64_t cycles;
+    double misses;
+} indirect_sample;
+
+static indirect_sample run_sequence(const indirect_layout *l, const void **seq, int len) {
+    uint64_t cyc[TRIALS], miss[TRIALS];
+    l->site(seq, JUMPS, seq + len); // training pass
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t m0 = pmu_read(&misses_ctr);
+        uint64_t start = rdtsc_begin();
+        l->site(seq, JUMPS, seq + len);
+        uint64_t end = rdtsc_end();
+        miss[t] = pmu_read(&misses_ctr) - m0;
+        cyc[t] = end - start;
+    }
+    indirect_sample s;
+    s.cycles = median_u64(cyc, TRIALS);
+    if (pmu_ok(&misses_ctr))
+        s.misses = (double)median_u64(miss, TRIALS);
+    else if (miss_penalty > 0.0 && s.cycles > base_cycles)
+        s.misses = (double)(s.cycles - base_cycles) / miss_penalty;
+    else
+        s.misses = 0.0;
+    return s;
+}
+
+static void log_row(const char *test, int targets, int len, indirect_sample s) {
+    fprintf(csv_fp, "%s,%d,%d,%d,%.1f,%.5f,%.3f,%s\n", test, targets, len, JUMPS,
+            s.misses, s.misses / JUMPS, (double)s.cycles / JUMPS,
+            pmu_ok(&misses_ctr) ? "pmu" : "timing");
+}
+
+// ------------------ Calibration ------------------
+static void calibrate(const indirect_layout *l, const void **seq) {
+    seq[0] = l->targets[0];
+    indirect_sample fixed = run_sequence(l, seq, 1);
+    base_cycles = fixed.cycles;
+
+    // 64K random picks between two targets: not learnable, ~50% mispredicts
+    int len = 65536;
+    seq_seed(0xCA1, 2);
+    for (int i = 0; i < len; i++) seq[i] = l->targets[seq_next(2)];
+    indirect_sample rnd = run_sequence(l, seq, len);
+    if (rnd.cycles > base_cycles)
+        miss_penalty = (double)(rnd.cycles - base_cycles) / (0.5 * JUMPS);
+    printf("Indirect mispredict penalty (timing calibration): %.1f cycles\n", miss_penalty);
+}
+
+// ------------------ Test 1: Cyclic Target Sequences ------------------
+static void cyclic_test(const indirect_layout *l, const void **seq) {
+    int learned = 0, failed = 0;
+    printf("=== Test 1: Cyclic Targets (t0..tK-1) ===\n");
+    for (int k = 1; k <= MAX_TARGETS; k *= 2) {
+        for (int i = 0; i < k; i++) seq[i] = l->targets[i];
+        indirect_sample s = run_sequence(l, seq, k);
+        log_row("cyclic", k, k, s);
+        if (!failed && s.misses / JUMPS < LEARNED_RATE) learned = k;
+        else failed = 1;
+    }
+    printf("Cyclic sequence fully predicted up to %d targets\n", learned);
+}
+
+// ------------------ Test 2: Random Sequences ------------------
+static void random_test(const indirect_layout *l, const void **seq) {
+    static const int targets[] = { 2, 4, 8, 16, 32, 64, 256, 1024 };
+    static const int lengths[] = { 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    int nt = sizeof(targets) / sizeof(targets[0]);
+    int nl = sizeof(lengths) / sizeof(lengths[0]);
+    int best_k = 0, best_len = 0;
+
+    printf("=== Test 2: Random Sequences (K targets, length L) ===\n");
+    for (int ti = 0; ti < nt; ti++) {
+        int k = targets[ti], longest = 0, failed = 0;
+        for (int li = 0; li < nl; li++) {
+            int len = lengths[li];
+            if (len < k) continue;
+            seq_seed(k, len);
+            for (int i = 0; i < len; i++) seq[i] = l->targets[seq_next(k)];
+            indirect_sample s = run_sequence(l, seq, len);
+            log_row("random", k, len, s);
+            if (!failed && s.misses / JUMPS < LEARNED_RATE) longest = len;
+            else failed = 1;
+        }
+        printf("K = %4d: longest learned random sequence L = %d\n", k, longest);
+        if (longest > best_len || (longest == best_len && k > best_k)) {
+            best_len = longest;
+            best_k = k;
+        }
+    }
+    printf("Indirect predictor tracks sequences of ~%d jumps (over %d targets)\n",
+           best_len, best_k);
+}
+
+// ------------------ Main ------------------
+int main(int argc, char **argv) {
+    size_t stride = argc > 1 ? strtoul(argv[1], NULL, 0) : 64;
+    if (stride < 8) stride = 8;
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    csv_fp = fopen("indirect_results.csv", "w");
+    if (!csv_fp) {
+        fprintf(stderr, "Error opening indirect_results.csv\n");
+        return 1;
+    }
+    fprintf(csv_fp, "test,targets,seq_len,jumps,mispredicts,mispredicts_per_jump,cycles_per_jump,source\n");
+
+    if (pmu_open(&misses_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES))
+        printf("branch-misses counter unavailable, estimating from cycles\n");
+
+    static indirect_layout layout;
+    if (build_layout(&layout, MAX_TARGETS, stride)) {
+        perror("jit");
+        return 1;
+    }
+    printf("Indirect site at %p, %d targets every %zu bytes\n",
+           (void *)layout.site, MAX_TARGETS, stride);
+
+    const void **seq = malloc(65536 * sizeof(void *));
+    calibrate(&layout, seq);
+    cyclic_test(&layout, seq);
+    random_test(&layout, seq);
+    free(seq);
+
+    jit_free(&layout.code);
+    pmu_close(&misses_ctr);
+    fclose(csv_fp);
+    preflight_save(&pf, "indirect_results.csv");
+    printf("All results written to indirect_results.csv\n");
+    return 0;
+}
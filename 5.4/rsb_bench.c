@@ -0,0 +1,148 @@
+// rsb_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds rsb_test)
+// Run:     taskset -c 0 ./rsb_test [frame_stride_bytes]
+//
+// Return stack buffer depth. N call frames are emitted at runtime,
+// frame_stride bytes apart (default 64):
+//   frame_i:   call frame_{i+1} ; jmp shared_ret
+//   frame_N-1: jmp shared_ret
+//   shared_ret: ret
+// Every return goes through the single `ret` at shared_ret, so once the
+// RSB is exhausted the BTB fallback cannot guess the right frame: the
+// outer N - depth returns mispredict on each traversal. The knee in
+// mispredicts (or cycles) per traversal gives the RSB depth.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "jit.h"
+#include "preflight.h"
+
+#define MAX_DEPTH     128
+#define TRAVERSALS    20000
+#define TRIALS        7
+#define EXTRA_RATE    0.5   // mispredicts per traversal above depth 1 => RSB exhausted
+
+typedef void (*frame_fn)(void);
+
+static pmu_counter misses_ctr = { -1 };
+static FILE *csv_fp;
+
+// ------------------ Code Generation ------------------
+static frame_fn build_frames(jit_buf *code, int depth, size_t stride) {
+    size_t ret_off = 0;
+    size_t frames_off = 64;
+    size_t size = frames_off + (size_t)depth * stride + 4096;
+    size = (size + 4095) & ~(size_t)4095;
+    if (jit_alloc(code, size)) return NULL;
+
+    jit_seek(code, ret_off);
+    jit_ret(code);
+    for (int i = 0; i < depth; i++) {
+        size_t off = frames_off + (size_t)i * stride;
+        jit_seek(code, off);
+        if (i + 1 < depth) jit_call(code, off + stride);
+        jit_jmp(code, ret_off);
+    }
+    if (jit_seal(code)) return NULL;
+    return (frame_fn)jit_ptr(code, frames_off);
+}
+
+// ------------------ Measurement ------------------
+typedef struct {
+    double cycles;   // per traversal
+    double misses;   // per traversal (PMU only)
+} rsb_sample;
+
+static rsb_sample measure_depth(int depth, size_t stride) {
+    jit_buf code;
+    frame_fn entry = build_frames(&code, depth, stride);
+    rsb_sample r = { 0.0, 0.0 };
+    if (!entry) {
+        perror("jit");
+        return r;
+    }
+
+    double cyc[TRIALS], miss[TRIALS];
+    for (int i = 0; i < TRAVERSALS; i++) entry(); // warm up
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t m0 = pmu_read(&misses_ctr);
+        uint64_t start = rdtsc_begin();
+        for (int i = 0; i < TRAVERSALS; i++) entry();
+        uint64_t end = rdtsc_end();
+        miss[t] = (double)(pmu_read(&misses_ctr) - m0) / TRAVERSALS;
+        cyc[t] = (double)(end - start) / TRAVERSALS;
+    }
+    r.cycles = median(cyc, TRIALS);
+    r.misses = median(miss, TRIALS);
+    jit_free(&code);
+    return r;
+}
+
+// ------------------ Main ------------------
+int main(int argc, char **argv) {
+    size_t stride = argc > 1 ? strtoul(argv[1], NULL, 0) : 64;
+    if (stride < 16) stride = 16;
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    csv_fp = fopen("rsb_results.csv", "w");
+    if (!csv_fp) {
+        fprintf(stderr, "Error opening rsb_results.csv\n");
+        return 1;
+    }
+    fprintf(csv_fp, "depth,cycles_per_traversal,cycles_per_return,mispredicts_per_traversal,source\n");
+
+    int have_pmu = pmu_open(&misses_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES) == 0;
+    if (!have_pmu)
+        printf("branch-misses counter unavailable, using cycles per return\n");
+
+    printf("=== Return Stack Buffer Depth (frame stride %zu) ===\n", stride);
+    rsb_sample s[MAX_DEPTH + 1];
+    for (int depth = 1; depth <= MAX_DEPTH; depth++) {
+        s[depth] = measure_depth(depth, stride);
+        fprintf(csv_fp, "%d,%.2f,%.3f,%.3f,%s\n", depth, s[depth].cycles,
+                s[depth].cycles / depth, s[depth].misses, have_pmu ? "pmu" : "timing");
+    }
+
+    // First depth whose returns stop being predicted
+    int rsb_depth = 0;
+    if (have_pmu) {
+        // a sweep that never breaks found no knee: leave rsb_depth at 0
+        for (int depth = 2; depth <= MAX_DEPTH; depth++) {
+            if (s[depth].misses - s[1].misses > EXTRA_RATE) {
+                rsb_depth = depth - 1;
+                break;
+            }
+        }
+    } else {
+        // cost of one more predicted frame, from the shallow end of the sweep
+        double step = (s[8].cycles - s[2].cycles) / 6.0;
+        for (int depth = 9; depth <= MAX_DEPTH; depth++) {
+            if (s[depth].cycles - s[depth - 1].cycles > 3.0 * step &&
+                s[depth].cycles > s[8].cycles + (depth - 8) * step * 1.5) {
+                rsb_depth = depth - 1;
+                break;
+            }
+        }
+    }
+    if (rsb_depth > 0)
+        printf("Return mispredictions begin past depth %d -> RSB holds ~%d entries\n",
+               rsb_depth, rsb_depth);
+    else
+        printf("No clear knee up to depth %d, inspect rsb_results.csv\n", MAX_DEPTH);
+
+    pmu_close(&misses_ctr);
+    fclose(csv_fp);
+    preflight_save(&pf, "rsb_results.csv");
+    printf("All results written to rsb_results.csv\n");
+    return 0;
+}
@@ -0,0 +1,205 @@
+// avx2_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (no -march: each kernel carries its target)
+// Run:     ./avx2          (ISA_MAX=avx ./avx2 to dispatch like SNB)
+//
+// Packed 32-bit add throughput (8 independent chains) and latency (one
+// dependent chain) at every vector width the host can run:
+//   SSE2     paddd xmm      baseline
+//   AVX      vpaddd xmm     Sandy Bridge
+//   AVX2     vpaddd ymm     Haswell
+//   AVX-512  vpaddd zmm     Skylake-SP
+// Every width is its own kernel compiled for its tier and dispatched on
+// isa_supported(); widths the host lacks are reported as skipped
+// instead of faulting. Each run is reported in TSC ticks, core cycles
+// (common/clock) and nanoseconds, and CPI is taken from core cycles;
+// a run during which the core clock moved is flagged. Package, core
+// and DRAM energy (common/rapl) is reported next to the cycles, with
+// ops per package joule; without RAPL those lines read n/a.
+// Output goes to stdout and avx2_results.txt.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <sched.h>
+#include <immintrin.h>
+#include "isa.h"
+#include "clock.h"
+#include "rapl.h"
+
+#define N 10000000
+
+static inline uint64_t rdtscp_serialized(void) {
+    unsigned lo, hi, aux;
+    __asm__ __volatile__("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux) :: "memory");
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static FILE *fp;
+
+// every line goes to the terminal and the results file
+static void emit(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    va_start(ap, fmt);
+    vfprintf(fp, fmt, ap);
+    va_end(ap);
+}
+
+static void emit_clock(const clk_span *s, uint64_t ticks) {
+    emit("Core clock:   %.3f GHz (before %.3f, after %.3f)%s\n", s->ghz, s->ghz_before, s->ghz_after,
+         s->freq_changed ? "  FREQUENCY CHANGED DURING RUN" : "");
+    emit("TSC ticks:    %llu\n", (unsigned long long)ticks);
+    emit("Core cycles:  %.0f\n", clk_cycles(s, (double)ticks));
+    emit("Time:         %.0f ns\n", clk_ns((double)ticks));
+}
+
+static void emit_energy(const rapl_energy *e, long long ops) {
+    emit("Energy:      ");
+    for (int d = 0; d < RAPL_DOMAINS; d++) {
+        if (e->valid[d]) emit(" %s %.4f J %.2f W", rapl_domain_name(d), e->joules[d], e->watts[d]);
+        else emit(" %s n/a", rapl_domain_name(d));
+        emit(d + 1 < RAPL_DOMAINS ? "," : "\n");
+    }
+    if (e->valid[RAPL_PKG] && e->joules[RAPL_PKG] > 0.0)
+        emit("Ops/J:        %.4g (package)\n", ops / e->joules[RAPL_PKG]);
+    else emit("Ops/J:        n/a\n");
+}
+
+// ------------------ Kernels ------------------
+// X(name, label, isa, target, vector type, set1, add)
+#define WIDTHS(X)                                                                        \
+    X(sse2,   "SSE2",    ISA_BASELINE, ,                  __m128i, _mm_set1_epi32,    _mm_add_epi32)    \
+    X(avx,    "AVX",     ISA_AVX,      ISA_TARGET_AVX,    __m128i, _mm_set1_epi32,    _mm_add_epi32)    \
+    X(avx2,   "AVX2",    ISA_AVX2,     ISA_TARGET_AVX2,   __m256i, _mm256_set1_epi32, _mm256_add_epi32) \
+    X(avx512, "AVX-512", ISA_AVX512,   ISA_TARGET_AVX512, __m512i, _mm512_set1_epi32, _mm512_add_epi32)
+
+// the empty asm after each dependent add keeps the compiler from
+// folding b+b+...+b into a shift; it emits no instruction
+#define DEP(ADD, b) do { b = ADD(b, b); __asm__("" : "+v"(b)); } while (0)
+
+#define DEFINE_KERNELS(name, label, isa, TARGET, vec, SET1, ADD)                          \
+static TARGET uint64_t name##_throughput(void) {                                          \
+    vec a0 = SET1(1), a1 = SET1(2), a2 = SET1(3), a3 = SET1(4);                           \
+    vec a4 = SET1(5), a5 = SET1(6), a6 = SET1(7), a7 = SET1(8);                           \
+    uint64_t start = rdtscp_serialized();                                                 \
+    for (int i = 0; i < N; i++) {                                                         \
+        a0 = ADD(a0, a1); a2 = ADD(a2, a3); a4 = ADD(a4, a5); a6 = ADD(a6, a7);           \
+        a1 = ADD(a1, a0); a3 = ADD(a3, a2); a5 = ADD(a5, a4); a7 = ADD(a7, a6);           \
+    }                                                                                     \
+    __asm__ volatile("" :: "v"(a0), "v"(a1), "v"(a2), "v"(a3),                           \
+                          "v"(a4), "v"(a5), "v"(a6), "v"(a7));                            \
+    return rdtscp_serialized() - start;                                                   \
+}                                                                                         \
+static TARGET uint64_t name##_latency(void) {                                             \
+    vec b = SET1(1);                                                                      \
+    uint64_t start = rdtscp_serialized();                                                 \
+    for (int i = 0; i < N; i++) {                                                         \
+        DEP(ADD, b); DEP(ADD, b); DEP(ADD, b); DEP(ADD, b);                               \
+        DEP(ADD, b); DEP(ADD, b); DEP(ADD, b); DEP(ADD, b);                               \
+    }                                                                                     \
+    __asm__ volatile("" :: "v"(b));                                                       \
+    return rdtscp_serialized() - start;                                                   \
+}
+WIDTHS(DEFINE_KERNELS)
+
+static const struct {
+    const char *label;
+    isa_feature isa;
+    uint64_t (*throughput)(void);
+    uint64_t (*latency)(void);
+} widths[] = {
+#define WIDTH_ENTRY(name, label, isa, ...) { label, isa, name##_throughput, name##_latency },
+    WIDTHS(WIDTH_ENTRY)
+#undef WIDTH_ENTRY
+};
+
+// empty loop overhead (8 barriers per iteration)
+static uint64_t overhead(void) {
+    uint64_t start = rdtscp_serialized();
+    for (int i = 0; i < N; i++) {
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+        __asm__ volatile("" ::: "memory");
+    }
+    return rdtscp_serialized() - start;
+}
+
+int main(void) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(sched_getcpu(), &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask))
+        fprintf(stderr, "Could not pin to the current core\n");
+
+    fp = fopen("avx2_results.txt", "w");
+    if (!fp) {
+        fprintf(stderr, "Could not open results file\n");
+        return 1;
+    }
+    printf("Best ISA tier: %s\n", isa_name(isa_best()));
+    clk_calibrate();
+    clk_open();
+    emit("Core clock source: %s (TSC %.3f GHz)\n", clk_source_name(clk_src()), clk_tsc_ghz());
+    rapl rp;
+    if (rapl_open(&rp, -1) == 0) emit("Energy source: RAPL %s, package %d\n\n", rapl_source_name(rp.source), rp.package);
+    else emit("Energy source: none (RAPL not exposed)\n\n");
+    rapl_mark rm;
+    rapl_energy re;
+
+    clk_span s;
+    clk_begin(&s);
+    uint64_t ticks_overhead = overhead();
+    clk_end(&s);
+    double cycles_overhead = clk_cycles(&s, (double)ticks_overhead);
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        if (!isa_supported(widths[w].isa)) {
+            emit("=== %s Tests ===\nskipped (needs %s: %s)\n\n", widths[w].label,
+                 isa_name(widths[w].isa), isa_reason(widths[w].isa));
+            continue;
+        }
+
+        clk_begin(&s);
+        rapl_begin(&rp, &rm);
+        uint64_t ticks_throughput = widths[w].throughput();
+        rapl_end(&rp, &rm, &re);
+        clk_end(&s);
+        long long total_ops = (long long)N * 8;
+        double cpi = clk_cycles(&s, (double)ticks_throughput) / total_ops;
+        double ipc = 1.0 / cpi;
+        emit("=== %s Throughput Test ===\n", widths[w].label);
+        emit_clock(&s, ticks_throughput);
+        emit_energy(&re, total_ops);
+        emit("Total ops:    %lld\n", total_ops);
+        emit("CPI: %.4f (%.4f TSC ticks/op)\nIPC: %.4f\n\n", cpi, (double)ticks_throughput / total_ops, ipc);
+
+        clk_begin(&s);
+        rapl_begin(&rp, &rm);
+        uint64_t ticks_latency = widths[w].latency();
+        rapl_end(&rp, &rm, &re);
+        clk_end(&s);
+        double cycles_latency = clk_cycles(&s, (double)ticks_latency);
+        double latency = (cycles_latency - cycles_overhead) / total_ops;
+        emit("=== %s Latency Test ===\n", widths[w].label);
+        emit_clock(&s, ticks_latency);
+        emit_energy(&re, total_ops);
+        emit("Empty loop overhead:     %.0f core cycles\n", cycles_overhead);
+        emit("Latency per op:          %.2f core cycles (%.3f ns)\n\n", latency,
+             latency / s.ghz);
+    }
+
+    rapl_close(&rp);
+    clk_close();
+    fclose(fp);
+    printf("All results written to avx2_results.txt\n");
+    return 0;
+}
@@ -0,0 +1,261 @@
+// avx_license.c
+// ===============================================================
+// Compile: ./compile.sh   (builds avx_license)
+// Run:     taskset -c 0 ./avx_license
+//          (sudo modprobe msr and run as root for the APERF/MPERF source)
+//
+// AVX frequency licenses and vector-unit warm-up. A core that drops its
+// clock under heavy vector load looks like it has a worse CPI when TSC
+// ticks are divided by instructions.
+//   timeline: scalar / light AVX2 / heavy AVX2 / light AVX-512 /
+//             heavy AVX-512 phases, each followed by a scalar phase,
+//             with the core frequency sampled every SLICE_US
+//   warmup:   after 5 ms of scalar-only code, the first 256/512-bit
+//             instructions are timed in small chunks to expose the
+//             upper-lane power-up stall
+// Core frequency comes from common/clock (perf cycles / ref-cycles,
+// else APERF / MPERF, else a dependent add chain timed right after
+// each slice).
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include "timing.h"
+#include "isa.h"
+#include "clock.h"
+#include "preflight.h"
+
+#define PHASE_MS      100
+#define SLICE_US      25
+#define IDLE_MS       5
+#define WARMUP_CHUNKS 4000
+#define CHUNK_ITERS   32       // 256 instructions per warm-up chunk
+#define SETTLE_FRAC   0.02     // within 2% of the new steady state
+#define STALL_RATIO   1.5      // warm-up chunk slower than 1.5x steady
+
+typedef void (*work_fn)(long iters);
+
+// ------------------ Workload Kernels ------------------
+// 8 independent chains per iteration, so every kernel is throughput bound
+#define DEFINE_WORK(name, init, regs, insn, fini)                           \
+static void name(long iters) {                                               \
+    __asm__ volatile(init                                                    \
+                     "1:\n\t"                                                \
+                     ".irp r," regs "\n\t" insn "\n\t.endr\n\t"            \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     fini                                                    \
+                     : [n] "+r"(iters) :                                     \
+                     : "rax", "rbx", "rcx", "rdx", "rsi", "rdi", "r8", "r9", \
+                       "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5",       \
+                       "xmm6", "xmm7", "xmm8", "cc");                        \
+}
+
+#define GPRS      "%%rax,%%rbx,%%rcx,%%rdx,%%rsi,%%rdi,%%r8,%%r9"
+#define VREGS     "0,1,2,3,4,5,6,7"
+#define INIT_NONE ""
+#define INIT_FP_Y "vpcmpeqd %%ymm8, %%ymm8, %%ymm8\n\tvpsrld $25, %%ymm8, %%ymm8\n\tvpslld $23, %%ymm8, %%ymm8\n\t" \
+                  ".irp r," VREGS "\n\tvmovaps %%ymm8, %%ymm\\r\n\t.endr\n\t"
+#define INIT_FP_Z "vpternlogd $0xff, %%zmm8, %%zmm8, %%zmm8\n\tvpsrld $25, %%zmm8, %%zmm8\n\tvpslld $23, %%zmm8, %%zmm8\n\t" \
+                  ".irp r," VREGS "\n\tvmovaps %%zmm8, %%zmm\\r\n\t.endr\n\t"
+#define VZU       "vzeroupper\n\t"
+
+DEFINE_WORK(work_scalar,       INIT_NONE, GPRS,  "add $1, \\r", "")
+DEFINE_WORK(work_avx2_light,   INIT_NONE, VREGS, "vpaddd %%ymm8, %%ymm\\r, %%ymm\\r", VZU)
+DEFINE_WORK(work_avx2_heavy,   INIT_FP_Y, VREGS, "vfmadd231ps %%ymm8, %%ymm8, %%ymm\\r", VZU)
+DEFINE_WORK(work_avx512_light, INIT_NONE, VREGS, "vpaddd %%zmm8, %%zmm\\r, %%zmm\\r", VZU)
+DEFINE_WORK(work_avx512_heavy, INIT_FP_Z, VREGS, "vfmadd231ps %%zmm8, %%zmm8, %%zmm\\r", VZU)
+
+static const struct {
+    const char *name;
+    const char *isa;        // for isa_has(), NULL = always
+    work_fn fn;
+} workloads[] = {
+    { "scalar",       NULL,       work_scalar },
+    { "avx2_light",   "avx2",     work_avx2_light },
+    { "avx2_heavy",   "avx2,fma", work_avx2_heavy },
+    { "avx512_light", "avx512f",  work_avx512_light },
+    { "avx512_heavy", "avx512f",  work_avx512_heavy },
+};
+#define N_WORKLOADS (int)(sizeof(workloads) / sizeof(workloads[0]))
+
+static int workload_supported(int w) {
+    return !workloads[w].isa || isa_has(workloads[w].isa);
+}
+
+// ------------------ Test 1: License Timeline ------------------
+typedef struct {
+    double t_us;
+    double ghz;
+} freq_point;
+
+// runs `w` for `ms` milliseconds, one frequency sample per slice
+static int run_phase(int w, int ms, uint64_t t_origin, freq_point *pts, int max_pts) {
+    uint64_t slice = (uint64_t)(SLICE_US * 1000.0 * clk_tsc_ghz());
+    uint64_t end = clk_tsc() + (uint64_t)(ms * 1e6 * clk_tsc_ghz());
+    int n = 0;
+    for (uint64_t now = clk_tsc(); now < end && n < max_pts; ) {
+        clk_mark m0 = clk_read();
+        uint64_t slice_end = now + slice;
+        do workloads[w].fn(64);
+        while ((now = clk_tsc()) < slice_end);
+        clk_mark m1 = clk_read();
+        pts[n].ghz = clk_ghz_between(m0, m1);
+        pts[n].t_us = (double)(now - t_origin) / (clk_tsc_ghz() * 1000.0);
+        n++;
+    }
+    return n;
+}
+
+// median of the second half of a phase
+static double steady_ghz(const freq_point *pts, int n) {
+    int half = n / 2;
+    double *v = malloc((n - half) * sizeof(double));
+    for (int i = half; i < n; i++) v[i - half] = pts[i].ghz;
+    double m = median(v, n - half);
+    free(v);
+    return m;
+}
+
+// first time (us from phase start) after which every sample stays within
+// SETTLE_FRAC of `target`; -1 if the phase never settles
+static double settle_us(const freq_point *pts, int n, double target) {
+    int last_out = -1;
+    for (int i = 0; i < n; i++)
+        if (pts[i].ghz < target * (1.0 - SETTLE_FRAC) || pts[i].ghz > target * (1.0 + SETTLE_FRAC))
+            last_out = i;
+    if (last_out >= n - 1) return -1.0;
+    return pts[last_out + 1].t_us - pts[0].t_us;
+}
+
+static void license_timeline(FILE *tl, FILE *log_fp) {
+    int max_pts = PHASE_MS * 1000 / SLICE_US + 16;
+    freq_point *vec = malloc(max_pts * sizeof(freq_point));
+    freq_point *rec = malloc(max_pts * sizeof(freq_point));
+    uint64_t t0 = clk_tsc();
+
+    int n = run_phase(0, PHASE_MS, t0, rec, max_pts);
+    double base = steady_ghz(rec, n);
+    for (int i = 0; i < n; i++) fprintf(tl, "%.1f,scalar,%.4f\n", rec[i].t_us, rec[i].ghz);
+
+    fprintf(log_fp, "=== Test 1: Frequency per License (%s source, TSC %.3f GHz) ===\n",
+            clk_source_name(clk_src()), clk_tsc_ghz());
+    fprintf(log_fp, "| %-13s | %-10s | %-9s | %-11s | %-14s |\n",
+            "Phase", "Steady GHz", "vs scalar", "Drop (us)", "Recover (us)");
+    fprintf(log_fp, "|---------------|------------|-----------|-------------|----------------|\n");
+    fprintf(log_fp, "| %-13s | %-10.3f | %-9s | %-11s | %-14s |\n", "scalar", base, "1.000", "-", "-");
+
+    for (int w = 1; w < N_WORKLOADS; w++) {
+        if (!workload_supported(w)) {
+            fprintf(log_fp, "| %-13s | %-10s | %-9s | %-11s | %-14s |\n",
+                    workloads[w].name, "skipped", "-", "-", "-");
+            continue;
+        }
+        int nv = run_phase(w, PHASE_MS, t0, vec, max_pts);
+        int nr = run_phase(0, PHASE_MS, t0, rec, max_pts);
+        for (int i = 0; i < nv; i++)
+            fprintf(tl, "%.1f,%s,%.4f\n", vec[i].t_us, workloads[w].name, vec[i].ghz);
+        for (int i = 0; i < nr; i++)
+            fprintf(tl, "%.1f,scalar_after_%s,%.4f\n", rec[i].t_us, workloads[w].name, rec[i].ghz);
+
+        double steady = steady_ghz(vec, nv);
+        char drop[16] = "none", recover[16] = "-";
+        if (steady < base * (1.0 - SETTLE_FRAC)) {
+            double d = settle_us(vec, nv, steady);
+            double r = settle_us(rec, nr, base);
+            if (d >= 0.0) snprintf(drop, sizeof(drop), "%.0f", d);
+            else snprintf(drop, sizeof(drop), "unsettled");
+            if (r >= 0.0) snprintf(recover, sizeof(recover), "%.0f", r);
+            else snprintf(recover, sizeof(recover), "> %d ms", PHASE_MS);
+        }
+        fprintf(log_fp, "| %-13s | %-10.3f | %-9.3f | %-11s | %-14s |\n",
+                workloads[w].name, steady, steady / base, drop, recover);
+    }
+    free(vec);
+    free(rec);
+}
+
+// ------------------ Test 2: Upper-Lane Warm-Up ------------------
+static void spin_scalar(int ms) {
+    uint64_t end = clk_tsc() + (uint64_t)(ms * 1e6 * clk_tsc_ghz());
+    while (clk_tsc() < end) work_scalar(64);
+}
+
+static void warmup_stall(FILE *wu, FILE *log_fp) {
+    double *ticks = malloc(WARMUP_CHUNKS * sizeof(double));
+    double *t_us = malloc(WARMUP_CHUNKS * sizeof(double));
+    double insns = CHUNK_ITERS * 8.0;
+
+    fprintf(log_fp, "\n=== Test 2: Warm-Up after %d ms of Scalar Code ===\n", IDLE_MS);
+    fprintf(log_fp, "| %-13s | %-14s | %-12s | %-12s |\n",
+            "Kernel", "Steady tk/insn", "Stall (us)", "Lost ticks");
+    fprintf(log_fp, "|---------------|----------------|--------------|--------------|\n");
+
+    for (int w = 1; w < N_WORKLOADS; w++) {
+        if (!workload_supported(w)) continue;
+        spin_scalar(IDLE_MS);
+        uint64_t origin = clk_tsc(), prev = origin;
+        for (int c = 0; c < WARMUP_CHUNKS; c++) {
+            workloads[w].fn(CHUNK_ITERS);
+            uint64_t now = clk_tsc();
+            ticks[c] = (double)(now - prev) / insns;
+            t_us[c] = (double)(now - origin) / (clk_tsc_ghz() * 1000.0);
+            prev = now;
+        }
+        double steady = median(ticks + WARMUP_CHUNKS / 2, WARMUP_CHUNKS / 2);
+        int last_slow = -1;
+        double lost = 0.0;
+        for (int c = 0; c < WARMUP_CHUNKS / 2; c++)
+            if (ticks[c] > steady * STALL_RATIO) last_slow = c;
+        for (int c = 0; c <= last_slow; c++)
+            if (ticks[c] > steady) lost += (ticks[c] - steady) * insns;
+        for (int c = 0; c < WARMUP_CHUNKS; c++)
+            fprintf(wu, "%s,%d,%.3f,%.3f\n", workloads[w].name, c, t_us[c], ticks[c]);
+        fprintf(log_fp, "| %-13s | %-14.3f | %-12.2f | %-12.0f |\n", workloads[w].name, steady,
+                last_slow >= 0 ? t_us[last_slow] : 0.0, lost);
+    }
+    free(ticks);
+    free(t_us);
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(sched_getcpu(), &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask))
+        fprintf(stderr, "Could not pin to the current core\n");
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *tl = fopen("avx_license_timeline.csv", "w");
+    FILE *wu = fopen("avx_warmup.csv", "w");
+    if (!tl || !wu) {
+        fprintf(stderr, "Error opening avx_license_timeline.csv / avx_warmup.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_license.txt", "w");
+    if (!log_fp) log_fp = stdout;
+    fprintf(tl, "t_us,phase,core_ghz\n");
+    fprintf(wu, "kernel,chunk,t_us,ticks_per_insn\n");
+
+    clk_calibrate();
+    clk_open();
+    printf("Frequency source: %s (TSC %.3f GHz)\n", clk_source_name(clk_src()), clk_tsc_ghz());
+
+    license_timeline(tl, log_fp);
+    warmup_stall(wu, log_fp);
+
+    clk_close();
+    fclose(tl);
+    fclose(wu);
+    preflight_save(&pf, "avx_license_timeline.csv");
+    preflight_save(&pf, "avx_warmup.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    printf("All results written to results_license.txt, avx_license_timeline.csv and avx_warmup.csv\n");
+    return 0;
+}
@@ -1 +1,5 @@
-gcc -O2 -fno-tree-vectorize -march=native -std=c11 -Wall -o avx2 avx2_bench.c
\ No newline at end of file
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o avx2 avx2_bench.c ../common/isa.c ../common/clock.c ../common/pmu.c ../common/rapl.c
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o simd_table simd_table.c ../common/timing.c ../common/pmu.c ../common/isa.c ../common/preflight.c ../common/sysfs.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o avx_license avx_license.c ../common/timing.c ../common/pmu.c ../common/isa.c ../common/clock.c ../common/preflight.c ../common/sysfs.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o fp_bench fp_bench.c ../common/timing.c ../common/pmu.c ../common/isa.c ../common/preflight.c ../common/sysfs.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o gather_bench gather_bench.c ../common/timing.c ../common/pmu.c ../common/isa.c ../common/preflight.c ../common/sysfs.c -lpthread
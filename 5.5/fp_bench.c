@@ -0,0 +1,388 @@
+// fp_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds fp_bench)
+// Run:     taskset -c 0 ./fp_bench
+//
+// Floating-point latency, throughput and microcode-assist costs.
+//   arith:    add / mul / FMA latency (one chain) and reciprocal
+//             throughput (12 independent chains) for ss, ps x/y/z,
+//             sd, pd x/y/z
+//   divsqrt:  div / sqrt latency for different operand values. The
+//             chain is  r = op(a'); a' = (r & 0) | a  so every step
+//             sees the same operands; the and/or cost is measured on
+//             its own and subtracted.
+//   denormal: independent mul / add / FMA with normal operands, a
+//             denormal input, or a denormal result, under each MXCSR
+//             mode (default, FTZ, DAZ, FTZ+DAZ). "extra" is the cost
+//             over the normal case in the same mode, i.e. the assist.
+// Cycles are core cycles when perf exposes them, otherwise TSC ticks.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "isa.h"
+#include "preflight.h"
+
+#define UNROLL  24      // multiple of 12
+#define ITERS   100000
+#define TRIALS  5
+
+#define STR(x)  #x
+#define XSTR(x) STR(x)
+
+#define MXCSR_DAZ 0x0040
+#define MXCSR_FTZ 0x8000
+
+typedef void (*fp_kernel_fn)(const void *vals, long iters);
+
+static pmu_counter cycles_ctr = { -1 };
+
+// cycles per instruction for `insns` instructions per loop iteration
+static double run_kernel(fp_kernel_fn fn, const void *vals, long iters, int insns) {
+    double s[TRIALS];
+    fn(vals, iters / 10 + 1); // warm up
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t c0 = pmu_read(&cycles_ctr);
+        uint64_t start = rdtsc_begin();
+        fn(vals, iters);
+        uint64_t end = rdtsc_end();
+        uint64_t c = pmu_ok(&cycles_ctr) ? pmu_read(&cycles_ctr) - c0 : end - start;
+        s[t] = (double)c / ((double)iters * insns);
+    }
+    return median(s, TRIALS);
+}
+
+#define VEC_CLOBBERS "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",          \
+                     "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",  \
+                     "cc", "memory"
+
+// all 16 registers start from the 64-byte block at vals (1.0 in every lane)
+#define LOAD_ALL(reg) ".irp r,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15\n\tvmovups (%[v]), %%" reg "\\r\n\t.endr\n\t"
+
+// ------------------ Test 1: Arithmetic Kernels ------------------
+// slots as in simd_table.c: \d written, \a chained source, \b other source
+#define DEFINE_ARITH(name, reg, insn)                                        \
+static void lat_##name(const void *vals, long iters) {                       \
+    __asm__ volatile(LOAD_ALL(reg)                                           \
+                     ".macro op d, a, b\n\t" insn "\n\t.endm\n\t"            \
+                     "1:\n\t"                                                \
+                     ".rept " XSTR(UNROLL) "\n\t"                            \
+                     "op 0, 0, 14\n\t"                                       \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     ".purgem op\n\t"                                        \
+                     "vzeroupper\n\t"                                        \
+                     : [n] "+r"(iters) : [v] "r"(vals) : VEC_CLOBBERS);      \
+}                                                                            \
+static void tp_##name(const void *vals, long iters) {                        \
+    __asm__ volatile(LOAD_ALL(reg)                                           \
+                     ".macro op d, a, b\n\t" insn "\n\t.endm\n\t"            \
+                     "1:\n\t"                                                \
+                     ".rept " XSTR(UNROLL) "/12\n\t"                         \
+                     ".irp i,1,2,3,4,5,6,7,8,9,10,11,12\n\t"                 \
+                     "op \\i, 13, 14\n\t"                                    \
+                     ".endr\n\t"                                             \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     ".purgem op\n\t"                                        \
+                     "vzeroupper\n\t"                                        \
+                     : [n] "+r"(iters) : [v] "r"(vals) : VEC_CLOBBERS);      \
+}
+
+// X(name, isa, single precision?, register prefix, template)
+#define ARITH_LIST(X)                                                                   \
+    X(add_ss,   "avx",     1, "xmm", "vaddss %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(add_ps_x, "avx",     1, "xmm", "vaddps %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(add_ps_y, "avx",     1, "ymm", "vaddps %%ymm\\b, %%ymm\\a, %%ymm\\d")             \
+    X(add_ps_z, "avx512f", 1, "zmm", "vaddps %%zmm\\b, %%zmm\\a, %%zmm\\d")             \
+    X(add_sd,   "avx",     0, "xmm", "vaddsd %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(add_pd_x, "avx",     0, "xmm", "vaddpd %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(add_pd_y, "avx",     0, "ymm", "vaddpd %%ymm\\b, %%ymm\\a, %%ymm\\d")             \
+    X(add_pd_z, "avx512f", 0, "zmm", "vaddpd %%zmm\\b, %%zmm\\a, %%zmm\\d")             \
+    X(mul_ss,   "avx",     1, "xmm", "vmulss %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(mul_ps_x, "avx",     1, "xmm", "vmulps %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(mul_ps_y, "avx",     1, "ymm", "vmulps %%ymm\\b, %%ymm\\a, %%ymm\\d")             \
+    X(mul_ps_z, "avx512f", 1, "zmm", "vmulps %%zmm\\b, %%zmm\\a, %%zmm\\d")             \
+    X(mul_sd,   "avx",     0, "xmm", "vmulsd %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(mul_pd_x, "avx",     0, "xmm", "vmulpd %%xmm\\b, %%xmm\\a, %%xmm\\d")             \
+    X(mul_pd_y, "avx",     0, "ymm", "vmulpd %%ymm\\b, %%ymm\\a, %%ymm\\d")             \
+    X(mul_pd_z, "avx512f", 0, "zmm", "vmulpd %%zmm\\b, %%zmm\\a, %%zmm\\d")             \
+    X(fma_ss,   "fma",     1, "xmm", "vfmadd231ss %%xmm\\b, %%xmm\\a, %%xmm\\d")        \
+    X(fma_ps_x, "fma",     1, "xmm", "vfmadd231ps %%xmm\\b, %%xmm\\a, %%xmm\\d")        \
+    X(fma_ps_y, "fma",     1, "ymm", "vfmadd231ps %%ymm\\b, %%ymm\\a, %%ymm\\d")        \
+    X(fma_ps_z, "avx512f", 1, "zmm", "vfmadd231ps %%zmm\\b, %%zmm\\a, %%zmm\\d")        \
+    X(fma_sd,   "fma",     0, "xmm", "vfmadd231sd %%xmm\\b, %%xmm\\a, %%xmm\\d")        \
+    X(fma_pd_x, "fma",     0, "xmm", "vfmadd231pd %%xmm\\b, %%xmm\\a, %%xmm\\d")        \
+    X(fma_pd_y, "fma",     0, "ymm", "vfmadd231pd %%ymm\\b, %%ymm\\a, %%ymm\\d")        \
+    X(fma_pd_z, "avx512f", 0, "zmm", "vfmadd231pd %%zmm\\b, %%zmm\\a, %%zmm\\d")
+
+#define DEFINE_ARITH_ENTRY(name, isa, single, reg, insn) DEFINE_ARITH(name, reg, insn)
+ARITH_LIST(DEFINE_ARITH_ENTRY)
+
+#define ARITH_ENTRY(name, isa, single, reg, insn) { #name, isa, single, lat_##name, tp_##name },
+static const struct {
+    const char *name;
+    const char *isa;        // for isa_has()
+    int single;
+    fp_kernel_fn lat, tp;
+} arith[] = { ARITH_LIST(ARITH_ENTRY) };
+#define N_ARITH (int)(sizeof(arith) / sizeof(arith[0]))
+
+static float ones_f[16] __attribute__((aligned(64)));
+static double ones_d[8] __attribute__((aligned(64)));
+
+static void arith_test(FILE *fp, FILE *log_fp) {
+    fprintf(log_fp, "=== Test 1: Add / Mul / FMA ===\n");
+    fprintf(log_fp, "| %-9s | %-8s | %-12s |\n", "Kernel", "Latency", "Recip. Thru.");
+    fprintf(log_fp, "|-----------|----------|--------------|\n");
+    for (int i = 0; i < N_ARITH; i++) {
+        if (!isa_has(arith[i].isa)) {
+            fprintf(fp, "arith,%s,-,default,,,,skipped\n", arith[i].name);
+            fprintf(log_fp, "| %-9s | %-8s | %-12s |\n", arith[i].name, "skipped", "-");
+            continue;
+        }
+        const void *v = arith[i].single ? (const void *)ones_f : (const void *)ones_d;
+        double lat = run_kernel(arith[i].lat, v, ITERS, UNROLL);
+        double tp = run_kernel(arith[i].tp, v, ITERS, UNROLL);
+        fprintf(fp, "arith,%s,-,default,%.3f,%.3f,,ok\n", arith[i].name, lat, tp);
+        fprintf(log_fp, "| %-9s | %-8.2f | %-12.3f |\n", arith[i].name, lat, tp);
+    }
+}
+
+// ------------------ Test 2: Div / Sqrt vs Operand Value ------------------
+// vals[0] = a, vals[1] = b in the kernel's precision; register 13 = a,
+// 14 = b, 15 = 0; the op reads register 0 and writes register 1
+#define DEFINE_DIVSQRT(name, bcast, reg, insn, andop, orop)                  \
+static void name(const void *vals, long iters) {                             \
+    __asm__ volatile(bcast " (%[v]), %%" reg "13\n\t"                        \
+                     bcast " %c[b](%[v]), %%" reg "14\n\t"                   \
+                     "vpxor %%xmm15, %%xmm15, %%xmm15\n\t"                   \
+                     "vmovaps %%" reg "13, %%" reg "0\n\t"                   \
+                     "1:\n\t"                                                \
+                     ".rept 8\n\t"                                           \
+                     insn "\n\t"                                             \
+                     andop " %%" reg "15, %%" reg "1, %%" reg "1\n\t"        \
+                     orop " %%" reg "13, %%" reg "1, %%" reg "0\n\t"         \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     "vzeroupper\n\t"                                        \
+                     : [n] "+r"(iters)                                       \
+                     : [v] "r"(vals), [b] "i"(sizeof(double))                \
+                     : VEC_CLOBBERS);                                        \
+}
+
+// the op slot is empty in the overhead kernels: r = a' directly
+DEFINE_DIVSQRT(chain_sd,   "vmovsd",       "xmm", "vmovaps %%xmm0, %%xmm1",             "vandpd", "vorpd")
+DEFINE_DIVSQRT(div_sd,     "vmovsd",       "xmm", "vdivsd %%xmm14, %%xmm0, %%xmm1",     "vandpd", "vorpd")
+DEFINE_DIVSQRT(sqrt_sd,    "vmovsd",       "xmm", "vsqrtsd %%xmm0, %%xmm0, %%xmm1",     "vandpd", "vorpd")
+DEFINE_DIVSQRT(chain_pd_y, "vbroadcastsd", "ymm", "vmovaps %%ymm0, %%ymm1",             "vandpd", "vorpd")
+DEFINE_DIVSQRT(div_pd_y,   "vbroadcastsd", "ymm", "vdivpd %%ymm14, %%ymm0, %%ymm1",     "vandpd", "vorpd")
+DEFINE_DIVSQRT(sqrt_pd_y,  "vbroadcastsd", "ymm", "vsqrtpd %%ymm0, %%ymm1",             "vandpd", "vorpd")
+DEFINE_DIVSQRT(chain_ss,   "vmovss",       "xmm", "vmovaps %%xmm0, %%xmm1",             "vandps", "vorps")
+DEFINE_DIVSQRT(div_ss,     "vmovss",       "xmm", "vdivss %%xmm14, %%xmm0, %%xmm1",     "vandps", "vorps")
+DEFINE_DIVSQRT(sqrt_ss,    "vmovss",       "xmm", "vsqrtss %%xmm0, %%xmm0, %%xmm1",     "vandps", "vorps")
+DEFINE_DIVSQRT(chain_ps_y, "vbroadcastss", "ymm", "vmovaps %%ymm0, %%ymm1",             "vandps", "vorps")
+DEFINE_DIVSQRT(div_ps_y,   "vbroadcastss", "ymm", "vdivps %%ymm14, %%ymm0, %%ymm1",     "vandps", "vorps")
+DEFINE_DIVSQRT(sqrt_ps_y,  "vbroadcastss", "ymm", "vsqrtps %%ymm0, %%ymm1",             "vandps", "vorps")
+
+static const struct {
+    const char *name;
+    int single;
+    fp_kernel_fn fn, chain;
+} divsqrt[] = {
+    { "div_sd",   0, div_sd,    chain_sd },   { "sqrt_sd",   0, sqrt_sd,   chain_sd },
+    { "div_pd_y", 0, div_pd_y,  chain_pd_y }, { "sqrt_pd_y", 0, sqrt_pd_y, chain_pd_y },
+    { "div_ss",   1, div_ss,    chain_ss },   { "sqrt_ss",   1, sqrt_ss,   chain_ss },
+    { "div_ps_y", 1, div_ps_y,  chain_ps_y }, { "sqrt_ps_y", 1, sqrt_ps_y, chain_ps_y },
+};
+
+// operands stay in float range so every row applies to both precisions
+static const struct { const char *label; double a, b; } operand_sets[] = {
+    { "1/1",         1.0,               1.0 },
+    { "1/2",         1.0,               2.0 },
+    { "1/3",         1.0,               3.0 },
+    { "pi/e",        3.14159265358979,  2.71828182845905 },
+    { "7/1.0000001", 7.0,               1.0000001 },
+    { "1e18/1e-18",  1e18,              1e-18 },
+    { "0/3",         0.0,               3.0 },
+    { "4/4",         4.0,               4.0 },
+};
+#define N_OPERANDS (int)(sizeof(operand_sets) / sizeof(operand_sets[0]))
+
+static void divsqrt_test(FILE *fp, FILE *log_fp) {
+    double dv[2] __attribute__((aligned(16)));
+    float fv[4] __attribute__((aligned(16)));
+
+    fprintf(log_fp, "\n=== Test 2: Div / Sqrt Latency by Operand (sqrt uses a) ===\n");
+    fprintf(log_fp, "| %-11s |", "a/b");
+    for (unsigned k = 0; k < sizeof(divsqrt) / sizeof(divsqrt[0]); k++)
+        fprintf(log_fp, " %-9s |", divsqrt[k].name);
+    fprintf(log_fp, "\n|-------------|");
+    for (unsigned k = 0; k < sizeof(divsqrt) / sizeof(divsqrt[0]); k++)
+        fprintf(log_fp, "-----------|");
+    fprintf(log_fp, "\n");
+
+    for (int o = 0; o < N_OPERANDS; o++) {
+        dv[0] = operand_sets[o].a;
+        dv[1] = operand_sets[o].b;
+        fv[0] = (float)dv[0];
+        fv[2] = (float)dv[1];   // kernels read b at offset sizeof(double)
+        fprintf(log_fp, "| %-11s |", operand_sets[o].label);
+        for (unsigned k = 0; k < sizeof(divsqrt) / sizeof(divsqrt[0]); k++) {
+            const void *v = divsqrt[k].single ? (const void *)fv : (const void *)dv;
+            double c = run_kernel(divsqrt[k].fn, v, ITERS / 8, 8);
+            double base = run_kernel(divsqrt[k].chain, v, ITERS / 8, 8);
+            fprintf(fp, "divsqrt,%s,%s,default,%.3f,,,ok\n", divsqrt[k].name,
+                    operand_sets[o].label, c - base);
+            fprintf(log_fp, " %-9.2f |", c - base);
+        }
+        fprintf(log_fp, "\n");
+    }
+}
+
+// ------------------ Test 3: Denormal Assists ------------------
+// independent results: d_i = op(a, b) (+ c for FMA); 13 = a, 14 = b, 15 = c
+#define DEFINE_DENORM(name, bcast, reg, insn)                                \
+static void name(const void *vals, long iters) {                             \
+    __asm__ volatile(bcast " (%[v]), %%" reg "13\n\t"                        \
+                     bcast " %c[b](%[v]), %%" reg "14\n\t"                   \
+                     bcast " %c[c](%[v]), %%" reg "15\n\t"                   \
+                     "1:\n\t"                                                \
+                     ".irp i,0,1,2,3,4,5,6,7,8,9,10,11\n\t"                  \
+                     insn "\n\t"                                             \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     "vzeroupper\n\t"                                        \
+                     : [n] "+r"(iters)                                       \
+                     : [v] "r"(vals), [b] "i"(sizeof(double)),               \
+                       [c] "i"(2 * sizeof(double))                           \
+                     : VEC_CLOBBERS);                                        \
+}
+
+DEFINE_DENORM(dn_mul_sd,   "vmovsd",       "xmm", "vmulsd %%xmm14, %%xmm13, %%xmm\\i")
+DEFINE_DENORM(dn_add_sd,   "vmovsd",       "xmm", "vaddsd %%xmm14, %%xmm13, %%xmm\\i")
+DEFINE_DENORM(dn_fma_sd,   "vmovsd",       "xmm", "vmovaps %%xmm15, %%xmm\\i\n\tvfmadd231sd %%xmm14, %%xmm13, %%xmm\\i")
+DEFINE_DENORM(dn_mul_ps_y, "vbroadcastss", "ymm", "vmulps %%ymm14, %%ymm13, %%ymm\\i")
+DEFINE_DENORM(dn_add_ps_y, "vbroadcastss", "ymm", "vaddps %%ymm14, %%ymm13, %%ymm\\i")
+DEFINE_DENORM(dn_fma_ps_y, "vbroadcastss", "ymm", "vmovaps %%ymm15, %%ymm\\i\n\tvfmadd231ps %%ymm14, %%ymm13, %%ymm\\i")
+
+enum { OP_MUL, OP_ADD, OP_FMA };
+static const struct {
+    const char *name;
+    const char *isa;
+    int op, single;
+    fp_kernel_fn fn;
+} denorm_kernels[] = {
+    { "mul_sd",   "avx", OP_MUL, 0, dn_mul_sd },   { "add_sd",   "avx", OP_ADD, 0, dn_add_sd },
+    { "fma_sd",   "fma", OP_FMA, 0, dn_fma_sd },   { "mul_ps_y", "avx", OP_MUL, 1, dn_mul_ps_y },
+    { "add_ps_y", "avx", OP_ADD, 1, dn_add_ps_y }, { "fma_ps_y", "fma", OP_FMA, 1, dn_fma_ps_y },
+};
+
+enum { CASE_NORMAL, CASE_DENORM_IN, CASE_DENORM_OUT, N_CASES };
+static const char *case_name[] = { "normal", "denormal_in", "denormal_out" };
+
+// a, b, c for op/case in double; the float table scales exponents to match
+static void denorm_operands(int op, int cs, int single, double out[3]) {
+    double min_normal = single ? 0x1p-126 : 0x1p-1022;
+    double tiny = single ? 0x1p-70 : 0x1p-520;       // tiny * tiny is denormal
+    double denorm = min_normal / 8.0;
+    out[0] = 1.5; out[1] = 1.25; out[2] = 0.5;
+    if (cs == CASE_DENORM_IN) {
+        out[0] = denorm;
+        out[1] = op == OP_ADD ? 1.0 : 0x1p60;          // result is normal
+    } else if (cs == CASE_DENORM_OUT) {
+        if (op == OP_ADD) { out[0] = min_normal * 1.5; out[1] = -min_normal * 1.25; }
+        else              { out[0] = tiny; out[1] = tiny; out[2] = 0.0; }
+    }
+}
+
+static void denormal_test(FILE *fp, FILE *log_fp) {
+    static const struct { const char *name; unsigned bits; } modes[] = {
+        { "default", 0 }, { "ftz", MXCSR_FTZ }, { "daz", MXCSR_DAZ }, { "ftz_daz", MXCSR_FTZ | MXCSR_DAZ },
+    };
+    const int insns = 12;
+    double dv[3] __attribute__((aligned(16)));
+    float fv[6] __attribute__((aligned(16)));
+    unsigned saved = _mm_getcsr();
+
+    fprintf(log_fp, "\n=== Test 3: Denormal Assist Cost (extra cycles per instruction) ===\n");
+    fprintf(log_fp, "| %-8s | %-12s | %-8s | %-8s | %-8s | %-8s |\n",
+            "Kernel", "Case", "default", "ftz", "daz", "ftz_daz");
+    fprintf(log_fp, "|----------|--------------|----------|----------|----------|----------|\n");
+
+    for (unsigned k = 0; k < sizeof(denorm_kernels) / sizeof(denorm_kernels[0]); k++) {
+        if (!isa_has(denorm_kernels[k].isa)) continue;
+        double c[4][N_CASES];
+        for (int m = 0; m < 4; m++) {
+            for (int cs = 0; cs < N_CASES; cs++) {
+                double ops[3];
+                denorm_operands(denorm_kernels[k].op, cs, denorm_kernels[k].single, ops);
+                for (int j = 0; j < 3; j++) {
+                    dv[j] = ops[j];
+                    fv[2 * j] = (float)ops[j];   // kernels read operand j at j * sizeof(double)
+                }
+                const void *v = denorm_kernels[k].single ? (const void *)fv : (const void *)dv;
+                _mm_setcsr((saved & ~(MXCSR_FTZ | MXCSR_DAZ)) | modes[m].bits);
+                c[m][cs] = run_kernel(denorm_kernels[k].fn, v, ITERS / 10, insns);
+                _mm_setcsr(saved);
+            }
+        }
+        for (int cs = 0; cs < N_CASES; cs++) {
+            fprintf(log_fp, "| %-8s | %-12s |", denorm_kernels[k].name, case_name[cs]);
+            for (int m = 0; m < 4; m++) {
+                double extra = c[m][cs] - c[m][CASE_NORMAL];
+                fprintf(fp, "denormal,%s,%s,%s,,%.3f,%.3f,ok\n", denorm_kernels[k].name,
+                        case_name[cs], modes[m].name, c[m][cs], extra);
+                fprintf(log_fp, " %-8.1f |", extra);
+            }
+            fprintf(log_fp, "\n");
+        }
+    }
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    for (int i = 0; i < 16; i++) ones_f[i] = 1.0f;
+    for (int i = 0; i < 8; i++) ones_d[i] = 1.0;
+
+    if (!isa_supported(ISA_AVX)) {
+        fprintf(stderr, "fp_bench needs AVX\n");
+        return 1;
+    }
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("fp_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening fp_results.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_fp.txt", "w");
+    if (!log_fp) log_fp = stdout;
+
+    if (pmu_open(&cycles_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES))
+        printf("cycles counter unavailable, reporting TSC ticks\n");
+    fprintf(fp, "test,kernel,case,mxcsr,latency,recip_throughput,extra_cycles,status\n");
+
+    arith_test(fp, log_fp);
+    divsqrt_test(fp, log_fp);
+    denormal_test(fp, log_fp);
+
+    pmu_close(&cycles_ctr);
+    fclose(fp);
+    preflight_save(&pf, "fp_results.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    printf("All results written to results_fp.txt and fp_results.csv\n");
+    return 0;
+}
@@ -0,0 +1,516 @@
+// gather_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds gather_bench)
+// Run:     taskset -c 0 ./gather_bench
+//
+// Gather / scatter and masked load / store throughput against an
+// unrolled scalar loop doing the same element accesses.
+//   gather, scatter: index patterns
+//       contiguous  idx = i, the window sliding along the working set
+//                   pass by pass so the sweep covers all of it
+//       same_line   every vector's lanes fall in one random 64 B line
+//       same_page   every vector's lanes fall in one random 4 KB page
+//       random      uniform over the working set
+//     x working sets sized from the cache hierarchy (L1 / L2 / LLC / DRAM)
+//     x element width (32, 64) x vector width (128, 256, 512)
+//   masked_load, masked_store: contiguous sweep with a fraction of the
+//     lanes enabled (random masks); the scalar loop touches only the
+//     enabled elements.
+// Throughput is elements (enabled elements, for masked ops) per cycle;
+// speedup > 1 means the vector form wins at that point.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <immintrin.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "isa.h"
+#include "preflight.h"
+
+#define TOTAL_ELEMS (1u << 22)   // elements per measurement
+#define MAX_IDX     (1u << 20)   // index stream length cap
+#define N_MASKS     64
+#define TRIALS      3
+
+static pmu_counter cycles_ctr = { -1 };
+static volatile uint64_t sink;
+
+// ------------------ Gather / Scatter Kernels ------------------
+// every kernel walks idx[0..n_idx) repeatedly until `total` elements are done
+typedef uint64_t (*idx_kernel_fn)(void *base, const uint32_t *idx, size_t n_idx, size_t total);
+
+#define FOR_EACH_VECTOR(lanes)                                   \
+    for (size_t done = 0; done < total; done += n_idx)           \
+        for (size_t i = 0; i < n_idx; i += (lanes))
+
+// vector kernels are built per tier (AVX2 for xmm/ymm gathers, AVX-512
+// for zmm) and only the ones isa_supported() allows are run
+static uint64_t fold128(__m128i v) {
+    uint64_t t[2];
+    _mm_storeu_si128((__m128i *)t, v);
+    return t[0] + t[1];
+}
+static inline ISA_TARGET_AVX2 uint64_t fold256(__m256i v) {
+    return fold128(_mm256_castsi256_si128(v)) + fold128(_mm256_extracti128_si256(v, 1));
+}
+
+static ISA_TARGET_AVX2 uint64_t gather32_x(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    __m128i acc = _mm_setzero_si128();
+    FOR_EACH_VECTOR(4)
+        acc = _mm_add_epi32(acc, _mm_i32gather_epi32((const int *)base,
+                                 _mm_loadu_si128((const __m128i *)(idx + i)), 4));
+    return fold128(acc);
+}
+static ISA_TARGET_AVX2 uint64_t gather32_y(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    __m256i acc = _mm256_setzero_si256();
+    FOR_EACH_VECTOR(8)
+        acc = _mm256_add_epi32(acc, _mm256_i32gather_epi32((const int *)base,
+                                    _mm256_loadu_si256((const __m256i *)(idx + i)), 4));
+    return fold256(acc);
+}
+static ISA_TARGET_AVX2 uint64_t gather64_x(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    __m128i acc = _mm_setzero_si128();
+    FOR_EACH_VECTOR(2)
+        acc = _mm_add_epi64(acc, _mm_i32gather_epi64((const long long *)base,
+                                 _mm_loadl_epi64((const __m128i *)(idx + i)), 8));
+    return fold128(acc);
+}
+static ISA_TARGET_AVX2 uint64_t gather64_y(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    __m256i acc = _mm256_setzero_si256();
+    FOR_EACH_VECTOR(4)
+        acc = _mm256_add_epi64(acc, _mm256_i32gather_epi64((const long long *)base,
+                                    _mm_loadu_si128((const __m128i *)(idx + i)), 8));
+    return fold256(acc);
+}
+static inline ISA_TARGET_AVX512 uint64_t fold512(__m512i v) {
+    return fold256(_mm512_castsi512_si256(v)) + fold256(_mm512_extracti64x4_epi64(v, 1));
+}
+static ISA_TARGET_AVX512 uint64_t gather32_z(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    __m512i acc = _mm512_setzero_si512();
+    FOR_EACH_VECTOR(16)
+        acc = _mm512_add_epi32(acc, _mm512_i32gather_epi32(
+                                    _mm512_loadu_si512(idx + i), base, 4));
+    return fold512(acc);
+}
+static ISA_TARGET_AVX512 uint64_t gather64_z(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    __m512i acc = _mm512_setzero_si512();
+    FOR_EACH_VECTOR(8)
+        acc = _mm512_add_epi64(acc, _mm512_i32gather_epi64(
+                                    _mm256_loadu_si256((const __m256i *)(idx + i)), base, 8));
+    return fold512(acc);
+}
+static ISA_TARGET_AVX512 uint64_t scatter32_z(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    FOR_EACH_VECTOR(16) {
+        __m512i vi = _mm512_loadu_si512(idx + i);
+        _mm512_i32scatter_epi32(base, vi, vi, 4);
+    }
+    return 0;
+}
+static ISA_TARGET_AVX512 uint64_t scatter64_z(void *base, const uint32_t *idx, size_t n_idx, size_t total) {
+    FOR_EACH_VECTOR(8) {
+        __m256i vi = _mm256_loadu_si256((const __m256i *)(idx + i));
+        _mm512_i32scatter_epi64(base, vi, _mm512_cvtepu32_epi64(vi), 8);
+    }
+    return 0;
+}
+
+// scalar baselines: 8 accesses per step, 4 accumulators
+#define DEFINE_SCALAR_GATHER(name, type)                                          \
+static uint64_t name(void *base, const uint32_t *idx, size_t n_idx, size_t total) { \
+    const type *b = base;                                                         \
+    uint64_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;                                      \
+    FOR_EACH_VECTOR(8) {                                                          \
+        a0 += b[idx[i]];     a1 += b[idx[i + 1]];                                 \
+        a2 += b[idx[i + 2]]; a3 += b[idx[i + 3]];                                 \
+        a0 += b[idx[i + 4]]; a1 += b[idx[i + 5]];                                 \
+        a2 += b[idx[i + 6]]; a3 += b[idx[i + 7]];                                 \
+    }                                                                             \
+    return a0 + a1 + a2 + a3;                                                     \
+}
+#define DEFINE_SCALAR_SCATTER(name, type)                                         \
+static uint64_t name(void *base, const uint32_t *idx, size_t n_idx, size_t total) { \
+    type *b = base;                                                               \
+    FOR_EACH_VECTOR(8) {                                                          \
+        b[idx[i]]     = idx[i];     b[idx[i + 1]] = idx[i + 1];                   \
+        b[idx[i + 2]] = idx[i + 2]; b[idx[i + 3]] = idx[i + 3];                   \
+        b[idx[i + 4]] = idx[i + 4]; b[idx[i + 5]] = idx[i + 5];                   \
+        b[idx[i + 6]] = idx[i + 6]; b[idx[i + 7]] = idx[i + 7];                   \
+    }                                                                             \
+    return 0;                                                                     \
+}
+DEFINE_SCALAR_GATHER(scalar_load32, uint32_t)
+DEFINE_SCALAR_GATHER(scalar_load64, uint64_t)
+DEFINE_SCALAR_SCATTER(scalar_store32, uint32_t)
+DEFINE_SCALAR_SCATTER(scalar_store64, uint64_t)
+
+typedef struct {
+    const char *op;       // gather / scatter
+    int elem_bits, vec_bits;
+    isa_feature isa;
+    idx_kernel_fn fn, scalar;
+} idx_kernel;
+
+static const idx_kernel idx_catalog[] = {
+    { "gather",  32, 128, ISA_AVX2,   gather32_x,  scalar_load32 },
+    { "gather",  32, 256, ISA_AVX2,   gather32_y,  scalar_load32 },
+    { "gather",  64, 128, ISA_AVX2,   gather64_x,  scalar_load64 },
+    { "gather",  64, 256, ISA_AVX2,   gather64_y,  scalar_load64 },
+    { "gather",  32, 512, ISA_AVX512, gather32_z,  scalar_load32 },
+    { "gather",  64, 512, ISA_AVX512, gather64_z,  scalar_load64 },
+    { "scatter", 32, 512, ISA_AVX512, scatter32_z, scalar_store32 },
+    { "scatter", 64, 512, ISA_AVX512, scatter64_z, scalar_store64 },
+};
+#define N_IDX_CATALOG (int)(sizeof(idx_catalog) / sizeof(idx_catalog[0]))
+
+// ------------------ Masked Load / Store Kernels ------------------
+// walk base[0..n_elem) repeatedly; vector k uses mask k % N_MASKS.
+// n_elem must be a multiple of 16 * N_MASKS so every pass sees the same masks.
+typedef uint64_t (*mask_kernel_fn)(void *base, size_t n_elem, size_t total);
+
+// AVX2 masks as plain lanes so the baseline-built setup can fill them
+static int32_t vmask32[N_MASKS][8] __attribute__((aligned(32)));
+static int64_t vmask64[N_MASKS][4] __attribute__((aligned(32)));
+#define VMASK(m, k) _mm256_load_si256((const __m256i *)(m)[k])
+static uint16_t kmask32[N_MASKS];
+static uint8_t kmask64[N_MASKS];
+
+#define FOR_EACH_MASKED(lanes)                                   \
+    for (size_t done = 0; done < total; done += n_elem)          \
+        for (size_t i = 0, k = 0; i < n_elem; i += (lanes), k = (k + 1) % N_MASKS)
+
+static ISA_TARGET_AVX2 uint64_t maskload32_y(void *base, size_t n_elem, size_t total) {
+    __m256i acc = _mm256_setzero_si256();
+    FOR_EACH_MASKED(8)
+        acc = _mm256_add_epi32(acc, _mm256_maskload_epi32((const int *)base + i, VMASK(vmask32, k)));
+    return fold256(acc);
+}
+static ISA_TARGET_AVX2 uint64_t maskload64_y(void *base, size_t n_elem, size_t total) {
+    __m256i acc = _mm256_setzero_si256();
+    FOR_EACH_MASKED(4)
+        acc = _mm256_add_epi64(acc, _mm256_maskload_epi64((const long long *)base + i, VMASK(vmask64, k)));
+    return fold256(acc);
+}
+static ISA_TARGET_AVX2 uint64_t maskstore32_y(void *base, size_t n_elem, size_t total) {
+    __m256i v = _mm256_set1_epi32(1);
+    FOR_EACH_MASKED(8)
+        _mm256_maskstore_epi32((int *)base + i, VMASK(vmask32, k), v);
+    return 0;
+}
+static ISA_TARGET_AVX2 uint64_t maskstore64_y(void *base, size_t n_elem, size_t total) {
+    __m256i v = _mm256_set1_epi64x(1);
+    FOR_EACH_MASKED(4)
+        _mm256_maskstore_epi64((long long *)base + i, VMASK(vmask64, k), v);
+    return 0;
+}
+static ISA_TARGET_AVX512 uint64_t maskload32_z(void *base, size_t n_elem, size_t total) {
+    __m512i acc = _mm512_setzero_si512();
+    FOR_EACH_MASKED(16)
+        acc = _mm512_add_epi32(acc, _mm512_maskz_loadu_epi32(kmask32[k], (const int *)base + i));
+    return fold512(acc);
+}
+static ISA_TARGET_AVX512 uint64_t maskload64_z(void *base, size_t n_elem, size_t total) {
+    __m512i acc = _mm512_setzero_si512();
+    FOR_EACH_MASKED(8)
+        acc = _mm512_add_epi64(acc, _mm512_maskz_loadu_epi64(kmask64[k], (const long long *)base + i));
+    return fold512(acc);
+}
+static ISA_TARGET_AVX512 uint64_t maskstore32_z(void *base, size_t n_elem, size_t total) {
+    __m512i v = _mm512_set1_epi32(1);
+    FOR_EACH_MASKED(16)
+        _mm512_mask_storeu_epi32((int *)base + i, kmask32[k], v);
+    return 0;
+}
+static ISA_TARGET_AVX512 uint64_t maskstore64_z(void *base, size_t n_elem, size_t total) {
+    __m512i v = _mm512_set1_epi64(1);
+    FOR_EACH_MASKED(8)
+        _mm512_mask_storeu_epi64((long long *)base + i, kmask64[k], v);
+    return 0;
+}
+
+// scalar baselines: visit only the enabled lanes of each mask
+#define DEFINE_SCALAR_MASKED(name, type, lanes, masks, body)                     \
+static uint64_t name(void *base, size_t n_elem, size_t total) {                  \
+    type *b = base;                                                              \
+    uint64_t acc = 0;                                                            \
+    FOR_EACH_MASKED(lanes) {                                                     \
+        for (unsigned bits = masks[k] & ((1u << (lanes)) - 1); bits; bits &= bits - 1) { \
+            size_t j = i + __builtin_ctz(bits);                                  \
+            body;                                                                \
+        }                                                                        \
+    }                                                                            \
+    return acc;                                                                  \
+}
+DEFINE_SCALAR_MASKED(scalar_mload32_y,  uint32_t, 8,  kmask32, acc += b[j])
+DEFINE_SCALAR_MASKED(scalar_mload64_y,  uint64_t, 4,  kmask64, acc += b[j])
+DEFINE_SCALAR_MASKED(scalar_mstore32_y, uint32_t, 8,  kmask32, b[j] = 1)
+DEFINE_SCALAR_MASKED(scalar_mstore64_y, uint64_t, 4,  kmask64, b[j] = 1)
+DEFINE_SCALAR_MASKED(scalar_mload32_z,  uint32_t, 16, kmask32, acc += b[j])
+DEFINE_SCALAR_MASKED(scalar_mload64_z,  uint64_t, 8,  kmask64, acc += b[j])
+DEFINE_SCALAR_MASKED(scalar_mstore32_z, uint32_t, 16, kmask32, b[j] = 1)
+DEFINE_SCALAR_MASKED(scalar_mstore64_z, uint64_t, 8,  kmask64, b[j] = 1)
+
+typedef struct {
+    const char *op;       // masked_load / masked_store
+    int elem_bits, vec_bits;
+    isa_feature isa;
+    mask_kernel_fn fn, scalar;
+} mask_kernel;
+
+static const mask_kernel mask_catalog[] = {
+    { "masked_load",  32, 256, ISA_AVX2,   maskload32_y,  scalar_mload32_y },
+    { "masked_load",  64, 256, ISA_AVX2,   maskload64_y,  scalar_mload64_y },
+    { "masked_store", 32, 256, ISA_AVX2,   maskstore32_y, scalar_mstore32_y },
+    { "masked_store", 64, 256, ISA_AVX2,   maskstore64_y, scalar_mstore64_y },
+    { "masked_load",  32, 512, ISA_AVX512, maskload32_z,  scalar_mload32_z },
+    { "masked_load",  64, 512, ISA_AVX512, maskload64_z,  scalar_mload64_z },
+    { "masked_store", 32, 512, ISA_AVX512, maskstore32_z, scalar_mstore32_z },
+    { "masked_store", 64, 512, ISA_AVX512, maskstore64_z, scalar_mstore64_z },
+};
+#define N_MASK_CATALOG (int)(sizeof(mask_catalog) / sizeof(mask_catalog[0]))
+
+// the catalog entries this host can run
+static idx_kernel idx_kernels[N_IDX_CATALOG];
+static mask_kernel mask_kernels[N_MASK_CATALOG];
+static int n_idx_kernels, n_mask_kernels;
+
+static void select_kernels(FILE *log) {
+    char name[32];
+    for (int k = 0; k < N_IDX_CATALOG; k++) {
+        const idx_kernel *K = &idx_catalog[k];
+        snprintf(name, sizeof(name), "%s%d/%d", K->op, K->elem_bits, K->vec_bits);
+        if (isa_require(K->isa, name, log)) idx_kernels[n_idx_kernels++] = *K;
+    }
+    for (int k = 0; k < N_MASK_CATALOG; k++) {
+        const mask_kernel *K = &mask_catalog[k];
+        snprintf(name, sizeof(name), "%s%d/%d", K->op, K->elem_bits, K->vec_bits);
+        if (isa_require(K->isa, name, log)) mask_kernels[n_mask_kernels++] = *K;
+    }
+}
+
+// ------------------ Setup ------------------
+static uint64_t rng_state;
+static uint64_t xorshift64(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+enum { PAT_CONTIGUOUS, PAT_SAME_LINE, PAT_SAME_PAGE, PAT_RANDOM, N_PATTERNS };
+static const char *pattern_name[] = { "contiguous", "same_line", "same_page", "random" };
+
+// n_idx indices into n_elem elements of elem_bytes, grouped by `lanes`
+static void fill_indices(uint32_t *idx, size_t n_idx, size_t n_elem, int elem_bytes,
+                         int lanes, int pattern) {
+    size_t per_line = 64 / elem_bytes, per_page = 4096 / elem_bytes;
+    rng_state = 0x9E3779B97F4A7C15ull + pattern * 131 + n_elem;
+    for (size_t v = 0; v < n_idx; v += lanes) {
+        size_t line = (xorshift64() % (n_elem / per_line)) * per_line;
+        size_t page = (xorshift64() % (n_elem / per_page > 0 ? n_elem / per_page : 1)) * per_page;
+        for (int l = 0; l < lanes && v + l < n_idx; l++) {
+            size_t i = v + l;
+            switch (pattern) {
+            case PAT_CONTIGUOUS: idx[i] = (uint32_t)(i % n_elem); break;
+            case PAT_SAME_LINE:  idx[i] = (uint32_t)(line + l % per_line); break;
+            case PAT_SAME_PAGE:  idx[i] = (uint32_t)((page + xorshift64() % per_page) % n_elem); break;
+            default:             idx[i] = (uint32_t)(xorshift64() % n_elem); break;
+            }
+        }
+    }
+}
+
+// random masks with `enabled` of 16 lanes on (AVX2 vectors use the low lanes)
+static void fill_masks(int enabled) {
+    rng_state = 0xC0FFEEull + enabled;
+    for (int k = 0; k < N_MASKS; k++) {
+        int lanes[16];
+        for (int l = 0; l < 16; l++) lanes[l] = l;
+        for (int l = 15; l > 0; l--) {
+            int j = xorshift64() % (l + 1);
+            int t = lanes[l]; lanes[l] = lanes[j]; lanes[j] = t;
+        }
+        uint16_t bits = 0;
+        for (int l = 0; l < enabled; l++) bits |= (uint16_t)(1u << lanes[l]);
+        kmask32[k] = bits;
+        kmask64[k] = (uint8_t)(bits & 0xFF);
+        for (int l = 0; l < 8; l++) vmask32[k][l] = (bits >> l) & 1 ? -1 : 0;
+        for (int l = 0; l < 4; l++) vmask64[k][l] = (bits >> l) & 1 ? -1 : 0;
+    }
+}
+
+// ------------------ Measurement ------------------
+static double cycles_of(uint64_t (*run)(void *ctx), void *ctx) {
+    double s[TRIALS];
+    sink += run(ctx); // warm up
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t c0 = pmu_read(&cycles_ctr);
+        uint64_t start = rdtsc_begin();
+        sink += run(ctx);
+        uint64_t end = rdtsc_end();
+        s[t] = pmu_ok(&cycles_ctr) ? (double)(pmu_read(&cycles_ctr) - c0) : (double)(end - start);
+    }
+    return median(s, TRIALS);
+}
+
+typedef struct {
+    idx_kernel_fn ifn;
+    mask_kernel_fn mfn;
+    void *base;
+    const uint32_t *idx;
+    size_t n, total;
+    // index kernels: each pass of idx[0..n) starts `off` elements into
+    // base, advancing by n and wrapping at span (span == n: fixed window)
+    size_t span, off;
+    int elem_bytes;
+} run_ctx;
+
+static uint64_t run_idx(void *p) {
+    run_ctx *c = p;
+    if (c->span == c->n) return c->ifn(c->base, c->idx, c->n, c->total);
+    uint64_t s = 0;
+    for (size_t done = 0; done < c->total; done += c->n) {
+        s += c->ifn((uint8_t *)c->base + c->off * c->elem_bytes, c->idx, c->n, c->n);
+        c->off = (c->off + c->n) % c->span;
+    }
+    return s;
+}
+static uint64_t run_mask(void *p) {
+    run_ctx *c = p;
+    return c->mfn(c->base, c->n, c->total);
+}
+
+static size_t round_total(size_t n) {
+    return (TOTAL_ELEMS + n - 1) / n * n;
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    static const char *level_name[] = { "L1", "L2", "LLC", "DRAM" };
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE), l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l1 <= 0) l1 = 32 << 10;
+    if (l2 <= 0) l2 = 1 << 20;
+    if (l3 <= 0) l3 = 8 << 20;
+    size_t dram = 4 * (size_t)l3;
+    if (dram < (64u << 20)) dram = 64u << 20;
+    if (dram > (1u << 30)) dram = 1u << 30;
+    // the index stream shares the cache with the data, so stay well inside each level
+    size_t ws[4] = { (size_t)l1 / 4, (size_t)l2 / 2, (size_t)l3 / 2, dram };
+
+    uint8_t *data = aligned_alloc(4096, ws[3]);
+    uint32_t *idx = aligned_alloc(64, MAX_IDX * sizeof(uint32_t) + 64);
+    if (!data || !idx) {
+        fprintf(stderr, "Allocation failed\n");
+        return 1;
+    }
+    memset(data, 1, ws[3]);
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("gather_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening gather_results.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_gather.txt", "w");
+    if (!log_fp) log_fp = stdout;
+    if (pmu_open(&cycles_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES))
+        printf("cycles counter unavailable, reporting TSC ticks\n");
+    select_kernels(log_fp);
+    fprintf(fp, "op,pattern,level,ws_bytes,elem_bits,vec_bits,mask_density,"
+                "vec_elems_per_cycle,scalar_elems_per_cycle,speedup\n");
+
+    // --- Gather / scatter ---
+    fprintf(log_fp, "=== Gather / Scatter speedup over scalar (elements per cycle ratio) ===\n");
+    fprintf(log_fp, "| %-10s | %-5s |", "Pattern", "Level");
+    for (int k = 0; k < n_idx_kernels; k++)
+        fprintf(log_fp, " %s%d/%d |", idx_kernels[k].op[0] == 'g' ? "g" : "s",
+                idx_kernels[k].elem_bits, idx_kernels[k].vec_bits);
+    fprintf(log_fp, "\n|------------|-------|");
+    for (int k = 0; k < n_idx_kernels; k++) fprintf(log_fp, "---------|");
+    fprintf(log_fp, "\n");
+
+    for (int p = 0; p < N_PATTERNS; p++) {
+        for (int lv = 0; lv < 4; lv++) {
+            fprintf(log_fp, "| %-10s | %-5s |", pattern_name[p], level_name[lv]);
+            for (int k = 0; k < n_idx_kernels; k++) {
+                const idx_kernel *K = &idx_kernels[k];
+                int eb = K->elem_bits / 8, lanes = K->vec_bits / K->elem_bits;
+                size_t n_elem = ws[lv] / eb;
+                size_t n_idx = n_elem < MAX_IDX ? n_elem : MAX_IDX;
+                n_idx -= n_idx % 16;
+                fill_indices(idx, n_idx, n_elem, eb, lanes, p);
+                // the other patterns already spread idx over the whole working set
+                size_t span = p == PAT_CONTIGUOUS ? n_elem - n_elem % n_idx : n_idx;
+                size_t touched = p == PAT_CONTIGUOUS ? span * eb : ws[lv];
+
+                run_ctx c = { K->fn, NULL, data, idx, n_idx, round_total(n_idx), span, 0, eb };
+                double vec = c.total / cycles_of(run_idx, &c);
+                c.ifn = K->scalar;
+                double sc = c.total / cycles_of(run_idx, &c);
+                fprintf(fp, "%s,%s,%s,%zu,%d,%d,1.0,%.4f,%.4f,%.3f\n", K->op, pattern_name[p],
+                        level_name[lv], touched, K->elem_bits, K->vec_bits, vec, sc, vec / sc);
+                fprintf(log_fp, " %*.2f |", (int)strlen("g32/128"), vec / sc);
+            }
+            fprintf(log_fp, "\n");
+        }
+    }
+
+    // --- Masked loads / stores (contiguous) ---
+    static const int enabled_lanes[] = { 2, 4, 8, 12, 16 };   // of 16
+    fprintf(log_fp, "\n=== Masked load / store speedup over scalar (enabled elements) ===\n");
+    fprintf(log_fp, "| %-7s | %-5s |", "Density", "Level");
+    for (int k = 0; k < n_mask_kernels; k++)
+        fprintf(log_fp, " %s%d/%d |", mask_kernels[k].op[7] == 'l' ? "ld" : "st",
+                mask_kernels[k].elem_bits, mask_kernels[k].vec_bits);
+    fprintf(log_fp, "\n|---------|-------|");
+    for (int k = 0; k < n_mask_kernels; k++) fprintf(log_fp, "----------|");
+    fprintf(log_fp, "\n");
+
+    for (unsigned d = 0; d < sizeof(enabled_lanes) / sizeof(enabled_lanes[0]); d++) {
+        double density = enabled_lanes[d] / 16.0;
+        fill_masks(enabled_lanes[d]);
+        for (int lv = 0; lv < 4; lv++) {
+            fprintf(log_fp, "| %-7.3f | %-5s |", density, level_name[lv]);
+            for (int k = 0; k < n_mask_kernels; k++) {
+                const mask_kernel *K = &mask_kernels[k];
+                int lanes = K->vec_bits / K->elem_bits;
+                size_t n_elem = ws[lv] / (K->elem_bits / 8);
+                n_elem -= n_elem % (16 * N_MASKS);
+                double active = 0.0;   // enabled elements per pass
+                for (int m = 0; m < N_MASKS; m++)
+                    active += __builtin_popcount((K->elem_bits == 32 ? kmask32[m] : kmask64[m]) &
+                                                 ((1u << lanes) - 1));
+                active *= (double)n_elem / lanes / N_MASKS;
+
+                run_ctx c = { NULL, K->fn, data, NULL, n_elem, round_total(n_elem) };
+                double passes = (double)c.total / n_elem;
+                double vec = passes * active / cycles_of(run_mask, &c);
+                c.mfn = K->scalar;
+                double sc = passes * active / cycles_of(run_mask, &c);
+                double speedup = sc > 0.0 ? vec / sc : 0.0;
+                fprintf(fp, "%s,contiguous,%s,%zu,%d,%d,%.3f,%.4f,%.4f,%.3f\n", K->op,
+                        level_name[lv], ws[lv], K->elem_bits, K->vec_bits, density, vec, sc,
+                        speedup);
+                fprintf(log_fp, " %*.2f |", (int)strlen("ld32/256"), speedup);
+            }
+            fprintf(log_fp, "\n");
+        }
+    }
+
+    pmu_close(&cycles_ctr);
+    fclose(fp);
+    preflight_save(&pf, "gather_results.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    free(data);
+    free(idx);
+    printf("All results written to results_gather.txt and gather_results.csv\n");
+    return 0;
+}
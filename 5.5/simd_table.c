@@ -0,0 +1,275 @@
+// simd_table.c
+// ===============================================================
+// Compile: ./compile.sh              (UNROLL defaults to 48)
+//          gcc ... -DUNROLL=96 ...   (any multiple of 12)
+// Run:     taskset -c 0 ./simd_table
+//
+// Latency / reciprocal-throughput / uops table for a catalog of SSE,
+// AVX, AVX2, FMA and AVX-512 instructions (integer, FP, shuffle, blend,
+// convert, compare, mask ops). Every catalog entry is one GAS template
+// with three register slots: \d (written), \a (chained source) and \b
+// (second source). Two kernels are generated per entry:
+//   latency:    UNROLL copies of  op d=0, a=0, b=14      (one chain)
+//   throughput: UNROLL/12 x { op d=i, a=13, b=14 | i = 1..12 }
+// Mask-register entries use k1..k7 instead. Entries that write a
+// different register file than they read (compare -> k) only get the
+// throughput kernel. Entries the host lacks are listed as skipped.
+//
+// Cycles are core cycles and uops come from UOPS_ISSUED.ANY when perf
+// exposes them; otherwise cycles are TSC ticks and uops are blank.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "isa.h"
+#include "preflight.h"
+
+#ifndef UNROLL
+#define UNROLL 48
+#endif
+#if UNROLL % 12
+#error "UNROLL must be a multiple of 12"
+#endif
+
+#define STR(x)  #x
+#define XSTR(x) STR(x)
+
+#define ITERS   200000
+#define TRIALS  5
+
+typedef void (*simd_kernel_fn)(const float *init, long iters);
+
+// ------------------ Register Setup / Clobbers ------------------
+// every vector register starts at 1.0f so FP chains never go denormal
+#define INIT_XMM ".irp r,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15\n\tmovups (%[init]), %%xmm\\r\n\t.endr\n\t"
+#define INIT_YMM ".irp r,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15\n\tvmovups (%[init]), %%ymm\\r\n\t.endr\n\t"
+#define INIT_ZMM ".irp r,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15\n\tvmovups (%[init]), %%zmm\\r\n\t.endr\n\t" \
+                 ".irp r,1,2,3,4,5,6,7\n\tkxnorw %%k0, %%k0, %%k\\r\n\t.endr\n\t"
+#define FINI_XMM ""
+#define FINI_YMM "vzeroupper\n\t"
+#define FINI_ZMM "vzeroupper\n\t"
+
+#define VEC_CLOBBERS "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",          \
+                     "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",  \
+                     "cc", "memory"
+#define CLOBBERS_XMM VEC_CLOBBERS
+#define CLOBBERS_YMM VEC_CLOBBERS
+#define CLOBBERS_ZMM VEC_CLOBBERS, "k1", "k2", "k3", "k4", "k5", "k6", "k7"
+
+// kernels are built per register width, whatever -march says; zmm ones
+// need the AVX-512 target for the k-register clobbers
+#define TARGET_XMM
+#define TARGET_YMM ISA_TARGET_AVX
+#define TARGET_ZMM ISA_TARGET_AVX512
+
+// ------------------ Kernel Bodies ------------------
+// register slots per kind: VEC (vector in, vector out), MASK (k in, k out),
+// TOMASK (vector in, k out: no latency chain)
+#define LAT_VEC    "op 0, 0, 14\n\t"
+#define LAT_MASK   "op 1, 1, 7\n\t"
+#define LAT_TOMASK ""
+#define TP_VEC    ".irp i,1,2,3,4,5,6,7,8,9,10,11,12\n\top \\i, 13, 14\n\t.endr\n\t"
+#define TP_MASK   ".irp i,1,2,3,4,5,6,1,2,3,4,5,6\n\top \\i, 7, 7\n\t.endr\n\t"
+#define TP_TOMASK ".irp i,1,2,3,4,5,6,1,2,3,4,5,6\n\top \\i, 13, 14\n\t.endr\n\t"
+#define HAS_LAT_VEC    1
+#define HAS_LAT_MASK   1
+#define HAS_LAT_TOMASK 0
+
+#define DEFINE_SIMD_KERNELS(name, isa, width, kind, insn)                    \
+static TARGET_##width void lat_##name(const float *init, long iters) {      \
+    __asm__ volatile(INIT_##width                                            \
+                     ".macro op d, a, b\n\t" insn "\n\t.endm\n\t"            \
+                     "1:\n\t"                                                \
+                     ".rept " XSTR(UNROLL) "\n\t"                            \
+                     LAT_##kind                                              \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     ".purgem op\n\t"                                        \
+                     FINI_##width                                            \
+                     : [n] "+r"(iters) : [init] "r"(init) : CLOBBERS_##width); \
+}                                                                            \
+static TARGET_##width void tp_##name(const float *init, long iters) {       \
+    __asm__ volatile(INIT_##width                                            \
+                     ".macro op d, a, b\n\t" insn "\n\t.endm\n\t"            \
+                     "1:\n\t"                                                \
+                     ".rept " XSTR(UNROLL) "/12\n\t"                         \
+                     TP_##kind                                               \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     ".purgem op\n\t"                                        \
+                     FINI_##width                                            \
+                     : [n] "+r"(iters) : [init] "r"(init) : CLOBBERS_##width); \
+}
+
+// ------------------ Instruction Catalog ------------------
+// X(name, isa for entry_supported(), register width, kind, template)
+#define SIMD_CATALOG(X)                                                                        \
+    /* SSE */                                                                                  \
+    X(paddd,        "sse2",     XMM, VEC,    "paddd %%xmm\\b, %%xmm\\d")                       \
+    X(pmulld,       "sse4.1",   XMM, VEC,    "pmulld %%xmm\\b, %%xmm\\d")                      \
+    X(addps,        "sse",      XMM, VEC,    "addps %%xmm\\b, %%xmm\\d")                       \
+    X(mulps,        "sse",      XMM, VEC,    "mulps %%xmm\\b, %%xmm\\d")                       \
+    X(divps,        "sse",      XMM, VEC,    "divps %%xmm\\b, %%xmm\\d")                       \
+    X(sqrtps,       "sse",      XMM, VEC,    "sqrtps %%xmm\\a, %%xmm\\d")                      \
+    X(pshufb,       "ssse3",    XMM, VEC,    "pshufb %%xmm\\b, %%xmm\\d")                      \
+    X(shufps,       "sse",      XMM, VEC,    "shufps $0x1b, %%xmm\\b, %%xmm\\d")               \
+    X(blendps,      "sse4.1",   XMM, VEC,    "blendps $5, %%xmm\\b, %%xmm\\d")                 \
+    X(cvtdq2ps,     "sse2",     XMM, VEC,    "cvtdq2ps %%xmm\\a, %%xmm\\d")                    \
+    X(pcmpgtd,      "sse2",     XMM, VEC,    "pcmpgtd %%xmm\\b, %%xmm\\d")                     \
+    /* AVX / AVX2 / FMA, 256-bit */                                                            \
+    X(vpaddd_y,     "avx2",     YMM, VEC,    "vpaddd %%ymm\\b, %%ymm\\a, %%ymm\\d")            \
+    X(vpmulld_y,    "avx2",     YMM, VEC,    "vpmulld %%ymm\\b, %%ymm\\a, %%ymm\\d")           \
+    X(vpmaddwd_y,   "avx2",     YMM, VEC,    "vpmaddwd %%ymm\\b, %%ymm\\a, %%ymm\\d")          \
+    X(vpsllvd_y,    "avx2",     YMM, VEC,    "vpsllvd %%ymm\\b, %%ymm\\a, %%ymm\\d")           \
+    X(vaddps_y,     "avx",      YMM, VEC,    "vaddps %%ymm\\b, %%ymm\\a, %%ymm\\d")            \
+    X(vmulps_y,     "avx",      YMM, VEC,    "vmulps %%ymm\\b, %%ymm\\a, %%ymm\\d")            \
+    X(vfmadd231ps_y,"fma",      YMM, VEC,    "vfmadd231ps %%ymm\\b, %%ymm\\a, %%ymm\\d")       \
+    X(vdivps_y,     "avx",      YMM, VEC,    "vdivps %%ymm\\b, %%ymm\\a, %%ymm\\d")            \
+    X(vsqrtps_y,    "avx",      YMM, VEC,    "vsqrtps %%ymm\\a, %%ymm\\d")                     \
+    X(vpshufb_y,    "avx2",     YMM, VEC,    "vpshufb %%ymm\\b, %%ymm\\a, %%ymm\\d")           \
+    X(vpermd_y,     "avx2",     YMM, VEC,    "vpermd %%ymm\\a, %%ymm\\b, %%ymm\\d")            \
+    X(vperm2i128_y, "avx2",     YMM, VEC,    "vperm2i128 $0x21, %%ymm\\b, %%ymm\\a, %%ymm\\d") \
+    X(vpunpcklbw_y, "avx2",     YMM, VEC,    "vpunpcklbw %%ymm\\b, %%ymm\\a, %%ymm\\d")        \
+    X(vpblendd_y,   "avx2",     YMM, VEC,    "vpblendd $0xaa, %%ymm\\b, %%ymm\\a, %%ymm\\d")   \
+    X(vpblendvb_y,  "avx2",     YMM, VEC,    "vpblendvb %%ymm\\b, %%ymm\\b, %%ymm\\a, %%ymm\\d") \
+    X(vblendvps_y,  "avx",      YMM, VEC,    "vblendvps %%ymm\\b, %%ymm\\b, %%ymm\\a, %%ymm\\d") \
+    X(vcvtdq2ps_y,  "avx",      YMM, VEC,    "vcvtdq2ps %%ymm\\a, %%ymm\\d")                   \
+    X(vcvttps2dq_y, "avx",      YMM, VEC,    "vcvttps2dq %%ymm\\a, %%ymm\\d")                  \
+    X(vcvtps2pd_y,  "avx",      YMM, VEC,    "vcvtps2pd %%xmm\\a, %%ymm\\d")                   \
+    X(vpcmpgtd_y,   "avx2",     YMM, VEC,    "vpcmpgtd %%ymm\\b, %%ymm\\a, %%ymm\\d")          \
+    X(vcmpps_y,     "avx",      YMM, VEC,    "vcmpltps %%ymm\\b, %%ymm\\a, %%ymm\\d")          \
+    /* AVX-512, 512-bit */                                                                     \
+    X(vpaddd_z,     "avx512f",  ZMM, VEC,    "vpaddd %%zmm\\b, %%zmm\\a, %%zmm\\d")            \
+    X(vpmulld_z,    "avx512f",  ZMM, VEC,    "vpmulld %%zmm\\b, %%zmm\\a, %%zmm\\d")           \
+    X(vaddps_z,     "avx512f",  ZMM, VEC,    "vaddps %%zmm\\b, %%zmm\\a, %%zmm\\d")            \
+    X(vfmadd231ps_z,"avx512f",  ZMM, VEC,    "vfmadd231ps %%zmm\\b, %%zmm\\a, %%zmm\\d")       \
+    X(vdivps_z,     "avx512f",  ZMM, VEC,    "vdivps %%zmm\\b, %%zmm\\a, %%zmm\\d")            \
+    X(vpternlogd_z, "avx512f",  ZMM, VEC,    "vpternlogd $0x96, %%zmm\\b, %%zmm\\a, %%zmm\\d") \
+    X(vpermd_z,     "avx512f",  ZMM, VEC,    "vpermd %%zmm\\a, %%zmm\\b, %%zmm\\d")            \
+    X(vpermt2d_z,   "avx512f",  ZMM, VEC,    "vpermt2d %%zmm\\b, %%zmm\\a, %%zmm\\d")          \
+    X(vpshufb_z,    "avx512bw", ZMM, VEC,    "vpshufb %%zmm\\b, %%zmm\\a, %%zmm\\d")           \
+    X(vpblendmd_z,  "avx512f",  ZMM, VEC,    "vpblendmd %%zmm\\b, %%zmm\\a, %%zmm\\d%{%%k1%}") \
+    X(vcvtdq2ps_z,  "avx512f",  ZMM, VEC,    "vcvtdq2ps %%zmm\\a, %%zmm\\d")                   \
+    X(vpcmpd_z,     "avx512f",  ZMM, TOMASK, "vpcmpd $1, %%zmm\\b, %%zmm\\a, %%k\\d")          \
+    X(vcmpps_z,     "avx512f",  ZMM, TOMASK, "vcmpltps %%zmm\\b, %%zmm\\a, %%k\\d")            \
+    /* AVX-512 mask ops */                                                                     \
+    X(kandw,        "avx512f",  ZMM, MASK,   "kandw %%k\\b, %%k\\a, %%k\\d")                   \
+    X(korw,         "avx512f",  ZMM, MASK,   "korw %%k\\b, %%k\\a, %%k\\d")                    \
+    X(knotw,        "avx512f",  ZMM, MASK,   "knotw %%k\\a, %%k\\d")                           \
+    X(kshiftlw,     "avx512f",  ZMM, MASK,   "kshiftlw $1, %%k\\a, %%k\\d")                    \
+    X(kaddw,        "avx512dq", ZMM, MASK,   "kaddw %%k\\b, %%k\\a, %%k\\d")
+
+SIMD_CATALOG(DEFINE_SIMD_KERNELS)
+
+typedef struct {
+    const char *name;
+    const char *isa;
+    const char *width;
+    int has_latency;
+    simd_kernel_fn lat, tp;
+} simd_entry;
+
+#define CATALOG_ENTRY(name, isa, width, kind, insn) \
+    { #name, isa, #width, HAS_LAT_##kind, lat_##name, tp_##name },
+static const simd_entry catalog[] = { SIMD_CATALOG(CATALOG_ENTRY) };
+#define N_ENTRIES (int)(sizeof(catalog) / sizeof(catalog[0]))
+
+// ------------------ ISA Check ------------------
+// the tiers in isa.h bundle extensions (avx2 takes FMA and BMI, avx512
+// takes F/CD/BW/DQ/VL), so each entry checks its own CPUID bit instead
+static int entry_supported(const char *isa) {
+    return isa_has(isa);
+}
+
+// ------------------ Measurement ------------------
+static pmu_counter cycles_ctr = { -1 }, uops_ctr = { -1 };
+static float init_vals[16] __attribute__((aligned(64)));
+
+typedef struct {
+    double cycles;   // per instruction
+    double uops;     // per instruction, -1 without PMU
+} simd_sample;
+
+static simd_sample run_kernel(simd_kernel_fn fn, int insns_per_iter) {
+    double cyc[TRIALS], uops[TRIALS];
+    fn(init_vals, ITERS / 10); // warm up (and let the vector unit power up)
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t c0 = pmu_read(&cycles_ctr), u0 = pmu_read(&uops_ctr);
+        uint64_t start = rdtsc_begin();
+        fn(init_vals, ITERS);
+        uint64_t end = rdtsc_end();
+        uint64_t c = pmu_ok(&cycles_ctr) ? pmu_read(&cycles_ctr) - c0 : end - start;
+        uint64_t u = pmu_read(&uops_ctr) - u0;
+        cyc[t] = (double)c / ((double)ITERS * insns_per_iter);
+        // one fused dec/jnz uop per iteration is loop overhead
+        uops[t] = ((double)u - ITERS) / ((double)ITERS * insns_per_iter);
+    }
+    simd_sample s = { median(cyc, TRIALS), pmu_ok(&uops_ctr) ? median(uops, TRIALS) : -1.0 };
+    return s;
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    for (int i = 0; i < 16; i++) init_vals[i] = 1.0f;
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("simd_table.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening simd_table.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_simd.txt", "w");
+    if (!log_fp) log_fp = stdout;
+
+    if (pmu_open(&cycles_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES))
+        printf("cycles counter unavailable, reporting TSC ticks\n");
+    if (pmu_open_raw(&uops_ctr, 0x010E)) // UOPS_ISSUED.ANY
+        printf("UOPS_ISSUED.ANY unavailable, uops column left blank\n");
+
+    const char *clock = pmu_ok(&cycles_ctr) ? "core" : "tsc";
+    fprintf(fp, "instruction,isa,width,latency,recip_throughput,uops,unroll,clock,status\n");
+    fprintf(log_fp, "=== SIMD Instruction Table (UNROLL=%d, %s cycles) ===\n", UNROLL, clock);
+    fprintf(log_fp, "| %-14s | %-8s | %-5s | %-8s | %-12s | %-6s |\n",
+            "Instruction", "ISA", "Width", "Latency", "Recip. Thru.", "Uops");
+    fprintf(log_fp, "|----------------|----------|-------|----------|--------------|--------|\n");
+
+    for (int i = 0; i < N_ENTRIES; i++) {
+        const simd_entry *e = &catalog[i];
+        if (!entry_supported(e->isa)) {
+            fprintf(fp, "%s,%s,%s,,,,%d,%s,skipped\n", e->name, e->isa, e->width, UNROLL, clock);
+            fprintf(log_fp, "| %-14s | %-8s | %-5s | %-8s | %-12s | %-6s |\n",
+                    e->name, e->isa, e->width, "skipped", "-", "-");
+            continue;
+        }
+        simd_sample lat = { -1.0, -1.0 };
+        if (e->has_latency) lat = run_kernel(e->lat, UNROLL);
+        simd_sample tp = run_kernel(e->tp, UNROLL);
+
+        char lat_s[16] = "-", uops_s[16] = "-";
+        if (lat.cycles >= 0.0) snprintf(lat_s, sizeof(lat_s), "%.2f", lat.cycles);
+        if (tp.uops >= 0.0) snprintf(uops_s, sizeof(uops_s), "%.2f", tp.uops);
+        fprintf(fp, "%s,%s,%s,%s,%.3f,%s,%d,%s,ok\n", e->name, e->isa, e->width,
+                lat.cycles >= 0.0 ? lat_s : "", tp.cycles, tp.uops >= 0.0 ? uops_s : "",
+                UNROLL, clock);
+        fprintf(log_fp, "| %-14s | %-8s | %-5s | %-8s | %-12.3f | %-6s |\n",
+                e->name, e->isa, e->width, lat_s, tp.cycles, uops_s);
+    }
+
+    pmu_close(&cycles_ctr);
+    pmu_close(&uops_ctr);
+    fclose(fp);
+    preflight_save(&pf, "simd_table.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    printf("All results written to results_simd.txt and simd_table.csv\n");
+    return 0;
+}
@@ -0,0 +1,397 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+#include <x86intrin.h>
+#include <time.h>
+#include "amx_gemm.h"
+#include "amx_emu.h"
+#include "isa.h"
+#include "topology.h"
+#include "preflight.h"
+#include "isolate.h"
+#include "rapl.h"
+
+#define REPETITIONS 1000
+#define VALIDATE_TILES 64  // random tile triples per tdp form
+#define ENERGY_SEC  0.2    // per point, only with RAPL: one timed sequence is far below its resolution
+
+// One tile-sized problem per type: A is M x K, B is K x N in VNNI rows
+// (K/4 int8 or K/2 bf16 rows of 64 bytes), C is M x N dwords; every
+// tile is 16 rows x 64 bytes.
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K_INT8 64
+#define TILE_K_BF16 32
+
+// Native AMX runs when amx_init() succeeds. The same sequence always runs
+// on the software model too: on AMX hosts its C must match bit for bit,
+// elsewhere it is the only path, and its cycles give the emulation cost.
+typedef struct {
+    uint64_t native;   // 0 when AMX is unavailable
+    uint64_t emu;
+    int      exact;    // -1 when there is no native result to compare
+    // package energy of the native path (emulator without AMX), ENERGY_SEC of back-to-back sequences
+    int      energy_ok;
+    double   joules, watts, ops_per_joule;
+} amx_result;
+
+static int amx_native;
+static rapl rp;
+static int rapl_ok;
+
+// ------------------------
+// Helpers
+// ------------------------
+static void fill_int8(int8_t *B, int R, int C, float zf) {
+    for(int i=0;i<R*C;i++)
+        B[i] = ((rand()/(float)RAND_MAX) < zf) ? 0 : (rand()%127+1);
+}
+
+static void fill_bf16(uint16_t *B, int R, int C, float zf) {
+    for(int i=0;i<R*C;i++){
+        if((rand()/(float)RAND_MAX) < zf){
+            B[i]=0;
+        } else {
+            float v = (rand()/(float)RAND_MAX)*2.0f-1.0f;
+            uint32_t bits;
+            memcpy(&bits,&v,sizeof bits);
+            B[i] = (uint16_t)(bits>>16);
+        }
+    }
+}
+
+// ------------------------
+// Measure functions
+// ------------------------
+static void fill_cfg(amx_tilecfg *cfg, int k_rows) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->palette_id = 1;
+    cfg->rows[0] = TILE_M; cfg->colsb[0] = 64;   // A
+    cfg->rows[1] = k_rows; cfg->colsb[1] = 64;   // B
+    cfg->rows[2] = TILE_M; cfg->colsb[2] = 64;   // C
+}
+
+#define NATIVE_SEQ(TDP, A, B, C)                   \
+    do {                                           \
+        _tile_zero(2);                             \
+        _tile_loadd(0, A, 64);                     \
+        _tile_loadd(1, B, 64);                     \
+        TDP(2, 0, 1);                              \
+        _tile_stored(2, C, 64);                    \
+    } while (0)
+
+#define EMU_SEQ(EMU_TDP, e, A, B, C)               \
+    do {                                           \
+        amx_emu_zero(e, 2);                        \
+        amx_emu_loadd(e, 0, A, 64);                \
+        amx_emu_loadd(e, 1, B, 64);                \
+        EMU_TDP(e, 2, 0, 1);                       \
+        amx_emu_stored(e, 2, C, 64);               \
+    } while (0)
+
+#define TIME_SEQ(sum, SEQ)                         \
+    do {                                           \
+        unsigned int aux;                          \
+        sum = 0;                                   \
+        for (int i = 0; i < REPETITIONS; i++) {    \
+            uint64_t s = __rdtscp(&aux);           \
+            SEQ;                                   \
+            uint64_t e = __rdtscp(&aux);           \
+            sum += e - s;                          \
+        }                                          \
+        sum /= REPETITIONS;                        \
+    } while (0)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// repeats CALL (REPETITIONS sequences of ops_per_seq ops) for ENERGY_SEC under RAPL
+#define ENERGY_LOOP(r, ops_per_seq, CALL)                                          \
+    do {                                                                           \
+        if (!rapl_ok) break;                                                       \
+        rapl_mark m_;                                                              \
+        rapl_energy e_;                                                            \
+        long calls_ = 0;                                                           \
+        rapl_begin(&rp, &m_);                                                      \
+        double t0_ = now_sec();                                                    \
+        do { CALL; calls_++; } while (now_sec() - t0_ < ENERGY_SEC);               \
+        rapl_end(&rp, &m_, &e_);                                                   \
+        if (!e_.valid[RAPL_PKG] || e_.joules[RAPL_PKG] <= 0.0) break;              \
+        (r).energy_ok = 1;                                                         \
+        (r).joules = e_.joules[RAPL_PKG];                                          \
+        (r).watts = e_.watts[RAPL_PKG];                                            \
+        (r).ops_per_joule = (double)calls_ * REPETITIONS * (ops_per_seq) / (r).joules; \
+    } while (0)
+
+// built for AMX regardless of -march; only called when amx_native
+#define DEFINE_NATIVE(name, TDP)                                            \
+static ISA_TARGET_AMX uint64_t name(const amx_tilecfg *cfg, const void *A,  \
+                                    const void *B, void *C) {               \
+    uint64_t sum;                                                           \
+    __asm__ volatile("" ::: "memory");   /* cfg stores ahead of ldtilecfg */ \
+    _tile_loadconfig(cfg);                                                  \
+    TIME_SEQ(sum, NATIVE_SEQ(TDP, A, B, C));                                \
+    _tile_release();                                                        \
+    return sum;                                                             \
+}
+DEFINE_NATIVE(native_int8, _tile_dpbssd)
+DEFINE_NATIVE(native_bf16, _tile_dpbf16ps)
+
+static amx_result measure_int8(float zf){
+    int M = TILE_M, N = TILE_N, K = TILE_K_INT8;
+    int8_t  *A=aligned_alloc(64,M*K);
+    int8_t  *B=aligned_alloc(64,K*N);
+    int32_t *C=aligned_alloc(64,M*N*sizeof(int32_t));
+    int32_t *Ce=aligned_alloc(64,M*N*sizeof(int32_t));
+    fill_int8(A,M,K,zf);
+    fill_int8(B,K,N,zf);
+    memset(C,0,M*N*sizeof(int32_t));
+
+    static amx_tilecfg cfg __attribute__((aligned(64)));
+    fill_cfg(&cfg, K/4);
+    amx_result r = { 0, 0, -1 };
+    if (amx_native) r.native = native_int8(&cfg, A, B, C);
+    static amx_emu emu;
+    amx_emu_loadconfig(&emu, &cfg);
+    TIME_SEQ(r.emu, EMU_SEQ(amx_emu_dpbssd, &emu, A, B, Ce));
+    double ops = 2.0 * M * N * K;
+    if (amx_native) ENERGY_LOOP(r, ops, native_int8(&cfg, A, B, C));
+    else ENERGY_LOOP(r, ops, { uint64_t t; TIME_SEQ(t, EMU_SEQ(amx_emu_dpbssd, &emu, A, B, Ce)); });
+    amx_emu_release(&emu);
+    if (amx_native) r.exact = memcmp(C, Ce, M*N*sizeof(int32_t)) == 0;
+    free(A); free(B); free(C); free(Ce);
+    return r;
+}
+
+static amx_result measure_bf16(float zf){
+    int M = TILE_M, N = TILE_N, K = TILE_K_BF16;
+    uint16_t *A=aligned_alloc(64,M*K*sizeof(uint16_t));
+    uint16_t *B=aligned_alloc(64,K*N*sizeof(uint16_t));
+    float    *C=aligned_alloc(64,M*N*sizeof(float));
+    float    *Ce=aligned_alloc(64,M*N*sizeof(float));
+    fill_bf16(A,M,K,zf);
+    fill_bf16(B,K,N,zf);
+    memset(C,0,M*N*sizeof(float));
+
+    static amx_tilecfg cfg __attribute__((aligned(64)));
+    fill_cfg(&cfg, K/2);
+    amx_result r = { 0, 0, -1 };
+    if (amx_native) r.native = native_bf16(&cfg, A, B, C);
+    static amx_emu emu;
+    amx_emu_loadconfig(&emu, &cfg);
+    TIME_SEQ(r.emu, EMU_SEQ(amx_emu_dpbf16ps, &emu, A, B, Ce));
+    double ops = 2.0 * M * N * K;
+    if (amx_native) ENERGY_LOOP(r, ops, native_bf16(&cfg, A, B, C));
+    else ENERGY_LOOP(r, ops, { uint64_t t; TIME_SEQ(t, EMU_SEQ(amx_emu_dpbf16ps, &emu, A, B, Ce)); });
+    amx_emu_release(&emu);
+    if (amx_native) r.exact = memcmp(C, Ce, M*N*sizeof(float)) == 0;
+    free(A); free(B); free(C); free(Ce);
+    return r;
+}
+
+// ------------------------
+// Validation: every tdp form, native vs emulator
+// ------------------------
+// One tdp onto a loaded (not zeroed) accumulator, so C's own specials
+// and the integer wrap take part too.
+#define DEFINE_NATIVE_ONCE(name, TDP)                                       \
+static ISA_TARGET_AMX void name(const amx_tilecfg *cfg, const void *A,      \
+                                const void *B, void *C) {                   \
+    __asm__ volatile("" ::: "memory");                                      \
+    _tile_loadconfig(cfg);                                                  \
+    _tile_loadd(2, C, 64);                                                  \
+    _tile_loadd(0, A, 64);                                                  \
+    _tile_loadd(1, B, 64);                                                  \
+    TDP(2, 0, 1);                                                           \
+    _tile_stored(2, C, 64);                                                 \
+    _tile_release();                                                        \
+}
+DEFINE_NATIVE_ONCE(once_dpbssd, _tile_dpbssd)
+DEFINE_NATIVE_ONCE(once_dpbsud, _tile_dpbsud)
+DEFINE_NATIVE_ONCE(once_dpbusd, _tile_dpbusd)
+DEFINE_NATIVE_ONCE(once_dpbuud, _tile_dpbuud)
+DEFINE_NATIVE_ONCE(once_dpbf16ps, _tile_dpbf16ps)
+
+static const struct {
+    const char *name;
+    int bf16;
+    void (*native)(const amx_tilecfg *, const void *, const void *, void *);
+    int (*emu)(amx_emu *, int, int, int);
+} tdp_forms[] = {
+    { "tdpbssd",   0, once_dpbssd,   amx_emu_dpbssd },
+    { "tdpbsud",   0, once_dpbsud,   amx_emu_dpbsud },
+    { "tdpbusd",   0, once_dpbusd,   amx_emu_dpbusd },
+    { "tdpbuud",   0, once_dpbuud,   amx_emu_dpbuud },
+    { "tdpbf16ps", 1, once_dpbf16ps, amx_emu_dpbf16ps },
+};
+#define N_TDP_FORMS (int)(sizeof(tdp_forms) / sizeof(tdp_forms[0]))
+
+static uint32_t rand32(void) {
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+// bf16 operands: +-0, +-Inf, quiet and signalling NaNs with payloads,
+// denormals, and extremes whose products overflow or underflow
+static const uint16_t bf16_specials[] = {
+    0x0000, 0x8000, 0x7F80, 0xFF80, 0x7FC0, 0xFFC1, 0x7F81, 0xFF85,
+    0x0001, 0x807F, 0x0040, 0x7F7F, 0xFF7F, 0x0080, 0x8080,
+};
+// fp32 accumulators: the same classes
+static const uint32_t f32_specials[] = {
+    0x00000000, 0x80000000, 0x7F800000, 0xFF800000, 0x7FC00000, 0xFFA00001,
+    0x7F800001, 0x00000001, 0x807FFFFF, 0x7F7FFFFF, 0x00800000,
+};
+#define N_BF16_SPECIALS (int)(sizeof(bf16_specials) / sizeof(bf16_specials[0]))
+#define N_F32_SPECIALS  (int)(sizeof(f32_specials) / sizeof(f32_specials[0]))
+
+// round r picks the operand mix: values in [-1, 1), any bit pattern,
+// or [-1, 1) with one element in 8 replaced by a special
+static void fill_validation(uint8_t *A, uint8_t *B, uint8_t *C, int bf16, int round) {
+    if (!bf16) {
+        for (int i = 0; i < 1024; i++) { A[i] = (uint8_t)rand(); B[i] = (uint8_t)rand(); }
+        for (int i = 0; i < 256; i++) ((uint32_t *)C)[i] = rand32();
+        return;
+    }
+    uint16_t *a = (uint16_t *)A, *b = (uint16_t *)B;
+    uint32_t *c = (uint32_t *)C;
+    int mode = round % 3;
+    for (int i = 0; i < 512; i++) {
+        for (int t = 0; t < 2; t++) {
+            uint16_t *v = t ? &b[i] : &a[i];
+            float f = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            *v = (uint16_t)(bits >> 16);
+            if (mode == 1) *v = (uint16_t)rand();
+            if (mode == 2 && rand() % 8 == 0) *v = bf16_specials[rand() % N_BF16_SPECIALS];
+        }
+    }
+    for (int i = 0; i < 256; i++) {
+        float f = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+        memcpy(&c[i], &f, sizeof(f));
+        if (mode == 1) c[i] = rand32();
+        if (mode == 2 && rand() % 8 == 0) c[i] = f32_specials[rand() % N_F32_SPECIALS];
+    }
+}
+
+// Returns the number of mismatching tiles over all forms.
+static int validate_tdp(void) {
+    static uint8_t A[1024] __attribute__((aligned(64))), B[1024] __attribute__((aligned(64)));
+    static uint8_t C[1024] __attribute__((aligned(64))), Ce[1024] __attribute__((aligned(64)));
+    static amx_tilecfg cfg __attribute__((aligned(64)));
+    static amx_emu emu;
+    int total_bad = 0;
+    fill_cfg(&cfg, 16);   // 16 x 64 B for A, B and C in both widths
+    srand(0xA3A);
+    printf("Validation: %d tiles per form against native AMX (emulator: %s)\n",
+           VALIDATE_TILES, amx_emu_isa());
+    for (int f = 0; f < N_TDP_FORMS; f++) {
+        int bad = 0;
+        for (int r = 0; r < VALIDATE_TILES; r++) {
+            fill_validation(A, B, C, tdp_forms[f].bf16, r);
+            memcpy(Ce, C, sizeof(C));
+            tdp_forms[f].native(&cfg, A, B, C);
+            amx_emu_loadconfig(&emu, &cfg);
+            amx_emu_loadd(&emu, 2, Ce, 64);
+            amx_emu_loadd(&emu, 0, A, 64);
+            amx_emu_loadd(&emu, 1, B, 64);
+            tdp_forms[f].emu(&emu, 2, 0, 1);
+            amx_emu_stored(&emu, 2, Ce, 64);
+            amx_emu_release(&emu);
+            bad += memcmp(C, Ce, sizeof(C)) != 0;
+        }
+        printf("  %-10s %s (%d/%d tiles bit-exact)\n", tdp_forms[f].name,
+               bad ? "MISMATCH" : "ok", VALIDATE_TILES - bad, VALIDATE_TILES);
+        total_bad += bad;
+    }
+    srand(1);
+    return total_bad;
+}
+
+static void report(FILE *f, const char *type, float zf, amx_result r) {
+    char energy[96] = "", energy_csv[64] = ",,";
+    if (r.energy_ok) {
+        snprintf(energy, sizeof(energy), ", %.4f J %.1f W %.3g ops/J", r.joules, r.watts, r.ops_per_joule);
+        snprintf(energy_csv, sizeof(energy_csv), "%.6f,%.3f,%.6g", r.joules, r.watts, r.ops_per_joule);
+    }
+    if (amx_native) {
+        printf("%s,%.1f, %lu cycles, emu %lu cycles (%.1fx), %s%s\n", type, zf,
+               (unsigned long)r.native, (unsigned long)r.emu, (double)r.emu / r.native,
+               r.exact ? "bit-exact" : "MISMATCH", energy);
+        fprintf(f,"%s,%.1f,%lu,%lu,%.2f,%s,%s\n", type, zf, (unsigned long)r.native,
+                (unsigned long)r.emu, (double)r.emu / r.native, r.exact ? "yes" : "no", energy_csv);
+    } else {
+        printf("%s,%.1f, emu %lu cycles%s\n", type, zf, (unsigned long)r.emu, energy);
+        fprintf(f,"%s,%.1f,,%lu,,,%s\n", type, zf, (unsigned long)r.emu, energy_csv);
+    }
+}
+
+// ------------------------
+// Main: automatic sweep
+// ------------------------
+int main() {
+    static topology topo;
+    if (topo_load(&topo) == 0) {
+        int cpu = topo_quiet_cpu(&topo);
+        topo_describe(&topo, stdout);
+        printf("Pinned to CPU %d\n", cpu);
+        topo_pin_self(cpu);
+    }
+    static isolate iso;
+    if (isolate_requested()) {
+        isolate_enter(&iso, -1);
+        isolate_report(&iso, stdout);
+    }
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) {
+        isolate_leave(&iso);
+        return 1;
+    }
+
+    amx_native = amx_init() == 0;
+    if (!amx_native)
+        printf("AMX unavailable: %s; running the sweep on the emulator (%s)\n",
+               amx_unavailable_reason(), amx_emu_isa());
+    rapl_ok = rapl_open(&rp, -1) == 0;
+    if (rapl_ok) printf("Energy from RAPL (%s), package %d, %s path\n", rapl_source_name(rp.source), rp.package,
+                        amx_native ? "native" : "emulator");
+    else printf("RAPL not exposed; energy columns left blank\n");
+    if (amx_native) validate_tdp();
+    else printf("Validation skipped: no native AMX to compare the emulator with\n");
+    float zero_fracs[] = {0.0,0.1,0.2,0.3,0.5,0.7,0.9,1.0};
+    int num_zf = sizeof(zero_fracs)/sizeof(zero_fracs[0]);
+
+    // Open CSV file
+    FILE *f = fopen("amx_zero_skip.csv","w");
+    if(!f) {
+        perror("fopen");
+        rapl_close(&rp);
+        isolate_leave(&iso);
+        return 1;
+    }
+    fprintf(f,"Type,ZeroFraction,Cycles,EmuCycles,EmuSlowdown,BitExact,PkgJoules,PkgWatts,OpsPerJoule\n");
+
+    // Sweep INT8
+    for(int i=0;i<num_zf;i++){
+        float zf = zero_fracs[i];
+        report(f, "INT8", zf, measure_int8(zf));
+    }
+
+    // Sweep BF16
+    for(int i=0;i<num_zf;i++){
+        float zf = zero_fracs[i];
+        report(f, "BF16", zf, measure_bf16(zf));
+    }
+
+    fclose(f);
+    preflight_save(&pf, "amx_zero_skip.csv");
+    rapl_close(&rp);
+    isolate_leave(&iso);
+    return 0;
+}
@@ -0,0 +1,318 @@
+// amx_emu.c
+// ===============================================================
+// tdp emulation works one output row at a time. A 64-byte tile row is
+// one zmm (AVX-512) or two ymm (AVX2), so a row of C and the matching
+// row of B sit in registers while the A dword for each K step is
+// broadcast:
+//   byte forms  each dword of A and B is split into its even and odd
+//               bytes widened to 16 bits (sign- or zero-extended per
+//               operand); two pmaddwd give the four products exactly,
+//               and 32-bit adds wrap like the hardware accumulator
+//   bf16        the low/high bf16 of each dword become fp32 by shift
+//               and mask; even and odd pairs get their own FMA chain
+//               under MXCSR = FTZ|DAZ|RNE and are summed into C last.
+//               NaN payloads follow the hardware too: an FMA returns
+//               the first NaN of A, B, accumulator in any encoding, but
+//               an add returns its first source's NaN and the compiler
+//               may commute addps, so even + odd and C + sum pick the
+//               NaN explicitly
+// B is widened once per tdp, not once per row of C.
+// The AVX-512, AVX2 and scalar kernels are all built into every binary
+// (amx_emu_vec.h is included once per vector ISA) and the first tdp
+// picks the widest one isa_supported() allows.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include "amx_emu.h"
+#include "isa.h"
+
+#define MXCSR_TDP 0x9FC0   // all exceptions masked, RNE, FTZ, DAZ
+
+// rows kernel: C tile dst += A tile a x B tile b, shapes already checked
+typedef void (*rows_fn)(amx_emu *e, int dst, int a, int b);
+
+// one set per ISA; dpb in DPB_LIST order (ssd, sud, usd, uud)
+typedef struct {
+    const char *isa;
+    rows_fn     dpb[4];
+    rows_fn     dpbf16;
+} emu_kernels;
+
+#define DPB_LIST(X) X(dpbssd, 1, 1) X(dpbsud, 1, 0) X(dpbusd, 0, 1) X(dpbuud, 0, 0)
+
+#define EMU_STR_(x) #x
+#define EMU_STR(x)  EMU_STR_(x)
+
+// ------------------ Tile State ------------------
+int amx_emu_loadconfig(amx_emu *e, const amx_tilecfg *cfg) {
+    if (cfg->palette_id == 0) {
+        amx_emu_release(e);
+        return 0;
+    }
+    if (cfg->palette_id != 1) return -1;
+    for (int i = 0; i < (int)sizeof(cfg->reserved_0); i++)
+        if (cfg->reserved_0[i]) return -1;
+    for (int t = 0; t < 16; t++) {
+        int rows = cfg->rows[t], colsb = cfg->colsb[t];
+        if (t >= AMX_EMU_TILES) {
+            if (rows || colsb) return -1;
+        } else if (rows > AMX_EMU_ROWS || colsb > AMX_EMU_COLSB || !rows != !colsb) {
+            return -1;
+        }
+    }
+    e->cfg = *cfg;
+    e->cfg.start_row = 0;
+    memset(e->tile, 0, sizeof(e->tile));
+    e->configured = 1;
+    return 0;
+}
+
+void amx_emu_release(amx_emu *e) {
+    memset(e->tile, 0, sizeof(e->tile));
+    memset(&e->cfg, 0, sizeof(e->cfg));
+    e->configured = 0;
+}
+
+static int tile_ok(const amx_emu *e, int t) {
+    return e->configured && t >= 0 && t < AMX_EMU_TILES && e->cfg.rows[t];
+}
+
+// rows past cfg.rows and bytes past cfg.colsb always read as zero
+static void zero_outside(amx_emu *e, int t) {
+    int rows = e->cfg.rows[t], colsb = e->cfg.colsb[t];
+    if (colsb < AMX_EMU_COLSB)
+        for (int r = 0; r < rows; r++) memset(e->tile[t][r] + colsb, 0, AMX_EMU_COLSB - colsb);
+    if (rows < AMX_EMU_ROWS)
+        memset(e->tile[t][rows], 0, (size_t)(AMX_EMU_ROWS - rows) * AMX_EMU_COLSB);
+}
+
+int amx_emu_zero(amx_emu *e, int t) {
+    if (!tile_ok(e, t)) return -1;
+    memset(e->tile[t], 0, sizeof(e->tile[t]));
+    return 0;
+}
+
+int amx_emu_loadd(amx_emu *e, int t, const void *base, size_t stride) {
+    if (!tile_ok(e, t)) return -1;
+    const uint8_t *src = base;
+    for (int r = 0; r < e->cfg.rows[t]; r++)
+        memcpy(e->tile[t][r], src + r * stride, e->cfg.colsb[t]);
+    zero_outside(e, t);
+    return 0;
+}
+
+int amx_emu_stored(const amx_emu *e, int t, void *base, size_t stride) {
+    if (!tile_ok(e, t)) return -1;
+    uint8_t *dst = base;
+    for (int r = 0; r < e->cfg.rows[t]; r++)
+        memcpy(dst + r * stride, e->tile[t][r], e->cfg.colsb[t]);
+    return 0;
+}
+
+// dst = M x N dwords, a = M x K dwords, b = K rows x N dwords
+static int dp_shapes_ok(const amx_emu *e, int dst, int a, int b) {
+    if (!tile_ok(e, dst) || !tile_ok(e, a) || !tile_ok(e, b)) return 0;
+    if (dst == a || dst == b || a == b) return 0;
+    const amx_tilecfg *c = &e->cfg;
+    return c->rows[a] == c->rows[dst] && c->colsb[a] == 4 * c->rows[b] &&
+           c->colsb[b] == c->colsb[dst] && c->colsb[dst] % 4 == 0;
+}
+
+static uint32_t row_dword(const uint8_t *row, int k) {
+    uint32_t d;
+    memcpy(&d, row + 4 * k, sizeof(d));
+    return d;
+}
+
+// ------------------ Scalar Kernels ------------------
+static inline int32_t byte_at(uint32_t d, int i, int sgn) {
+    uint8_t v = (uint8_t)(d >> (8 * i));
+    return sgn ? (int8_t)v : v;
+}
+
+static float bits_to_f32(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline __attribute__((always_inline))
+void dpb_rows_scalar(amx_emu *e, int dst, int a, int b, int a_sgn, int b_sgn) {
+    int rows = e->cfg.rows[dst], k4 = e->cfg.rows[b], n4 = e->cfg.colsb[dst] / 4;
+    for (int m = 0; m < rows; m++)
+        for (int n = 0; n < n4; n++) {
+            uint32_t acc = row_dword(e->tile[dst][m], n);
+            for (int k = 0; k < k4; k++) {
+                uint32_t da = row_dword(e->tile[a][m], k), db = row_dword(e->tile[b][k], n);
+                for (int i = 0; i < 4; i++)
+                    acc += (uint32_t)(byte_at(da, i, a_sgn) * byte_at(db, i, b_sgn));
+            }
+            memcpy(e->tile[dst][m] + 4 * n, &acc, sizeof(acc));
+        }
+}
+
+#define DEFINE_DPB_ROWS_SCALAR(name, a_sgn, b_sgn)                      \
+static void name##_rows_scalar(amx_emu *e, int dst, int a, int b) {     \
+    dpb_rows_scalar(e, dst, a, b, a_sgn, b_sgn);                        \
+}
+DPB_LIST(DEFINE_DPB_ROWS_SCALAR)
+
+// MXCSR covers FMA instructions; the explicit flushes cover a libm fmaf.
+// NaNs resolve as the vector path's do: the first NaN of A, B, then the
+// accumulator for an FMA, of the first then second operand for an add.
+static float flush(float x) {
+    return fpclassify(x) == FP_SUBNORMAL ? copysignf(0.0f, x) : x;
+}
+
+static float quiet(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits_to_f32(bits | 0x00400000);
+}
+
+static float add_x86(float x, float y) {
+    if (isnan(x)) return quiet(x);
+    if (isnan(y)) return quiet(y);
+    return flush(x + y);
+}
+
+static float fma_x86(float acc, float x, float y) {
+    if (isnan(x)) return quiet(x);
+    if (isnan(y)) return quiet(y);
+    if (isnan(acc)) return quiet(acc);
+    return flush(fmaf(flush(x), flush(y), acc));
+}
+
+static void dpbf16_rows_scalar(amx_emu *e, int dst, int a, int b) {
+    int rows = e->cfg.rows[dst], k4 = e->cfg.rows[b], n4 = e->cfg.colsb[dst] / 4;
+    for (int m = 0; m < rows; m++)
+        for (int n = 0; n < n4; n++) {
+            float even = 0.0f, odd = 0.0f, c;
+            for (int k = 0; k < k4; k++) {
+                uint32_t da = row_dword(e->tile[a][m], k), db = row_dword(e->tile[b][k], n);
+                even = fma_x86(even, bits_to_f32(da << 16), bits_to_f32(db << 16));
+                odd  = fma_x86(odd, bits_to_f32(da & 0xFFFF0000u), bits_to_f32(db & 0xFFFF0000u));
+            }
+            memcpy(&c, e->tile[dst][m] + 4 * n, sizeof(c));
+            c = add_x86(flush(c), add_x86(even, odd));
+            memcpy(e->tile[dst][m] + 4 * n, &c, sizeof(c));
+        }
+}
+
+static const emu_kernels kernels_scalar = {
+    "scalar",
+    { dpbssd_rows_scalar, dpbsud_rows_scalar, dpbusd_rows_scalar, dpbuud_rows_scalar },
+    dpbf16_rows_scalar,
+};
+
+// ------------------ AVX-512 Kernels ------------------
+#define EMU_VEC          avx512
+#define EMU_TARGET       ISA_TARGET_AVX512
+#define VBYTES           64
+#define vint             __m512i
+#define vflt             __m512
+#define V_LOAD(p)        _mm512_load_si512((const void *)(p))
+#define V_STORE(p, v)    _mm512_store_si512((void *)(p), v)
+#define V_SET1(x)        _mm512_set1_epi32((int)(x))
+#define V_ADD32(a, b)    _mm512_add_epi32(a, b)
+#define V_MADD16(a, b)   _mm512_madd_epi16(a, b)
+#define V_AND(a, b)      _mm512_and_si512(a, b)
+#define V_SLLI16(a, n)   _mm512_slli_epi16(a, n)
+#define V_SRAI16(a, n)   _mm512_srai_epi16(a, n)
+#define V_SRLI16(a, n)   _mm512_srli_epi16(a, n)
+#define V_SLLI32(a, n)   _mm512_slli_epi32(a, n)
+#define VF_ZERO()        _mm512_setzero_ps()
+#define VF_SET1(x)       _mm512_set1_ps(x)
+#define VF_LOAD(p)       _mm512_load_ps((const float *)(p))
+#define VF_STORE(p, v)   _mm512_store_ps((float *)(p), v)
+#define VF_FROM(v)       _mm512_castsi512_ps(v)
+#define VF_FMA(a, b, c)  _mm512_fmadd_ps(a, b, c)
+#define VF_ADD(a, b)     _mm512_add_ps(a, b)
+#define VF_QUIET_NAN(c, r) _mm512_mask_mov_ps(r, _mm512_cmp_ps_mask(c, c, _CMP_UNORD_Q), \
+                             VF_FROM(_mm512_or_si512(_mm512_castps_si512(c), V_SET1(0x00400000))))
+#include "amx_emu_vec.h"
+#undef EMU_VEC
+#undef EMU_TARGET
+#undef VBYTES
+#undef vint
+#undef vflt
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD32
+#undef V_MADD16
+#undef V_AND
+#undef V_SLLI16
+#undef V_SRAI16
+#undef V_SRLI16
+#undef V_SLLI32
+#undef VF_ZERO
+#undef VF_SET1
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_FROM
+#undef VF_FMA
+#undef VF_ADD
+#undef VF_QUIET_NAN
+
+// ------------------ AVX2 Kernels ------------------
+#define EMU_VEC          avx2
+#define EMU_TARGET       ISA_TARGET_AVX2
+#define VBYTES           32
+#define vint             __m256i
+#define vflt             __m256
+#define V_LOAD(p)        _mm256_load_si256((const __m256i *)(p))
+#define V_STORE(p, v)    _mm256_store_si256((__m256i *)(p), v)
+#define V_SET1(x)        _mm256_set1_epi32((int)(x))
+#define V_ADD32(a, b)    _mm256_add_epi32(a, b)
+#define V_MADD16(a, b)   _mm256_madd_epi16(a, b)
+#define V_AND(a, b)      _mm256_and_si256(a, b)
+#define V_SLLI16(a, n)   _mm256_slli_epi16(a, n)
+#define V_SRAI16(a, n)   _mm256_srai_epi16(a, n)
+#define V_SRLI16(a, n)   _mm256_srli_epi16(a, n)
+#define V_SLLI32(a, n)   _mm256_slli_epi32(a, n)
+#define VF_ZERO()        _mm256_setzero_ps()
+#define VF_SET1(x)       _mm256_set1_ps(x)
+#define VF_LOAD(p)       _mm256_load_ps((const float *)(p))
+#define VF_STORE(p, v)   _mm256_store_ps((float *)(p), v)
+#define VF_FROM(v)       _mm256_castsi256_ps(v)
+#define VF_FMA(a, b, c)  _mm256_fmadd_ps(a, b, c)
+#define VF_ADD(a, b)     _mm256_add_ps(a, b)
+#define VF_QUIET_NAN(c, r) _mm256_blendv_ps(r, VF_FROM(_mm256_or_si256(_mm256_castps_si256(c), \
+                             V_SET1(0x00400000))), _mm256_cmp_ps(c, c, _CMP_UNORD_Q))
+#include "amx_emu_vec.h"
+
+// ------------------ Dispatch ------------------
+static const emu_kernels *select_kernels(void) {
+    static const emu_kernels *k;
+    if (!k) k = isa_supported(ISA_AVX512) ? &kernels_avx512 :
+                isa_supported(ISA_AVX2)   ? &kernels_avx2 : &kernels_scalar;
+    return k;
+}
+
+const char *amx_emu_isa(void) {
+    return select_kernels()->isa;
+}
+
+#define DEFINE_DPB(name, a_sgn, b_sgn)                              \
+int amx_emu_##name(amx_emu *e, int dst, int a, int b) {             \
+    const int slot = (a_sgn ? 0 : 2) + (b_sgn ? 0 : 1);             \
+    if (!dp_shapes_ok(e, dst, a, b)) return -1;                     \
+    select_kernels()->dpb[slot](e, dst, a, b);                      \
+    zero_outside(e, dst);                                           \
+    return 0;                                                       \
+}
+DPB_LIST(DEFINE_DPB)
+
+int amx_emu_dpbf16ps(amx_emu *e, int dst, int a, int b) {
+    if (!dp_shapes_ok(e, dst, a, b)) return -1;
+    unsigned csr = _mm_getcsr();
+    _mm_setcsr(MXCSR_TDP);
+    select_kernels()->dpbf16(e, dst, a, b);
+    _mm_setcsr(csr);
+    zero_outside(e, dst);
+    return 0;
+}
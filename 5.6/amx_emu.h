@@ -0,0 +1,60 @@
+// amx_emu.h
+// ===============================================================
+// Software model of the palette-1 AMX tile state: 8 tiles of up to
+// 16 rows x 64 bytes, configured from the same 64-byte block that
+// ldtilecfg takes. Each amx_emu_* call mirrors one instruction:
+//   amx_emu_loadconfig  ldtilecfg       amx_emu_release  tilerelease
+//   amx_emu_loadd       tileloadd       amx_emu_stored   tilestored
+//   amx_emu_zero        tilezero
+//   amx_emu_dpb{ss,su,us,uu}d           tdpb{ss,su,us,uu}d
+//   amx_emu_dpbf16ps                    tdpbf16ps
+// Calls return 0, or -1 where the instruction would fault (#GP on a bad
+// config, #UD when tiles are unconfigured or shapes do not match).
+// Results are bit-exact with hardware: the integer forms wrap mod 2^32
+// like the tdp, and tdpbf16ps keeps the even/odd fp32 partial sums with
+// DAZ/FTZ/RNE that the SDM pseudocode specifies. amx_bench checks
+// every form against native AMX on each run, with full-range bytes and
+// bf16 NaN / Inf / denormal / overflow operands and accumulators.
+// ===============================================================
+#ifndef AMX_EMU_H
+#define AMX_EMU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AMX_EMU_TILES  8
+#define AMX_EMU_ROWS   16
+#define AMX_EMU_COLSB  64
+
+// ldtilecfg memory operand
+typedef struct {
+    uint8_t  palette_id;
+    uint8_t  start_row;
+    uint8_t  reserved_0[14];
+    uint16_t colsb[16];
+    uint8_t  rows[16];
+} __attribute__((packed)) amx_tilecfg;
+
+typedef struct {
+    uint8_t     tile[AMX_EMU_TILES][AMX_EMU_ROWS][AMX_EMU_COLSB] __attribute__((aligned(64)));
+    amx_tilecfg cfg;
+    int         configured;
+} amx_emu;
+
+int amx_emu_loadconfig(amx_emu *e, const amx_tilecfg *cfg);
+void amx_emu_release(amx_emu *e);
+
+int amx_emu_zero(amx_emu *e, int t);
+int amx_emu_loadd(amx_emu *e, int t, const void *base, size_t stride);
+int amx_emu_stored(const amx_emu *e, int t, void *base, size_t stride);
+
+int amx_emu_dpbssd(amx_emu *e, int dst, int a, int b);
+int amx_emu_dpbsud(amx_emu *e, int dst, int a, int b);
+int amx_emu_dpbusd(amx_emu *e, int dst, int a, int b);
+int amx_emu_dpbuud(amx_emu *e, int dst, int a, int b);
+int amx_emu_dpbf16ps(amx_emu *e, int dst, int a, int b);
+
+// "avx512", "avx2" or "scalar": the tdp path picked for this CPU
+const char *amx_emu_isa(void);
+
+#endif
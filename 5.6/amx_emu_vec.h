@@ -0,0 +1,100 @@
+// amx_emu_vec.h
+// ===============================================================
+// Vector tdp kernels, included by amx_emu.c once per ISA with
+//   EMU_VEC       name suffix (avx512, avx2)
+//   EMU_TARGET    the isa.h target attribute for that suffix
+//   VBYTES and the V_* / VF_* operation macros
+// so each copy is compiled for its own tier and picked at run time.
+// No include guard on purpose.
+// ===============================================================
+
+#define EMU_CAT_(a, b)  a##_##b
+#define EMU_CAT(a, b)   EMU_CAT_(a, b)
+#define EMU_FN(name)    EMU_CAT(name, EMU_VEC)
+
+#define VPARTS (AMX_EMU_COLSB / VBYTES)
+
+// ------------------ Byte Dot Products ------------------
+// 16-bit lanes holding bytes 0/2 (lo) or 1/3 (hi) of every dword
+static inline EMU_TARGET vint EMU_FN(widen_lo)(vint v, int sgn) {
+    return sgn ? V_SRAI16(V_SLLI16(v, 8), 8) : V_AND(v, V_SET1(0x00FF00FF));
+}
+
+static inline EMU_TARGET vint EMU_FN(widen_hi)(vint v, int sgn) {
+    return sgn ? V_SRAI16(v, 8) : V_SRLI16(v, 8);
+}
+
+static inline __attribute__((always_inline)) EMU_TARGET
+void EMU_FN(dpb_rows)(amx_emu *e, int dst, int a, int b, int a_sgn, int b_sgn) {
+    int rows = e->cfg.rows[dst], k4 = e->cfg.rows[b];
+    vint blo[AMX_EMU_ROWS][VPARTS], bhi[AMX_EMU_ROWS][VPARTS];
+    for (int k = 0; k < k4; k++)
+        for (int p = 0; p < VPARTS; p++) {
+            vint v = V_LOAD(e->tile[b][k] + p * VBYTES);
+            blo[k][p] = EMU_FN(widen_lo)(v, b_sgn);
+            bhi[k][p] = EMU_FN(widen_hi)(v, b_sgn);
+        }
+    for (int m = 0; m < rows; m++) {
+        vint acc[VPARTS];
+        for (int p = 0; p < VPARTS; p++) acc[p] = V_LOAD(e->tile[dst][m] + p * VBYTES);
+        for (int k = 0; k < k4; k++) {
+            uint32_t d = row_dword(e->tile[a][m], k);
+            vint lo = V_SET1((uint16_t)byte_at(d, 0, a_sgn) | (uint32_t)(uint16_t)byte_at(d, 2, a_sgn) << 16);
+            vint hi = V_SET1((uint16_t)byte_at(d, 1, a_sgn) | (uint32_t)(uint16_t)byte_at(d, 3, a_sgn) << 16);
+            for (int p = 0; p < VPARTS; p++) {
+                acc[p] = V_ADD32(acc[p], V_MADD16(lo, blo[k][p]));
+                acc[p] = V_ADD32(acc[p], V_MADD16(hi, bhi[k][p]));
+            }
+        }
+        for (int p = 0; p < VPARTS; p++) V_STORE(e->tile[dst][m] + p * VBYTES, acc[p]);
+    }
+}
+
+// one entry point per signedness so the sign tests fold away
+#define DEFINE_DPB_ROWS(name, a_sgn, b_sgn)                             \
+static EMU_TARGET void EMU_FN(name##_rows)(amx_emu *e, int dst, int a, int b) { \
+    EMU_FN(dpb_rows)(e, dst, a, b, a_sgn, b_sgn);                       \
+}
+DPB_LIST(DEFINE_DPB_ROWS)
+#undef DEFINE_DPB_ROWS
+
+// ------------------ BF16 Dot Product ------------------
+static EMU_TARGET void EMU_FN(dpbf16_rows)(amx_emu *e, int dst, int a, int b) {
+    int rows = e->cfg.rows[dst], k4 = e->cfg.rows[b];
+    vflt beven[AMX_EMU_ROWS][VPARTS], bodd[AMX_EMU_ROWS][VPARTS];
+    for (int k = 0; k < k4; k++)
+        for (int p = 0; p < VPARTS; p++) {
+            vint v = V_LOAD(e->tile[b][k] + p * VBYTES);
+            beven[k][p] = VF_FROM(V_SLLI32(v, 16));
+            bodd[k][p]  = VF_FROM(V_AND(v, V_SET1(0xFFFF0000u)));
+        }
+    for (int m = 0; m < rows; m++) {
+        vflt even[VPARTS], odd[VPARTS];
+        for (int p = 0; p < VPARTS; p++) even[p] = odd[p] = VF_ZERO();
+        for (int k = 0; k < k4; k++) {
+            uint32_t d = row_dword(e->tile[a][m], k);
+            vflt ae = VF_SET1(bits_to_f32(d << 16)), ao = VF_SET1(bits_to_f32(d & 0xFFFF0000u));
+            for (int p = 0; p < VPARTS; p++) {
+                even[p] = VF_FMA(ae, beven[k][p], even[p]);
+                odd[p]  = VF_FMA(ao, bodd[k][p], odd[p]);
+            }
+        }
+        for (int p = 0; p < VPARTS; p++) {
+            uint8_t *c = e->tile[dst][m] + p * VBYTES;
+            vflt cv = VF_LOAD(c);
+            vflt sum = VF_QUIET_NAN(even[p], VF_ADD(even[p], odd[p]));
+            VF_STORE(c, VF_QUIET_NAN(cv, VF_ADD(cv, sum)));
+        }
+    }
+}
+
+static const emu_kernels EMU_FN(kernels) = {
+    EMU_STR(EMU_VEC),
+    { EMU_FN(dpbssd_rows), EMU_FN(dpbsud_rows), EMU_FN(dpbusd_rows), EMU_FN(dpbuud_rows) },
+    EMU_FN(dpbf16_rows),
+};
+
+#undef VPARTS
+#undef EMU_FN
+#undef EMU_CAT
+#undef EMU_CAT_
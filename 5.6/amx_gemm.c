@@ -0,0 +1,254 @@
+// amx_gemm.c
+// ===============================================================
+// Tile assignment (palette 1, every tile 16 rows x 64 bytes):
+//   tmm0..3  C accumulators, a 2 x 2 block of 16 x 16 outputs
+//   tmm4..5  A, rows i..i+15 and i+16..i+31 of the current K step
+//   tmm6..7  B, columns j..j+15 and j+16..j+31 of the current K step
+// so every A tile feeds two tdps and every B tile feeds two tdps.
+// With all 8 tiles in use there is no spare tile to ping-pong, so B is
+// double-buffered one level up: while panel j is being consumed, panel
+// j + 1 is prefetched into L2 a slice per 32-row block of C.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include "amx_gemm.h"
+#include "amx_emu.h"
+#include "isa.h"
+
+#define PANEL_COLS 32
+
+static const char *unavailable = "amx_init() not called";
+
+// ------------------ Detection ------------------
+int amx_init(void) {
+    unavailable = isa_supported(ISA_AMX) ? NULL : isa_reason(ISA_AMX);
+    return unavailable ? -1 : 0;
+}
+
+const char *amx_unavailable_reason(void) {
+    return unavailable ? unavailable : "available";
+}
+
+// ------------------ BF16 Helpers ------------------
+uint16_t amx_f32_to_bf16(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) return (uint16_t)((bits >> 16) | 0x40);   // quiet NaN
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return (uint16_t)(bits >> 16);
+}
+
+float amx_bf16_to_f32(uint16_t b) {
+    uint32_t bits = (uint32_t)b << 16;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// ------------------ Packing ------------------
+size_t amx_elem_size(amx_dtype t) {
+    return t == AMX_INT8 ? 1 : 2;
+}
+
+int amx_dims_ok(amx_dtype t, int M, int N, int K) {
+    return M > 0 && N > 0 && K > 0 && M % 32 == 0 && N % PANEL_COLS == 0 &&
+           K % AMX_K_STEP(t) == 0;
+}
+
+size_t amx_packed_b_size(amx_dtype t, int K, int N) {
+    return (size_t)K * N * amx_elem_size(t);
+}
+
+// Panel p, K step s, tile h (0/1) is one 1 KB block at
+//   ((p * steps + s) * 2 + h) * 1024 bytes
+// holding 16 rows of `group` consecutive k values x 16 columns:
+//   row r, column c, lane q  <-  B[s*step + r*group + q][p*32 + h*16 + c]
+void amx_pack_b(amx_dtype t, const void *B, int K, int N, void *packed) {
+    int step = AMX_K_STEP(t), group = t == AMX_INT8 ? 4 : 2;
+    int steps = K / step;
+    size_t es = amx_elem_size(t);
+    const uint8_t *src = B;
+    uint8_t *dst = packed;
+    for (int p = 0; p < N / PANEL_COLS; p++)
+        for (int s = 0; s < steps; s++)
+            for (int h = 0; h < 2; h++) {
+                uint8_t *tile = dst + (((size_t)p * steps + s) * 2 + h) * 1024;
+                for (int r = 0; r < 16; r++)
+                    for (int c = 0; c < 16; c++)
+                        for (int q = 0; q < group; q++) {
+                            size_t k = (size_t)s * step + r * group + q;
+                            size_t n = (size_t)p * PANEL_COLS + h * 16 + c;
+                            memcpy(tile + r * 64 + (c * group + q) * es,
+                                   src + (k * N + n) * es, es);
+                        }
+            }
+}
+
+// ------------------ Tile Kernels ------------------
+static void fill_tilecfg(amx_tilecfg *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->palette_id = 1;
+    for (int t = 0; t < 8; t++) {
+        cfg->rows[t] = 16;
+        cfg->colsb[t] = 64;
+    }
+}
+
+// one 2 x 2 block of C over the whole K range, written against tile-op
+// macros ZERO(t), LOAD(t, p, stride), TDP(c, a, b) so the native and
+// emulated paths run the identical schedule
+#define AMX_BLOCK(ZERO, LOAD, TDP, a_row0, a_row1, a_stride, bp, steps, a_step_bytes) \
+    do {                                                                       \
+        ZERO(0); ZERO(1); ZERO(2); ZERO(3);                                    \
+        for (int s = 0; s < (steps); s++) {                                    \
+            const uint8_t *b = (bp) + (size_t)s * 2048;                        \
+            LOAD(4, (a_row0) + (size_t)s * (a_step_bytes), (a_stride));        \
+            LOAD(6, b, 64);                                                    \
+            LOAD(7, b + 1024, 64);                                             \
+            TDP(0, 4, 6);                                                      \
+            TDP(1, 4, 7);                                                      \
+            LOAD(5, (a_row1) + (size_t)s * (a_step_bytes), (a_stride));        \
+            TDP(2, 5, 6);                                                      \
+            TDP(3, 5, 7);                                                      \
+        }                                                                      \
+    } while (0)
+
+// walks C in 32 x 32 blocks; BLOCK_INT8/BLOCK_BF16/STORE supply the tile ops
+#define AMX_GEMM_LOOP(BLOCK_INT8, BLOCK_BF16, STORE, PREFETCH)                 \
+    do {                                                                       \
+        size_t es = amx_elem_size(t);                                          \
+        int steps = K / AMX_K_STEP(t);                                         \
+        size_t a_stride = (size_t)K * es;                                      \
+        size_t panel = (size_t)K * PANEL_COLS * es;                            \
+        size_t slice = (panel + M / 32 - 1) / (M / 32);                        \
+        size_t c_stride = (size_t)N * 4;                                       \
+        const uint8_t *a = A, *bp = packed_b;                                  \
+        uint8_t *c = C;                                                        \
+        for (int j = 0; j < N; j += PANEL_COLS) {                              \
+            const uint8_t *panel_j = bp + (size_t)(j / PANEL_COLS) * panel;    \
+            const uint8_t *next = j + PANEL_COLS < N ? panel_j + panel : NULL; \
+            for (int i = 0; i < M; i += 32) {                                  \
+                if (PREFETCH && next) prefetch_slice(next + (size_t)(i / 32) * slice, slice); \
+                const uint8_t *a0 = a + (size_t)i * a_stride, *a1 = a0 + 16 * a_stride; \
+                if (t == AMX_INT8) BLOCK_INT8(a0, a1, a_stride, panel_j, steps, 64); \
+                else               BLOCK_BF16(a0, a1, a_stride, panel_j, steps, 64); \
+                uint8_t *c0 = c + (size_t)i * c_stride + (size_t)j * 4;        \
+                STORE(0, c0, c_stride);                                        \
+                STORE(1, c0 + 64, c_stride);                                   \
+                STORE(2, c0 + 16 * c_stride, c_stride);                        \
+                STORE(3, c0 + 16 * c_stride + 64, c_stride);                   \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+static void prefetch_slice(const uint8_t *p, size_t bytes) {
+    for (size_t off = 0; off < bytes; off += 64)
+        _mm_prefetch((const char *)p + off, _MM_HINT_T1);
+}
+
+// the native kernels are built for AMX whatever the compile flags and
+// are only entered once amx_init() has succeeded
+ISA_TARGET_AMX void amx_tile_config_load(void) {
+    if (unavailable) return;
+    // on the stack: workers load their configs at the same moment, and a
+    // shared copy could be cleared by one while another runs ldtilecfg
+    amx_tilecfg cfg __attribute__((aligned(64)));
+    fill_tilecfg(&cfg);
+    // GCC's _tile_loadconfig asm only declares an 8-byte memory input, so
+    // without the barrier the rest of cfg may never be stored
+    __asm__ volatile("" ::: "memory");
+    _tile_loadconfig(&cfg);
+}
+
+ISA_TARGET_AMX void amx_tile_release(void) {
+    if (unavailable) return;
+    _tile_release();
+}
+
+#define HW_ZERO(t)           _tile_zero(t)
+#define HW_LOAD(t, p, s)     _tile_loadd(t, p, s)
+#define HW_STORE(t, p, s)    _tile_stored(t, p, s)
+#define HW_BLOCK_INT8(...)   AMX_BLOCK(HW_ZERO, HW_LOAD, _tile_dpbssd, __VA_ARGS__)
+#define HW_BLOCK_BF16(...)   AMX_BLOCK(HW_ZERO, HW_LOAD, _tile_dpbf16ps, __VA_ARGS__)
+
+ISA_TARGET_AMX
+void amx_gemm(amx_dtype t, const void *A, const void *packed_b, void *C, int M, int N, int K) {
+    if (unavailable) {
+        fprintf(stderr, "amx_gemm: %s\n", amx_unavailable_reason());
+        abort();
+    }
+    AMX_GEMM_LOOP(HW_BLOCK_INT8, HW_BLOCK_BF16, HW_STORE, 1);
+}
+
+// the same tile program on the software model; no prefetch, the
+// emulator is compute-bound
+#define EMU_ZERO(t)          amx_emu_zero(&emu, t)
+#define EMU_LOAD(t, p, s)    amx_emu_loadd(&emu, t, p, s)
+#define EMU_STORE(t, p, s)   amx_emu_stored(&emu, t, p, s)
+#define EMU_DPBSSD(c, a, b)  amx_emu_dpbssd(&emu, c, a, b)
+#define EMU_DPBF16PS(c, a, b) amx_emu_dpbf16ps(&emu, c, a, b)
+#define EMU_BLOCK_INT8(...)  AMX_BLOCK(EMU_ZERO, EMU_LOAD, EMU_DPBSSD, __VA_ARGS__)
+#define EMU_BLOCK_BF16(...)  AMX_BLOCK(EMU_ZERO, EMU_LOAD, EMU_DPBF16PS, __VA_ARGS__)
+
+void amx_gemm_emu(amx_dtype t, const void *A, const void *packed_b, void *C, int M, int N, int K) {
+    static __thread amx_emu emu;
+    amx_tilecfg cfg;
+    fill_tilecfg(&cfg);
+    amx_emu_loadconfig(&emu, &cfg);
+    AMX_GEMM_LOOP(EMU_BLOCK_INT8, EMU_BLOCK_BF16, EMU_STORE, 0);
+    amx_emu_release(&emu);
+}
+
+// ------------------ Reference ------------------
+static double ref_element(amx_dtype t, const void *A, const void *B, int N, int K, int i, int j) {
+    if (t == AMX_INT8) {
+        const int8_t *a = A, *b = B;
+        int32_t acc = 0;
+        for (int k = 0; k < K; k++) acc += (int32_t)a[(size_t)i * K + k] * b[(size_t)k * N + j];
+        return acc;
+    }
+    const uint16_t *a = A, *b = B;
+    float acc = 0.0f;
+    for (int k = 0; k < K; k++)
+        acc += amx_bf16_to_f32(a[(size_t)i * K + k]) * amx_bf16_to_f32(b[(size_t)k * N + j]);
+    return acc;
+}
+
+void amx_ref_gemm(amx_dtype t, const void *A, const void *B, void *C, int M, int N, int K) {
+    for (int i = 0; i < M; i++)
+        for (int j = 0; j < N; j++) {
+            double v = ref_element(t, A, B, N, K, i, j);
+            if (t == AMX_INT8) ((int32_t *)C)[(size_t)i * N + j] = (int32_t)v;
+            else               ((float *)C)[(size_t)i * N + j] = (float)v;
+        }
+}
+
+static int element_matches(amx_dtype t, const void *C, int N, int i, int j, double ref, int K) {
+    if (t == AMX_INT8) return ((const int32_t *)C)[(size_t)i * N + j] == (int32_t)ref;
+    double got = ((const float *)C)[(size_t)i * N + j];
+    // fp32 sums of K products in a different order: allow K ulps-ish of slack
+    return fabs(got - ref) <= 1e-5 * K * (fabs(ref) + 1.0);
+}
+
+long amx_check(amx_dtype t, const void *A, const void *B, const void *C,
+               int M, int N, int K, long full_limit, int samples) {
+    long bad = 0;
+    if ((long)M * N <= full_limit) {
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < N; j++)
+                bad += !element_matches(t, C, N, i, j, ref_element(t, A, B, N, K, i, j), K);
+        return bad;
+    }
+    uint64_t s = 0x2545F4914F6CDD1Dull ^ ((uint64_t)M << 32 | (unsigned)N);
+    for (int n = 0; n < samples; n++) {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        int i = (int)(s % M), j = (int)((s >> 32) % N);
+        bad += !element_matches(t, C, N, i, j, ref_element(t, A, B, N, K, i, j), K);
+    }
+    return bad;
+}
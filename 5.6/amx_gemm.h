@@ -0,0 +1,58 @@
+// amx_gemm.h
+// ===============================================================
+// AMX GEMM engine: C = A x B with INT8 (int32 accumulate) or BF16
+// (fp32 accumulate) operands.
+//   A   row-major M x K, used in place (tile loads with stride K)
+//   B   row-major K x N, packed once by amx_pack_b() into VNNI
+//       panels of 32 columns (two 16-column tiles per K step)
+//   C   row-major M x N, overwritten
+// Dimensions: M and N multiples of 32, K a multiple of AMX_K_STEP.
+// ===============================================================
+#ifndef AMX_GEMM_H
+#define AMX_GEMM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum { AMX_INT8, AMX_BF16 } amx_dtype;
+
+// K consumed by one tdp per type: 64 int8 or 32 bf16 = one 64-byte tile row
+#define AMX_K_STEP(t) ((t) == AMX_INT8 ? 64 : 32)
+
+// CPUID, XCR0 and arch_prctl(ARCH_REQ_XCOMP_PERM) checks, via
+// isa_supported(ISA_AMX). Returns 0 when tiles can be used by this
+// process; otherwise amx_unavailable_reason() says which step failed.
+int amx_init(void);
+const char *amx_unavailable_reason(void);
+
+// Loads the palette-1 configuration used by amx_gemm() on the calling
+// thread (threads may call it concurrently); amx_tile_release() returns
+// the tile state to init. Both are no-ops until amx_init() has succeeded.
+void amx_tile_config_load(void);
+void amx_tile_release(void);
+
+int    amx_dims_ok(amx_dtype t, int M, int N, int K);
+size_t amx_elem_size(amx_dtype t);     // A/B element bytes
+size_t amx_packed_b_size(amx_dtype t, int K, int N);
+void   amx_pack_b(amx_dtype t, const void *B, int K, int N, void *packed);
+
+// Tile config must be loaded on this thread.
+void amx_gemm(amx_dtype t, const void *A, const void *packed_b, void *C, int M, int N, int K);
+
+// Same tile program run on the amx_emu.h software model; needs no AMX and
+// no tile config, and its C is bit-identical to amx_gemm()'s.
+void amx_gemm_emu(amx_dtype t, const void *A, const void *packed_b, void *C, int M, int N, int K);
+
+// Scalar reference on the unpacked B. For BF16 the products are summed in
+// fp32 in K order, so compare with a tolerance (amx_check does).
+void amx_ref_gemm(amx_dtype t, const void *A, const void *B, void *C, int M, int N, int K);
+
+// Compares C against the reference at every element (M*N <= full_limit)
+// or at `samples` pseudo-random positions. Returns the mismatch count.
+long amx_check(amx_dtype t, const void *A, const void *B, const void *C,
+               int M, int N, int K, long full_limit, int samples);
+
+uint16_t amx_f32_to_bf16(float f);   // round to nearest even
+float    amx_bf16_to_f32(uint16_t b);
+
+#endif
@@ -0,0 +1,173 @@
+// amx_gemm_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds amx_gemm_bench)
+// Run:     taskset -c 0 ./amx_gemm_bench
+//
+// INT8 and BF16 GEMM throughput through amx_gemm.c for square problems
+// from L1-resident (64) to DRAM-resident (8192). B is packed once
+// outside the timed region, as for inference weights. Each size is
+// checked against the scalar reference (every element up to 256 x 256,
+// 1024 sampled elements above).
+// Up to EMU_MAX_DIM the same tile program also runs on the software
+// model (amx_emu.c): its time gives the emulation slowdown, and its C
+// must match the native C bit for bit. Hosts without usable AMX print
+// the reason and run the emulated sizes only.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "timing.h"
+#include "amx_gemm.h"
+#include "amx_emu.h"
+#include "preflight.h"
+
+#define TRIALS       5
+#define MIN_OPS      2e10      // repeat small problems until this many ops
+#define FULL_CHECK   (256 * 256)
+#define CHECK_SAMPLES 1024
+#define EMU_MAX_DIM  1024
+#define EMU_MIN_OPS  1e9
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+static uint64_t xorshift64(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fill(amx_dtype t, void *p, size_t n) {
+    if (t == AMX_INT8) {
+        int8_t *q = p;
+        for (size_t i = 0; i < n; i++) q[i] = (int8_t)(xorshift64() & 0xFF);
+    } else {
+        uint16_t *q = p;
+        for (size_t i = 0; i < n; i++)
+            q[i] = amx_f32_to_bf16((float)((int)(xorshift64() % 2001) - 1000) / 1000.0f);
+    }
+}
+
+static const char *level_of(size_t bytes) {
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE), l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l1 > 0 && bytes <= (size_t)l1) return "L1";
+    if (l2 > 0 && bytes <= (size_t)l2) return "L2";
+    if (l3 > 0 && bytes <= (size_t)l3) return "LLC";
+    return "DRAM";
+}
+
+typedef void (*gemm_fn)(amx_dtype, const void *, const void *, void *, int, int, int);
+
+// median seconds per call, repeating small problems up to min_ops
+static double time_gemm(gemm_fn fn, amx_dtype t, const void *A, const void *Bp, void *C,
+                        int M, int N, int K, double min_ops, int *reps_out) {
+    double ops = 2.0 * M * N * K;
+    int reps = ops >= min_ops ? 1 : (int)(min_ops / ops);
+    int trials = ops >= min_ops ? 1 : TRIALS;
+    double secs[TRIALS];
+    fn(t, A, Bp, C, M, N, K); // warm up
+    for (int tr = 0; tr < trials; tr++) {
+        double t0 = now_sec();
+        for (int r = 0; r < reps; r++) fn(t, A, Bp, C, M, N, K);
+        secs[tr] = (now_sec() - t0) / reps;
+    }
+    if (reps_out) *reps_out = reps;
+    return median(secs, trials);
+}
+
+int main(void) {
+    static const int sizes[] = { 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    static const char *type_name[] = { "INT8", "BF16" };
+
+    int native = amx_init() == 0;
+    if (!native)
+        printf("AMX unavailable: %s; emulation only, up to %d^3\n", amx_unavailable_reason(),
+               EMU_MAX_DIM);
+    printf("Emulator path: %s\n", amx_emu_isa());
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("amx_gemm_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening amx_gemm_results.csv\n");
+        return 1;
+    }
+    fprintf(fp, "type,M,N,K,footprint_bytes,level,reps,seconds,tops,check,"
+                "emu_isa,emu_seconds,emu_tops,emu_slowdown,bitexact\n");
+    if (native) amx_tile_config_load();
+
+    for (int t = AMX_INT8; t <= AMX_BF16; t++) {
+        printf("=== %s GEMM ===\n", type_name[t]);
+        for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            int M = sizes[s], N = sizes[s], K = sizes[s];
+            int emulate = M <= EMU_MAX_DIM;
+            if (!native && !emulate) break;
+            size_t es = amx_elem_size(t);
+            size_t a_bytes = (size_t)M * K * es, b_bytes = (size_t)K * N * es;
+            size_t c_bytes = (size_t)M * N * 4;
+            void *A = aligned_alloc(64, a_bytes), *B = aligned_alloc(64, b_bytes);
+            void *Bp = aligned_alloc(64, amx_packed_b_size(t, K, N));
+            void *C = aligned_alloc(64, c_bytes);
+            void *Ce = emulate ? aligned_alloc(64, c_bytes) : NULL;
+            if (!A || !B || !Bp || !C || (emulate && !Ce)) {
+                printf("%dx%dx%d: allocation failed, stopping\n", M, N, K);
+                free(A); free(B); free(Bp); free(C); free(Ce);
+                break;
+            }
+            fill(t, A, (size_t)M * K);
+            fill(t, B, (size_t)K * N);
+            amx_pack_b(t, B, K, N, Bp);
+            memset(C, 0, c_bytes);
+
+            double ops = 2.0 * M * N * K;
+            size_t footprint = a_bytes + b_bytes + c_bytes;
+            int reps = 0;
+            double sec = 0.0, tops = 0.0, esec = 0.0, etops = 0.0;
+            if (native) {
+                sec = time_gemm(amx_gemm, t, A, Bp, C, M, N, K, MIN_OPS, &reps);
+                tops = ops / sec / 1e12;
+            }
+            if (emulate) {
+                esec = time_gemm(amx_gemm_emu, t, A, Bp, Ce, M, N, K, EMU_MIN_OPS, NULL);
+                etops = ops / esec / 1e12;
+            }
+            long bad = amx_check(t, A, B, native ? C : Ce, M, N, K, FULL_CHECK, CHECK_SAMPLES);
+            const char *exact = !(native && emulate) ? "" : memcmp(C, Ce, c_bytes) ? "no" : "yes";
+
+            fprintf(fp, "%s,%d,%d,%d,%zu,%s,", type_name[t], M, N, K, footprint, level_of(footprint));
+            if (native) fprintf(fp, "%d,%.6e,%.4f,", reps, sec, tops);
+            else        fprintf(fp, ",,,");
+            fprintf(fp, "%s,", bad ? "FAIL" : "ok");
+            if (emulate) fprintf(fp, "%s,%.6e,%.4f,", amx_emu_isa(), esec, etops);
+            else         fprintf(fp, ",,,");
+            if (native && emulate) fprintf(fp, "%.1f,%s\n", esec / sec, exact);
+            else                   fprintf(fp, ",%s\n", exact);
+
+            printf("%5d^3 (%-4s):", M, level_of(footprint));
+            if (native) printf(" %8.3f TOPS", tops);
+            if (emulate) printf("  emu %8.4f TOPS", etops);
+            if (native && emulate) printf(" (%.0fx slower, %s)", esec / sec,
+                                          *exact == 'y' ? "bit-exact" : "MISMATCH vs native");
+            printf("  %s\n", bad ? "MISMATCH vs reference" : "ok");
+            free(A); free(B); free(Bp); free(C); free(Ce);
+        }
+    }
+
+    if (native) amx_tile_release();
+    fclose(fp);
+    preflight_save(&pf, "amx_gemm_results.csv");
+    printf("All results written to amx_gemm_results.csv\n");
+    return 0;
+}
@@ -0,0 +1,386 @@
+// amx_operand_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds amx_operand_bench)
+// Run:     taskset -c 0 ./amx_operand_bench
+//
+// Does the value of an operand change how long the matrix or vector
+// unit takes? amx_bench.c only varies the zero fraction and times one
+// tile op together with its loads and stores. Here every pattern is
+// loaded into registers first, and only a long run of back-to-back
+// compute is timed:
+//   amx_int8     tdpbssd   4 independent accumulators (tmm0..3)
+//   amx_bf16     tdpbf16ps over A tiles tmm4/5 and B tiles tmm6/7
+//   avx512_vnni  vpdpbusd zmm  \ 10 independent accumulators over the
+//   avx512_bf16  vdpbf16ps zmm / first 64 bytes of A and B
+// Patterns cover Hamming weight, sign, zero rows / columns / tiles,
+// bf16 exponent range, denormals and Inf. Each row reports cycles per
+// op (core cycles with perf, TSC ticks without) as min and median of
+// TRIALS, the median's change against the `random` pattern on the same
+// unit, whether the two interquartile ranges separate, and package power
+// from RAPL (common/rapl, powercap or MSR) when the host exposes it. Trials rotate
+// through the patterns so slow drift is shared rather than attributed.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <immintrin.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "isa.h"
+#include "rapl.h"
+#include "amx_gemm.h"
+#include "preflight.h"
+
+#define TRIALS      11
+#define AMX_ITERS   20000     // x 4 tdps
+#define VEC_ITERS   200000    // x 10 vector dot products
+#define POWER_SEC   0.5       // per pattern, only with RAPL
+
+// Two A tiles and two B tiles, 1 KB each. A tiles are row-major 16 x K;
+// B tiles are VNNI: row r, column n occupies bytes r*64 + n*4 .. +3.
+typedef struct {
+    uint8_t a[2][1024] __attribute__((aligned(64)));
+    uint8_t b[2][1024] __attribute__((aligned(64)));
+} operand_set;
+
+// ------------------ Patterns ------------------
+#define T_I8 1
+#define T_BF 2
+
+#define PATTERNS(X)                                                                   \
+    X(random,      T_I8 | T_BF, "uniform int8 / U(-1,1) bf16")                        \
+    X(all_zero,    T_I8 | T_BF, "every element zero")                                 \
+    X(hw1,         T_I8,        "every byte has Hamming weight 1")                    \
+    X(hw2,         T_I8,        "every byte has Hamming weight 2")                    \
+    X(hw4,         T_I8,        "every byte has Hamming weight 4")                    \
+    X(hw6,         T_I8,        "every byte has Hamming weight 6")                    \
+    X(hw8,         T_I8,        "every byte 0xFF (-1)")                               \
+    X(mant_hw0,    T_BF,        "mantissa all zero (powers of two)")                  \
+    X(mant_hw7,    T_BF,        "mantissa all ones")                                  \
+    X(all_pos,     T_I8 | T_BF, "random magnitudes, all positive")                    \
+    X(all_neg,     T_I8 | T_BF, "random magnitudes, all negative")                    \
+    X(alt_sign,    T_I8 | T_BF, "sign alternates element to element")                 \
+    X(zero_rows_a, T_I8 | T_BF, "odd rows of A zero")                                 \
+    X(zero_cols_b, T_I8 | T_BF, "even columns of B zero")                             \
+    X(zero_tile_a, T_I8 | T_BF, "first A tile all zero")                              \
+    X(zero_tile_b, T_I8 | T_BF, "first B tile all zero")                              \
+    X(exp_narrow,  T_BF,        "exponent fixed: values in [1,2)")                    \
+    X(exp_wide,    T_BF,        "exponents 2^-30..2^30")                              \
+    X(exp_tiny,    T_BF,        "exponents 2^-126..2^-100, products flush to zero")   \
+    X(exp_huge,    T_BF,        "exponents 2^70..2^127, products overflow to Inf")    \
+    X(denorm_a,    T_BF,        "A denormal, B random")                               \
+    X(denorm_all,  T_BF,        "A and B denormal")                                   \
+    X(denorm_half, T_BF,        "half of A denormal")                                 \
+    X(inf_a,       T_BF,        "A +-Inf, B random")
+
+#define PAT_ENUM(name, types, desc) PAT_##name,
+enum { PATTERNS(PAT_ENUM) N_PATTERNS };
+#define PAT_ENTRY(name, types, desc) { #name, types, desc },
+static const struct {
+    const char *name;
+    int types;
+    const char *desc;
+} patterns[] = { PATTERNS(PAT_ENTRY) };
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static uint64_t xorshift64(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static uint8_t byte_of_weight(int w) {
+    uint8_t v = 0;
+    while (__builtin_popcount(v) < w) v |= (uint8_t)(1u << (xorshift64() & 7));
+    return v;
+}
+
+static uint16_t bf16(int sign, int exp, int mant) {
+    return (uint16_t)(sign << 15 | exp << 7 | mant);
+}
+
+static int rnd(int lo, int hi) {
+    return lo + (int)(xorshift64() % (uint64_t)(hi - lo + 1));
+}
+
+// one element; `is_b` picks the operand, row/col are the logical
+// position (col = k for A, n for B), `idx` counts elements in memory
+static uint16_t pattern_elem(int pat, amx_dtype t, int is_b, int tile, int row, int col, int idx) {
+    int i8 = t == AMX_INT8;
+    uint16_t random = i8 ? (uint8_t)xorshift64() : amx_f32_to_bf16((float)rnd(-1000, 1000) / 1000.0f);
+    int mag8 = rnd(1, 127);
+    uint16_t magbf = bf16(0, rnd(120, 126), rnd(0, 127));
+    switch (pat) {
+    case PAT_all_zero:    return 0;
+    case PAT_hw1:         return byte_of_weight(1);
+    case PAT_hw2:         return byte_of_weight(2);
+    case PAT_hw4:         return byte_of_weight(4);
+    case PAT_hw6:         return byte_of_weight(6);
+    case PAT_hw8:         return 0xFF;
+    case PAT_mant_hw0:    return bf16(rnd(0, 1), rnd(120, 130), 0);
+    case PAT_mant_hw7:    return bf16(rnd(0, 1), rnd(120, 130), 0x7F);
+    case PAT_all_pos:     return i8 ? mag8 : magbf;
+    case PAT_all_neg:     return i8 ? (uint8_t)-mag8 : (uint16_t)(magbf | 0x8000);
+    case PAT_alt_sign:    return idx & 1 ? (i8 ? (uint8_t)-mag8 : (uint16_t)(magbf | 0x8000))
+                                         : (i8 ? mag8 : magbf);
+    case PAT_zero_rows_a: return !is_b && (row & 1) ? 0 : random;
+    case PAT_zero_cols_b: return is_b && !(col & 1) ? 0 : random;
+    case PAT_zero_tile_a: return !is_b && tile == 0 ? 0 : random;
+    case PAT_zero_tile_b: return is_b && tile == 0 ? 0 : random;
+    case PAT_exp_narrow:  return bf16(rnd(0, 1), 127, rnd(0, 127));
+    case PAT_exp_wide:    return bf16(rnd(0, 1), rnd(97, 157), rnd(0, 127));
+    case PAT_exp_tiny:    return bf16(rnd(0, 1), rnd(1, 27), rnd(0, 127));
+    case PAT_exp_huge:    return bf16(rnd(0, 1), rnd(197, 254), rnd(0, 127));
+    case PAT_denorm_a:    return is_b ? random : bf16(rnd(0, 1), 0, rnd(1, 127));
+    case PAT_denorm_all:  return bf16(rnd(0, 1), 0, rnd(1, 127));
+    case PAT_denorm_half: return !is_b && (idx & 1) ? bf16(rnd(0, 1), 0, rnd(1, 127)) : random;
+    case PAT_inf_a:       return is_b ? random : bf16(rnd(0, 1), 0xFF, 0);
+    default:              return random;
+    }
+}
+
+static void fill_operands(operand_set *s, int pat, amx_dtype t) {
+    size_t es = amx_elem_size(t);
+    for (int tile = 0; tile < 2; tile++)
+        for (int off = 0; off < 1024; off += (int)es) {
+            int row = off / 64, idx = off / (int)es;
+            uint16_t va = pattern_elem(pat, t, 0, tile, row, (off % 64) / (int)es, idx);
+            uint16_t vb = pattern_elem(pat, t, 1, tile, row, (off % 64) / 4, idx);
+            memcpy(&s->a[tile][off], &va, es);
+            memcpy(&s->b[tile][off], &vb, es);
+        }
+}
+
+// ------------------ Compute Loops ------------------
+typedef enum { U_AMX_INT8, U_AMX_BF16, U_VNNI, U_AVX512_BF16, N_UNITS } unit_id;
+static const struct {
+    const char *name;
+    amx_dtype type;
+    int ops_per_iter;
+    long iters;
+} units[] = {
+    { "amx_int8",    AMX_INT8, 4,  AMX_ITERS },
+    { "amx_bf16",    AMX_BF16, 4,  AMX_ITERS },
+    { "avx512_vnni", AMX_INT8, 10, VEC_ITERS },
+    { "avx512_bf16", AMX_BF16, 10, VEC_ITERS },
+};
+
+// operands stay in tmm4..7 for the whole timed run
+static ISA_TARGET_AMX void amx_load_operands(const operand_set *s) {
+    _tile_loadd(4, s->a[0], 64);
+    _tile_loadd(5, s->a[1], 64);
+    _tile_loadd(6, s->b[0], 64);
+    _tile_loadd(7, s->b[1], 64);
+}
+
+static ISA_TARGET_AMX void amx_zero_acc(void) {
+    _tile_zero(0); _tile_zero(1); _tile_zero(2); _tile_zero(3);
+}
+
+#define DEFINE_AMX_LOOP(name, TDP)                          \
+static ISA_TARGET_AMX void name(long iters) {               \
+    for (long i = 0; i < iters; i++) {                      \
+        TDP(0, 4, 6);                                       \
+        TDP(1, 4, 7);                                       \
+        TDP(2, 5, 6);                                       \
+        TDP(3, 5, 7);                                       \
+    }                                                       \
+}
+DEFINE_AMX_LOOP(amx_int8_loop, _tile_dpbssd)
+DEFINE_AMX_LOOP(amx_bf16_loop, _tile_dpbf16ps)
+
+// zmm10 = A bytes 0..63, zmm11 = B bytes 0..63, zmm0..9 accumulate
+#define DEFINE_VEC_LOOP(name, TARGET, insn)                                  \
+static TARGET void name(const operand_set *s, long iters) {                  \
+    __asm__ volatile("vmovdqu64 (%[a]), %%zmm10\n\t"                         \
+                     "vmovdqu64 (%[b]), %%zmm11\n\t"                         \
+                     ".irp r,0,1,2,3,4,5,6,7,8,9\n\t"                        \
+                     "vpxord %%zmm\\r, %%zmm\\r, %%zmm\\r\n\t"               \
+                     ".endr\n\t"                                             \
+                     "1:\n\t"                                                \
+                     ".irp r,0,1,2,3,4,5,6,7,8,9\n\t"                        \
+                     insn " %%zmm11, %%zmm10, %%zmm\\r\n\t"                  \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     "vzeroupper\n\t"                                        \
+                     : [n] "+r"(iters)                                       \
+                     : [a] "r"(s->a[0]), [b] "r"(s->b[0])                    \
+                     : "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5",       \
+                       "xmm6", "xmm7", "xmm8", "xmm9", "xmm10", "xmm11",     \
+                       "cc", "memory");                                      \
+}
+DEFINE_VEC_LOOP(vnni_loop, ISA_TARGET_AVX512_VNNI, "vpdpbusd")
+DEFINE_VEC_LOOP(vbf16_loop, ISA_TARGET_AVX512_BF16, "vdpbf16ps")
+
+static int unit_available(unit_id u, int amx_ok) {
+    switch (u) {
+    case U_AMX_INT8:
+    case U_AMX_BF16:    return amx_ok;
+    case U_VNNI:        return isa_supported(ISA_AVX512_VNNI);
+    case U_AVX512_BF16: return isa_supported(ISA_AVX512_BF16);
+    default:            return 0;
+    }
+}
+
+// `load` (re)loads the AMX operand tiles and clears the accumulators; then
+// runs `iters` iterations of the unit's loop
+static void run_unit(unit_id u, const operand_set *s, long iters, int load) {
+    switch (u) {
+    case U_AMX_INT8:
+        if (load) {
+            amx_load_operands(s);
+            amx_zero_acc();
+        }
+        amx_int8_loop(iters);
+        break;
+    case U_AMX_BF16:
+        if (load) {
+            amx_load_operands(s);
+            amx_zero_acc();
+        }
+        amx_bf16_loop(iters);
+        break;
+    case U_VNNI:        vnni_loop(s, iters); break;
+    case U_AVX512_BF16: vbf16_loop(s, iters); break;
+    default:            break;
+    }
+}
+
+// ------------------ RAPL ------------------
+static rapl rp;
+static int rapl_ok;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// package watts while the unit runs this pattern for POWER_SEC
+static double measure_power(unit_id u, const operand_set *s) {
+    rapl_mark m;
+    rapl_energy e;
+    run_unit(u, s, units[u].iters, 1);
+    rapl_begin(&rp, &m);
+    double t0 = now_sec();
+    do run_unit(u, s, units[u].iters, 0);
+    while (now_sec() - t0 < POWER_SEC);
+    rapl_end(&rp, &m, &e);
+    return e.watts[RAPL_PKG];
+}
+
+// ------------------ Measurement ------------------
+static pmu_counter cycles_ctr = { -1 };
+
+// one trial: cycles per op with the operands already resident
+static double time_trial(unit_id u, const operand_set *s) {
+    long iters = units[u].iters;
+    // reloading the tiles before every trial keeps them outside the
+    // timed region; the vector loop's two loads are amortized
+    run_unit(u, s, 1, 1);
+    uint64_t c0 = pmu_read(&cycles_ctr);
+    uint64_t start = rdtsc_begin();
+    run_unit(u, s, iters, 0);
+    uint64_t end = rdtsc_end();
+    uint64_t c = pmu_ok(&cycles_ctr) ? pmu_read(&cycles_ctr) - c0 : end - start;
+    return (double)c / ((double)iters * units[u].ops_per_iter);
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    static operand_set ops[N_PATTERNS];
+    static double trial[N_PATTERNS][TRIALS];
+    int amx_ok = amx_init() == 0;
+    if (!amx_ok) printf("AMX unavailable: %s; AMX rows skipped\n", amx_unavailable_reason());
+    else amx_tile_config_load();
+
+    if (pmu_open(&cycles_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES))
+        printf("cycles counter unavailable, reporting TSC ticks\n");
+    rapl_ok = rapl_open(&rp, -1) == 0;
+    if (!rapl_ok) printf("RAPL not exposed (no powercap zone or MSR), power column left blank\n");
+    const char *clock = pmu_ok(&cycles_ctr) ? "core" : "tsc";
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("amx_operand_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening amx_operand_results.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_operand.txt", "w");
+    if (!log_fp) log_fp = stdout;
+    fprintf(fp, "unit,pattern,clock,min,median,q1,q3,delta_pct,significant,power_w,status\n");
+
+    for (int u = 0; u < N_UNITS; u++) {
+        int tmask = units[u].type == AMX_INT8 ? T_I8 : T_BF;
+        fprintf(log_fp, "\n=== %s (%s cycles per op) ===\n", units[u].name, clock);
+        if (!unit_available(u, amx_ok)) {
+            fprintf(log_fp, "skipped: not supported by this host or build\n");
+            for (int p = 0; p < N_PATTERNS; p++)
+                if (patterns[p].types & tmask)
+                    fprintf(fp, "%s,%s,%s,,,,,,,,skipped\n", units[u].name, patterns[p].name, clock);
+            continue;
+        }
+        for (int p = 0; p < N_PATTERNS; p++) {
+            if (!(patterns[p].types & tmask)) continue;
+            rng_state = 0x9E3779B97F4A7C15ull ^ (uint64_t)p;
+            fill_operands(&ops[p], p, units[u].type);
+        }
+        // trials rotate through the patterns so drift (frequency, noisy
+        // neighbours) lands on every pattern alike
+        run_unit(u, &ops[PAT_random], units[u].iters, 1); // warm up the unit
+        for (int t = 0; t < TRIALS; t++)
+            for (int p = 0; p < N_PATTERNS; p++)
+                if (patterns[p].types & tmask) trial[p][t] = time_trial(u, &ops[p]);
+
+        fprintf(log_fp, "| %-11s | %-6s | %-6s | %-8s | %-7s | %-49s |\n",
+                "Pattern", "Min", "Median", "vs rand", "Power W", "Operands");
+        fprintf(log_fp, "|-------------|--------|--------|----------|---------|"
+                        "---------------------------------------------------|\n");
+        double *base = trial[PAT_random];
+        qsort(base, TRIALS, sizeof(double), cmp_double);
+        for (int p = 0; p < N_PATTERNS; p++) {
+            if (!(patterns[p].types & tmask)) continue;
+            double *v = trial[p];
+            qsort(v, TRIALS, sizeof(double), cmp_double);
+            double med = v[TRIALS / 2], q1 = v[TRIALS / 4], q3 = v[TRIALS - 1 - TRIALS / 4];
+            double delta = 100.0 * (med - base[TRIALS / 2]) / base[TRIALS / 2];
+            // a shift counts when the interquartile ranges do not overlap
+            int significant = q1 > base[TRIALS - 1 - TRIALS / 4] || q3 < base[TRIALS / 4];
+            double watts = rapl_ok ? measure_power(u, &ops[p]) : -1.0;
+
+            char w_s[16] = "";
+            if (watts >= 0.0) snprintf(w_s, sizeof(w_s), "%.2f", watts);
+            fprintf(fp, "%s,%s,%s,%.3f,%.3f,%.3f,%.3f,%.2f,%s,%s,ok\n", units[u].name,
+                    patterns[p].name, clock, v[0], med, q1, q3, delta, significant ? "yes" : "no",
+                    w_s);
+            fprintf(log_fp, "| %-11s | %-6.2f | %-6.2f | %+7.1f%%%s| %-7s | %-49s |\n",
+                    patterns[p].name, v[0], med, delta, significant ? "*" : " ",
+                    watts >= 0.0 ? w_s : "-", patterns[p].desc);
+        }
+    }
+    fprintf(log_fp, "\n* interquartile range does not overlap that of `random`\n");
+
+    if (amx_ok) amx_tile_release();
+    pmu_close(&cycles_ctr);
+    rapl_close(&rp);
+    fclose(fp);
+    preflight_save(&pf, "amx_operand_results.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    printf("All results written to results_operand.txt and amx_operand_results.csv\n");
+    return 0;
+}
@@ -0,0 +1,343 @@
+// amx_scaling.c
+// ===============================================================
+// Compile: ./compile.sh   (builds amx_scaling)
+// Run:     ./amx_scaling [max_workers]     (default: every allowed CPU)
+//
+// Multi-worker scaling of the matrix and wide-vector units. amx_bench.c
+// runs one thread on core 0; inference hosts run many workers per
+// socket. For every kernel and every worker count 1..max_workers, that
+// many pinned threads run the kernel on register-resident operands for
+// RUN_SEC, started and stopped together:
+//   amx_int8     tdpbssd    32768 int ops per tdp
+//   amx_bf16     tdpbf16ps  16384 flops per tdp
+//   avx512_vnni  vpdpbusd   128 int ops per zmm instruction
+//   avx512_fma   vfmadd231ps 32 flops per zmm instruction
+// Workers are placed two ways (topology.h: sysfs, then CPUID):
+//   spread   one thread per physical core before any SMT sibling
+//   packed   both SMT siblings of a core before the next core
+// so the same worker count shows the cost of siblings sharing one
+// core's AMX unit or vector ports. Each worker reports its own GOPS and
+// core frequency:
+//   perf   cycles over the window, when the counter opens
+//   probe  median of 2000-deep dependent `add reg, reg` chains timed
+//          between kernel chunks (about 1% of the window)
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <immintrin.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "isa.h"
+#include "topology.h"
+#include "clock.h"
+#include "amx_gemm.h"
+#include "preflight.h"
+
+#define RUN_SEC     0.3
+#define WARM_SEC    0.05
+#define MAX_WORKERS TOPO_MAX_CPUS
+#define MAX_PROBES  4096
+
+// ------------------ Kernels ------------------
+typedef enum { K_AMX_INT8, K_AMX_BF16, K_VNNI, K_FMA, N_KERNELS } kernel_id;
+static const struct {
+    const char *name;
+    double ops_per_insn;
+    int insns_per_iter;
+    long chunk;            // iterations between stop-flag checks
+} kernels[] = {
+    { "amx_int8",    32768.0, 4,  2000 },
+    { "amx_bf16",    16384.0, 4,  2000 },
+    { "avx512_vnni", 128.0,   10, 20000 },
+    { "avx512_fma",  32.0,    10, 20000 },
+};
+
+static uint8_t vec_operands[2][64] __attribute__((aligned(64)));
+
+static uint8_t tile_operands[4][1024] __attribute__((aligned(64)));
+
+// per thread: config, operands in tmm4..7, accumulators tmm0..3
+static ISA_TARGET_AMX void amx_prepare(void) {
+    amx_tile_config_load();
+    _tile_loadd(4, tile_operands[0], 64);
+    _tile_loadd(5, tile_operands[1], 64);
+    _tile_loadd(6, tile_operands[2], 64);
+    _tile_loadd(7, tile_operands[3], 64);
+    _tile_zero(0); _tile_zero(1); _tile_zero(2); _tile_zero(3);
+}
+
+#define DEFINE_AMX_LOOP(name, TDP)                          \
+static ISA_TARGET_AMX void name(long iters) {               \
+    for (long i = 0; i < iters; i++) {                      \
+        TDP(0, 4, 6);                                       \
+        TDP(1, 4, 7);                                       \
+        TDP(2, 5, 6);                                       \
+        TDP(3, 5, 7);                                       \
+    }                                                       \
+}
+DEFINE_AMX_LOOP(amx_int8_loop, _tile_dpbssd)
+DEFINE_AMX_LOOP(amx_bf16_loop, _tile_dpbf16ps)
+
+// zmm10/zmm11 operands, zmm0..9 independent accumulators
+#define DEFINE_VEC_LOOP(name, TARGET, insn)                                  \
+static TARGET void name(long iters) {                                        \
+    __asm__ volatile("vmovdqu64 (%[a]), %%zmm10\n\t"                         \
+                     "vmovdqu64 (%[b]), %%zmm11\n\t"                         \
+                     ".irp r,0,1,2,3,4,5,6,7,8,9\n\t"                        \
+                     "vpxord %%zmm\\r, %%zmm\\r, %%zmm\\r\n\t"               \
+                     ".endr\n\t"                                             \
+                     "1:\n\t"                                                \
+                     ".irp r,0,1,2,3,4,5,6,7,8,9\n\t"                        \
+                     insn " %%zmm11, %%zmm10, %%zmm\\r\n\t"                  \
+                     ".endr\n\t"                                             \
+                     "dec %[n]\n\t"                                          \
+                     "jnz 1b\n\t"                                            \
+                     "vzeroupper\n\t"                                        \
+                     : [n] "+r"(iters)                                       \
+                     : [a] "r"(vec_operands[0]), [b] "r"(vec_operands[1])    \
+                     : "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5",       \
+                       "xmm6", "xmm7", "xmm8", "xmm9", "xmm10", "xmm11",     \
+                       "cc", "memory");                                      \
+}
+DEFINE_VEC_LOOP(vnni_loop, ISA_TARGET_AVX512_VNNI, "vpdpbusd")
+DEFINE_VEC_LOOP(fma_loop, ISA_TARGET_AVX512, "vfmadd231ps")
+
+static int kernel_available(kernel_id k, int amx_ok) {
+    switch (k) {
+    case K_AMX_INT8:
+    case K_AMX_BF16: return amx_ok;
+    case K_VNNI:     return isa_supported(ISA_AVX512_VNNI);
+    case K_FMA:      return isa_supported(ISA_AVX512);
+    default:         return 0;
+    }
+}
+
+static void kernel_prepare(kernel_id k) {
+    if (k == K_AMX_INT8 || k == K_AMX_BF16) amx_prepare();
+}
+
+static void kernel_run(kernel_id k, long iters) {
+    switch (k) {
+    case K_AMX_INT8: amx_int8_loop(iters); break;
+    case K_AMX_BF16: amx_bf16_loop(iters); break;
+    case K_VNNI:     vnni_loop(iters); break;
+    case K_FMA:      fma_loop(iters); break;
+    default:         break;
+    }
+}
+
+static void kernel_finish(kernel_id k) {
+    if (k == K_AMX_INT8 || k == K_AMX_BF16) amx_tile_release();
+}
+
+// ------------------ Workers ------------------
+typedef struct {
+    pthread_t  thread;
+    int        index;
+    topo_cpu   where;
+    kernel_id  kernel;
+    int        siblings_busy;  // another worker shares this core
+    // results
+    uint64_t   iters;
+    uint64_t   ticks;          // window minus the frequency probes
+    double     ghz;
+    int        freq_from_perf;
+} worker;
+
+static atomic_int ready_count;
+static atomic_int go_flag;
+static atomic_int stop_flag;
+static double probe_buf[MAX_WORKERS][MAX_PROBES];
+
+static void *worker_main(void *arg) {
+    worker *w = arg;
+    topo_pin_self(w->where.cpu);
+
+    pmu_counter cyc = { -1 };
+    pmu_open(&cyc, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    kernel_prepare(w->kernel);
+    long chunk = kernels[w->kernel].chunk;
+
+    // warm the unit until everyone is pinned and running
+    atomic_fetch_add(&ready_count, 1);
+    while (!atomic_load(&go_flag)) kernel_run(w->kernel, chunk / 10 + 1);
+
+    double *probes = probe_buf[w->index];
+    int n_probes = 0;
+    uint64_t iters = 0, probe_total = 0, c0 = pmu_read(&cyc), t0 = clk_tsc();
+    while (!atomic_load_explicit(&stop_flag, memory_order_relaxed)) {
+        kernel_run(w->kernel, chunk);
+        iters += chunk;
+        if (!pmu_ok(&cyc) && n_probes < MAX_PROBES) {
+            uint64_t p = clk_probe_ticks();
+            probe_total += p;
+            probes[n_probes++] = clk_tsc_ghz() * CLK_PROBE_ADDS / (double)p;
+        }
+    }
+    uint64_t t1 = clk_tsc(), c1 = pmu_read(&cyc);
+    kernel_finish(w->kernel);
+
+    w->iters = iters;
+    w->ticks = t1 - t0 - probe_total;
+    w->freq_from_perf = pmu_ok(&cyc);
+    w->ghz = pmu_ok(&cyc) ? (double)(c1 - c0) / ((double)(t1 - t0) / clk_tsc_ghz())
+                          : n_probes ? median(probes, n_probes) : 0.0;
+    pmu_close(&cyc);
+    return NULL;
+}
+
+static void sleep_sec(double sec) {
+    struct timespec ts = { (time_t)sec, (long)((sec - (time_t)sec) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+// starts n workers on order[0..n-1], runs one window, joins them
+static void run_config(kernel_id k, const topo_cpu *order, int n, worker *w) {
+    atomic_store(&ready_count, 0);
+    atomic_store(&go_flag, 0);
+    atomic_store(&stop_flag, 0);
+    for (int i = 0; i < n; i++) {
+        w[i] = (worker){ .index = i, .where = order[i], .kernel = k };
+        for (int j = 0; j < n; j++)
+            if (j != i && topo_same_core(&order[j], &order[i]))
+                w[i].siblings_busy = 1;
+    }
+    for (int i = 0; i < n; i++) pthread_create(&w[i].thread, NULL, worker_main, &w[i]);
+    while (atomic_load(&ready_count) < n) sleep_sec(0.001);
+    sleep_sec(WARM_SEC);
+    atomic_store(&go_flag, 1);
+    sleep_sec(RUN_SEC);
+    atomic_store(&stop_flag, 1);
+    for (int i = 0; i < n; i++) pthread_join(w[i].thread, NULL);
+}
+
+static double worker_gops(const worker *w) {
+    double sec = (double)w->ticks / (clk_tsc_ghz() * 1e9);
+    return (double)w->iters * kernels[w->kernel].insns_per_iter *
+           kernels[w->kernel].ops_per_insn / sec / 1e9;
+}
+
+// ------------------ Main ------------------
+int main(int argc, char **argv) {
+    static topology topo;
+    static topo_cpu order[2][TOPO_MAX_CPUS];
+    static worker workers[MAX_WORKERS];
+    static const char *placement_name[] = { "spread", "packed" };
+
+    if (topo_load(&topo)) {
+        fprintf(stderr, "Could not read the CPU topology\n");
+        return 1;
+    }
+    int n_cpus = topo.n;
+    int max_workers = argc > 1 ? atoi(argv[1]) : n_cpus;
+    if (max_workers < 1 || max_workers > n_cpus) max_workers = n_cpus;
+    topo_order(&topo, TOPO_SPREAD, order[0]);
+    topo_order(&topo, TOPO_PACKED, order[1]);
+    int has_smt = topo.has_smt;
+
+    clk_calibrate();
+    int amx_ok = amx_init() == 0;
+    if (!amx_ok) printf("AMX unavailable: %s; AMX kernels skipped\n", amx_unavailable_reason());
+    // operands in [0.5, 1) as fp32 and bf16: no denormal products, no
+    // overflow over a window; the integer kernels just see the bytes
+    uint64_t seed = 0x2545F4914F6CDD1Dull;
+    for (size_t i = 0; i < sizeof(vec_operands) / 4; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        float f = 0.5f + (float)(seed % 1000) / 2000.0f;
+        memcpy((uint8_t *)vec_operands + 4 * i, &f, 4);
+    }
+    for (size_t i = 0; i < sizeof(tile_operands) / 2; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        uint16_t b = amx_f32_to_bf16(0.5f + (float)(seed % 1000) / 2000.0f);
+        memcpy((uint8_t *)tile_operands + 2 * i, &b, 2);
+    }
+
+    pmu_counter probe_ctr = { -1 };
+    int perf_ok = pmu_open(&probe_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES) == 0;
+    pmu_close(&probe_ctr);
+    printf("%d CPUs allowed (%s), up to %d workers, frequency from %s, TSC %.3f GHz\n", n_cpus,
+           has_smt ? "SMT siblings present" : "no SMT siblings", max_workers,
+           perf_ok ? "perf cycles" : "add-chain probe", clk_tsc_ghz());
+    topo_describe(&topo, stdout);
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("amx_scaling.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening amx_scaling.csv\n");
+        return 1;
+    }
+    FILE *log_fp = fopen("results_scaling.txt", "w");
+    if (!log_fp) log_fp = stdout;
+    fprintf(fp, "kernel,placement,workers,worker,cpu,package,core,smt_shared,gops,ghz,freq_source\n");
+
+    for (int k = 0; k < N_KERNELS; k++) {
+        fprintf(log_fp, "\n=== %s ===\n", kernels[k].name);
+        if (!kernel_available(k, amx_ok)) {
+            fprintf(log_fp, "skipped: not supported by this host or build\n");
+            continue;
+        }
+        fprintf(log_fp, "| %-7s | %-9s | %-10s | %-10s | %-10s | %-7s | %-10s |\n", "Workers",
+                "Placement", "Total GOPS", "Min/worker", "Avg/worker", "Avg GHz", "Efficiency");
+        fprintf(log_fp, "|---------|-----------|------------|------------|------------|"
+                        "---------|------------|\n");
+        double single = 0.0, smt_pair = 0.0, core_pair = 0.0;
+        for (int n = 1; n <= max_workers; n++) {
+            for (int pl = 0; pl < 2; pl++) {
+                if (pl == 1 && !has_smt) continue;   // identical to spread
+                run_config(k, order[pl], n, workers);
+                double total = 0.0, lo = 0.0, ghz = 0.0;
+                for (int i = 0; i < n; i++) {
+                    const worker *w = &workers[i];
+                    double g = worker_gops(w);
+                    total += g;
+                    ghz += w->ghz;
+                    if (i == 0 || g < lo) lo = g;
+                    fprintf(fp, "%s,%s,%d,%d,%d,%d,%d,%d,%.3f,%.3f,%s\n", kernels[k].name,
+                            placement_name[pl], n, i, w->where.cpu, w->where.package,
+                            w->where.core, w->siblings_busy, g, w->ghz,
+                            w->freq_from_perf ? "perf" : "probe");
+                }
+                ghz /= n;
+                if (n == 1 && pl == 0) single = total;
+                if (n == 2) {
+                    int shared = workers[0].siblings_busy;
+                    if (shared) smt_pair = total;
+                    else        core_pair = total;
+                }
+                fprintf(fp, "%s,%s,%d,total,,,,,%.3f,%.3f,\n", kernels[k].name,
+                        placement_name[pl], n, total, ghz);
+                char eff[16];
+                snprintf(eff, sizeof(eff), "%.1f%%", 100.0 * total / (n * single));
+                fprintf(log_fp, "| %-7d | %-9s | %-10.1f | %-10.1f | %-10.1f | %-7.3f | %-10s |\n",
+                        n, placement_name[pl], total, lo, total / n, ghz, eff);
+            }
+        }
+        fprintf(log_fp, "SMT: 1 worker %.1f GOPS", single);
+        if (core_pair > 0.0) fprintf(log_fp, "; 2 on separate cores %.1f", core_pair);
+        if (smt_pair > 0.0)
+            fprintf(log_fp, "; 2 on sibling threads %.1f (%.0f%% of one core's rate per thread)",
+                    smt_pair, 100.0 * smt_pair / 2.0 / single);
+        else
+            fprintf(log_fp, "; no SMT sibling pair in the allowed CPUs");
+        fprintf(log_fp, "\n");
+    }
+    fprintf(log_fp, "\nEfficiency = total / (workers x single-worker GOPS)\n");
+
+    fclose(fp);
+    preflight_save(&pf, "amx_scaling.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    printf("All results written to results_scaling.txt and amx_scaling.csv\n");
+    return 0;
+}
@@ -1 +1,4 @@
-gcc -O2 -fno-tree-vectorize -march=native -std=c11 -Wall -o amx_bench amx_bench.c
\ No newline at end of file
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I. -I../common -o amx_bench amx_bench.c amx_gemm.c amx_emu.c ../common/isa.c ../common/topology.c ../common/sysfs.c ../common/preflight.c ../common/isolate.c ../common/rapl.c -lm -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I. -I../common -o amx_gemm_bench amx_gemm_bench.c amx_gemm.c amx_emu.c ../common/timing.c ../common/isa.c ../common/preflight.c ../common/sysfs.c -lm -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I. -I../common -o amx_operand_bench amx_operand_bench.c amx_gemm.c amx_emu.c ../common/timing.c ../common/pmu.c ../common/isa.c ../common/rapl.c ../common/preflight.c ../common/sysfs.c -lm -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I. -I../common -o amx_scaling amx_scaling.c amx_gemm.c amx_emu.c ../common/timing.c ../common/pmu.c ../common/clock.c ../common/isa.c ../common/topology.c ../common/sysfs.c ../common/preflight.c -lm -lpthread
@@ -0,0 +1,2 @@
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o itlb_bench itlb_bench.c ../common/timing.c ../common/pmu.c ../common/jit.c ../common/preflight.c ../common/sysfs.c -lpthread
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o tlb_bench tlb_bench.c ../common/cacheprobe.c ../common/chase.c ../common/perturb.c ../common/topology.c ../common/sysfs.c ../common/preflight.c -lpthread
@@ -0,0 +1,169 @@
+// itlb_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds itlb_bench)
+// Run:     taskset -c 0 ./itlb_bench [max_pages]
+//          (2 MB runs need: echo 16 > /proc/sys/vm/nr_hugepages)
+//
+// Instruction-side companion to tlb_bench.c. A 5-byte `jmp` stub is
+// placed on each of N distinct 4 KB code pages (shuffled order, and a
+// different cache-line slot per page); the chain is traversed end to
+// end and timed per jump. The same layout is run on three backings:
+//   4k      anonymous, THP disabled
+//   2m      memfd_create(MFD_HUGETLB | MFD_HUGE_2MB)
+//   2m_thp  2 MB-aligned anonymous + MADV_HUGEPAGE (fallback)
+// Knees in cycles/jump on the 4k backing give ITLB and STLB reach for
+// code; the 2m rows show what remapping hot text onto huge pages buys.
+// Past ~L1I-lines stubs the chain also misses L1I on both backings, so
+// read the 4k - 2m difference, not the raw 4k curve, beyond that point.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "jit.h"
+#include "preflight.h"
+
+#define FOUR_KB     4096
+#define MAX_PAGES   16384        // 64 MB of code pages
+#define TARGET_JMPS (1u << 22)   // jumps per measurement
+#define TRIALS      5
+#define KNEE_RATIO  1.3
+
+typedef void (*chain_fn)(uint64_t laps);
+
+static pmu_counter itlb_ctr = { -1 };
+
+// ------------------ Chain Construction ------------------
+// page order is a fixed-seed shuffle so the next-page fetch is never sequential
+static void shuffle_pages(uint32_t *order, int n) {
+    uint64_t s = 0x17B1u + n;
+    for (int i = 0; i < n; i++) order[i] = i;
+    for (int i = n - 1; i > 0; i--) {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        int j = (int)(s % (uint64_t)(i + 1));
+        uint32_t t = order[i]; order[i] = order[j]; order[j] = t;
+    }
+}
+
+// stub k:    jmp stub_{k+1}
+// last stub: dec rdi ; jnz stub_0 ; ret
+static chain_fn build_chain(jit_buf *code, int n_pages, int backing) {
+    static const uint8_t dec_rdi[] = { 0x48, 0xFF, 0xCF };
+    if (jit_alloc_backed(code, (size_t)n_pages * FOUR_KB, backing)) return NULL;
+
+    uint32_t *order = malloc(n_pages * sizeof(uint32_t));
+    shuffle_pages(order, n_pages);
+    size_t *stub = malloc(n_pages * sizeof(size_t));
+    for (int k = 0; k < n_pages; k++)
+        stub[k] = (size_t)order[k] * FOUR_KB + ((size_t)order[k] * 64) % (FOUR_KB - 64);
+
+    for (int k = 0; k < n_pages; k++) {
+        jit_seek(code, stub[k]);
+        if (k + 1 < n_pages) {
+            jit_jmp(code, stub[k + 1]);
+        } else {
+            jit_emit(code, dec_rdi, sizeof(dec_rdi));
+            jit_jcc(code, JIT_CC_NE, stub[0]);
+            jit_ret(code);
+        }
+    }
+    chain_fn fn = (chain_fn)jit_ptr(code, stub[0]);
+    free(order);
+    free(stub);
+    return jit_seal(code) ? NULL : fn;
+}
+
+// ------------------ Measurement ------------------
+typedef struct {
+    double cycles_per_jump;
+    double itlb_misses_per_jump;   // -1 without PMU
+} itlb_sample;
+
+static int measure_chain(int n_pages, int backing, itlb_sample *out) {
+    jit_buf code;
+    chain_fn fn = build_chain(&code, n_pages, backing);
+    if (!fn) return -1;
+
+    uint64_t laps = TARGET_JMPS / n_pages;
+    if (laps < 4) laps = 4;
+    double cyc[TRIALS], miss[TRIALS];
+    fn(laps < 16 ? laps : 16); // warm up
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t m0 = pmu_read(&itlb_ctr);
+        uint64_t start = rdtsc_begin();
+        fn(laps);
+        uint64_t end = rdtsc_end();
+        miss[t] = (double)(pmu_read(&itlb_ctr) - m0) / (laps * n_pages);
+        cyc[t] = (double)(end - start) / (laps * n_pages);
+    }
+    out->cycles_per_jump = median(cyc, TRIALS);
+    out->itlb_misses_per_jump = pmu_ok(&itlb_ctr) ? median(miss, TRIALS) : -1.0;
+    jit_free(&code);
+    return 0;
+}
+
+// ------------------ Main ------------------
+int main(int argc, char **argv) {
+    static const char *backing_name[] = { "4k", "2m", "2m_thp" };
+    int max_pages = argc > 1 ? atoi(argv[1]) : MAX_PAGES;
+    if (max_pages < 2 || max_pages > MAX_PAGES) max_pages = MAX_PAGES;
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("itlb_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening itlb_results.csv\n");
+        return 1;
+    }
+    fprintf(fp, "backing,pages,code_bytes,cycles_per_jump,itlb_misses_per_jump\n");
+
+    if (pmu_open(&itlb_ctr, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_ITLB |
+                 (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)))
+        printf("iTLB-load-misses counter unavailable, timing only\n");
+
+    int pages[64], n_points = 0;
+    for (int p = 1; p <= max_pages && n_points < 64; p = p < 8 ? p + 1 : p + p / 4)
+        pages[n_points++] = p;
+
+    double cyc_4k[64];
+    int have_2m = 0;
+    for (int b = 0; b < 3; b++) {
+        if (b == 2 && have_2m) break;   // hugetlbfs worked, THP fallback not needed
+        for (int i = 0; i < n_points; i++) {
+            itlb_sample s;
+            if (measure_chain(pages[i], b, &s)) {
+                if (i == 0) printf("%s backing unavailable, skipped\n", backing_name[b]);
+                break;
+            }
+            if (b == 0) cyc_4k[i] = s.cycles_per_jump;
+            if (b == 1) have_2m = 1;
+            fprintf(fp, "%s,%d,%zu,%.3f,%.4f\n", backing_name[b], pages[i],
+                    (size_t)pages[i] * FOUR_KB, s.cycles_per_jump, s.itlb_misses_per_jump);
+        }
+    }
+
+    // First knee: ITLB reach; second: STLB reach (both in 4 KB code pages)
+    int itlb_pages = 0, stlb_pages = 0, level = 0;
+    for (int i = 1; i < n_points && stlb_pages == 0; i++) {
+        if (cyc_4k[i] < cyc_4k[level] * KNEE_RATIO) continue;
+        if (i + 1 < n_points && cyc_4k[i + 1] < cyc_4k[level] * KNEE_RATIO) continue;
+        if (!itlb_pages) itlb_pages = pages[i - 1];
+        else stlb_pages = pages[i - 1];
+        level = i;
+    }
+    printf("=== Instruction TLB reach (4 KB code pages) ===\n");
+    printf("ITLB: ~%d pages (%d KB of code)\n", itlb_pages, itlb_pages * 4);
+    printf("STLB: ~%d pages (%d KB of code)\n", stlb_pages, stlb_pages * 4);
+    printf("Compare 4k vs 2m rows in itlb_results.csv for the huge-page gain\n");
+
+    pmu_close(&itlb_ctr);
+    fclose(fp);
+    preflight_save(&pf, "itlb_results.csv");
+    return 0;
+}
@@ -1,4 +1,5 @@
 #!/bin/bash
 name=$(echo $(hostname) | awk -F'.' '{print $1}')
-gcc -O0 -fno-tree-vectorize -g tlb_bench.c -o tlb_bench
-./tlb_bench > $name/$name.csv
\ No newline at end of file
+sh compile.sh || exit 1
+mkdir -p $name
+./tlb_bench > $name/$name.csv
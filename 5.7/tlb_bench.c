@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <emmintrin.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -7,11 +8,17 @@
 #include <x86intrin.h>
 #include <sys/mman.h>   // mlock
 #include <inttypes.h>
+#include "cacheprobe.h"
+#include "perturb.h"
+#include "topology.h"
+#include "preflight.h"
 
 #define FOUR_KB 4096
 #define TWO_MB 2 * 1024 * 1024
 
 unsigned int junk;
+static cp_calibration cal;   // per-host load latencies; DRAM is the TLB-hit baseline
+static perturb pt;           // reruns loads hit by a switch, interrupt or SMI
 
 typedef struct page_block_t {
     struct page_block_t *prev;
@@ -30,17 +37,18 @@ struct page_block_t *create_block(int num_pages, uint64_t page_size, struct page
 void tlb_levels(FILE *log, int num_pages, uint64_t page_size)
 {
     // printf("=== %d pages @ size %ld ===\n", num_pages, page_size);
-    printf("access_times\n");
+    printf("access_times,translation_ticks\n");
     struct page_block_t *start = create_block(num_pages, page_size, NULL, 0);
     struct page_block_t **head = &start;
     struct page_block_t **prev = &start;
+    struct page_block_t *tail = start;
 
-    // create linked list
+    // create linked list (tail outlives the loop, so prev can point at it)
     for (size_t i = 1; i < num_pages; i++) {
         /* allocate page-aligned blocks */
-        struct page_block_t *p = create_block(num_pages, page_size, *prev, i);
-        prev = &p;
+        tail = create_block(num_pages, page_size, tail, i);
     }
+    prev = &tail;
 
     // make sure we have reference to head node after running through the list
     head = prev;
@@ -50,21 +58,21 @@ void tlb_levels(FILE *log, int num_pages, uint64_t page_size)
         prev = &(*prev)->prev;
     }
 
-    volatile uint64_t b;
     prev = head;
     bool run = true;
     while (run) {
-        _mm_clflush(*prev);
-        uint64_t start_time = __rdtscp(&junk);
-        b = (*prev)->data;
-        uint64_t end_time = __rdtscp(&junk);
+        // the data line is always uncached, so every load is a DRAM access;
+        // what varies is the translation, measured against a DRAM load on
+        // the calibration's 256 TLB-resident pages
+        uint32_t t;
+        PERTURB_SAMPLE(&pt, cp_flush(&(*prev)->data), t = cp_reload(&(*prev)->data));
 
         if (!(*prev)->prev) {
             run = false;
         } else {
             prev = &(*prev)->prev;
         }
-        printf("%lu\n",(end_time - start_time));
+        printf("%u,%.0f\n", t, t - cal.latency[CP_DRAM]);
     }
 }
 
@@ -89,6 +97,18 @@ void test_tlb_levels()
 
 int main(void)
 {
+    static topology topo;
+    if (topo_load(&topo) == 0) topo_pin_self(topo_quiet_cpu(&topo));
+    // the CSV goes to stdout, so the environment report goes with the calibration on stderr
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stderr)) return 1;
+    perturb_open(&pt, -1);
+    if (cp_calibrate(&cal, stderr)) {
+        fprintf(stderr, "cache calibration failed (no CPUID leaf 4)\n");
+        return 1;
+    }
     test_tlb_levels();
+    perturb_summary(&pt, stderr, "tlb_levels");
+    perturb_close(&pt);
     return 0;  
 }
\ No newline at end of file
@@ -1 +1,2 @@
-gcc -O2 -fno-tree-vectorize -march=native -std=c11 -Wall -o rob_bench rob_bench.c 
\ No newline at end of file
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -o rob_bench rob_bench.c
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o stlf_bench stlf_bench.c ../common/timing.c ../common/isa.c ../common/preflight.c ../common/sysfs.c -lpthread
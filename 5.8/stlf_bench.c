@@ -0,0 +1,200 @@
+// stlf_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds stlf_bench)
+// Run:     taskset -c 0 ./stlf_bench
+//
+// Store-to-load forwarding matrix and 4K-aliasing sweep. Each kernel
+// iteration is one latency chain:
+//   store rax -> [base + st]          (vector stores: vmovq rax -> xmm0 first)
+//   load  [base + ld] -> rax
+//   rcx = rax & 0 ; base += rcx       (next addresses depend on the load)
+// so every point is a latency, whether or not the load overlaps the store.
+//   forward: store size x load size (1..64 B) x load offset -8..63 from
+//            the store, with the store aligned, split across a cache line,
+//            or split across a 4 KB page
+//   alias4k: load 4096*k + d bytes from the store (no real overlap), to
+//            expose false dependencies on matching low 12 address bits
+// "extra" is the cost over the same kernel with the load 2 KB away.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+#include "timing.h"
+#include "isa.h"
+#include "preflight.h"
+
+#define ITERS   20000
+#define TRIALS  5
+
+typedef void (*stlf_kernel_fn)(uint8_t *base, long st, long ld, long iters);
+
+// ------------------ Kernels ------------------
+#define ST_1  "mov %%al, (%[b],%[st])\n\t"
+#define ST_2  "mov %%ax, (%[b],%[st])\n\t"
+#define ST_4  "mov %%eax, (%[b],%[st])\n\t"
+#define ST_8  "mov %%rax, (%[b],%[st])\n\t"
+#define ST_16 "vmovq %%rax, %%xmm0\n\tvmovdqu %%xmm0, (%[b],%[st])\n\t"
+#define ST_32 "vmovq %%rax, %%xmm0\n\tvmovdqu %%ymm0, (%[b],%[st])\n\t"
+#define ST_64 "vmovq %%rax, %%xmm0\n\tvmovdqu64 %%zmm0, (%[b],%[st])\n\t"
+
+#define LD_1  "movzbl (%[b],%[ld]), %%eax\n\t"
+#define LD_2  "movzwl (%[b],%[ld]), %%eax\n\t"
+#define LD_4  "mov (%[b],%[ld]), %%eax\n\t"
+#define LD_8  "mov (%[b],%[ld]), %%rax\n\t"
+#define LD_16 "vmovdqu (%[b],%[ld]), %%xmm1\n\tvmovq %%xmm1, %%rax\n\t"
+#define LD_32 "vmovdqu (%[b],%[ld]), %%ymm1\n\tvmovq %%xmm1, %%rax\n\t"
+#define LD_64 "vmovdqu64 (%[b],%[ld]), %%zmm1\n\tvmovq %%xmm1, %%rax\n\t"
+
+#define DEFINE_STLF_KERNEL(s, l)                                               \
+static void stlf_##s##_##l(uint8_t *base, long st, long ld, long iters) {     \
+    __asm__ volatile("xor %%eax, %%eax\n\t"                                    \
+                     "1:\n\t"                                                  \
+                     ST_##s                                                    \
+                     LD_##l                                                    \
+                     "mov %%rax, %%rcx\n\t"                                    \
+                     "and $0, %%rcx\n\t"                                       \
+                     "add %%rcx, %[b]\n\t"                                     \
+                     "dec %[n]\n\t"                                            \
+                     "jnz 1b\n\t"                                              \
+                     "vzeroupper\n\t"                                          \
+                     : [b] "+r"(base), [n] "+r"(iters)                         \
+                     : [st] "r"(st), [ld] "r"(ld)                              \
+                     : "rax", "rcx", "xmm0", "xmm1", "cc", "memory");          \
+}
+
+// Two copies of the size list: the preprocessor will not expand a macro
+// inside its own expansion, and the (store, load) grid nests one in the other.
+#define STORE_SIZES(X, a) X(a, 1) X(a, 2) X(a, 4) X(a, 8) X(a, 16) X(a, 32) X(a, 64)
+#define LOAD_SIZES(X, a)  X(a, 1) X(a, 2) X(a, 4) X(a, 8) X(a, 16) X(a, 32) X(a, 64)
+
+// every kernel ends in vzeroupper; 64-byte accesses also need AVX-512
+#define PAIR_ISA(s, l) ((s) == 64 || (l) == 64 ? ISA_AVX512 : ISA_AVX)
+
+#define DEFINE_ROW(_, s)  LOAD_SIZES(DEFINE_PAIR, s)
+#define DEFINE_PAIR(s, l) DEFINE_STLF_KERNEL(s, l)
+STORE_SIZES(DEFINE_ROW, _)
+
+#define ENTRY_ROW(_, s)   LOAD_SIZES(ENTRY_PAIR, s)
+#define ENTRY_PAIR(s, l)  { s, l, PAIR_ISA(s, l), stlf_##s##_##l },
+static const struct { int st, ld; isa_feature isa; stlf_kernel_fn fn; } kernels[] = {
+    STORE_SIZES(ENTRY_ROW, _)
+};
+#define N_KERNELS (int)(sizeof(kernels) / sizeof(kernels[0]))
+
+// ------------------ Measurement ------------------
+static uint8_t *arena;   // 4 pages; base points at the second one
+
+static double time_kernel(stlf_kernel_fn fn, long st, long ld) {
+    double s[TRIALS];
+    uint8_t *base = arena + 4096;
+    fn(base, st, ld, ITERS / 10); // warm up
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t start = rdtsc_begin();
+        fn(base, st, ld, ITERS);
+        uint64_t end = rdtsc_end();
+        s[t] = (double)(end - start) / ITERS;
+    }
+    return median(s, TRIALS);
+}
+
+static const char *overlap_class(int st_size, int ld_size, long rel) {
+    if (rel >= st_size || rel + ld_size <= 0) return "none";
+    if (rel >= 0 && rel + ld_size <= st_size) return "contained";
+    return "partial";
+}
+
+// ------------------ Test 1: Forwarding Matrix ------------------
+static void forward_matrix(FILE *fp) {
+    static const char *placement[] = { "aligned", "line_split", "page_split" };
+
+    printf("=== Test 1: Store-to-Load Forwarding Matrix ===\n");
+    for (int k = 0; k < N_KERNELS; k++) {
+        int ss = kernels[k].st, ls = kernels[k].ld;
+        char name[48];
+        snprintf(name, sizeof(name), "store %2d B -> load %2d B", ss, ls);
+        if (!isa_require(kernels[k].isa, name, NULL)) continue;
+        double worst_contained = -1.0;   // stays negative when the load never fits
+        for (int p = 0; p < 3; p++) {
+            long st = p == 0 ? 2048 : p == 1 ? 2048 + 64 - ss / 2 : 4096 - ss / 2;
+            double base = time_kernel(kernels[k].fn, st, st + 2048 - 64);
+            for (long rel = -8; rel < 64; rel++) {
+                double c = time_kernel(kernels[k].fn, st, st + rel);
+                const char *cls = overlap_class(ss, ls, rel);
+                long ld = st + rel;
+                int ld_line_split = (ld >> 6) != ((ld + ls - 1) >> 6);
+                int ld_page_split = (ld >> 12) != ((ld + ls - 1) >> 12);
+                fprintf(fp, "forward,%s,%d,%d,%ld,%s,%d,%d,%.2f,%.2f\n", placement[p], ss, ls,
+                        rel, cls, ld_line_split, ld_page_split, c, c - base);
+                if (!strcmp(cls, "contained") && c - base > worst_contained)
+                    worst_contained = c - base > 0.0 ? c - base : 0.0;
+            }
+        }
+        if (worst_contained < 0.0)
+            printf("store %2d B -> load %2d B: load never contained, see partial rows\n", ss, ls);
+        else
+            printf("store %2d B -> load %2d B: worst contained-load extra %.1f cycles\n",
+                   ss, ls, worst_contained);
+    }
+}
+
+// ------------------ Test 2: 4K Aliasing ------------------
+static void alias_sweep(FILE *fp) {
+    static const int pairs[][2] = { { 4, 4 }, { 8, 8 }, { 32, 32 }, { 8, 4 } };
+
+    printf("=== Test 2: 4K Aliasing (load 4096*k + d past the store) ===\n");
+    for (unsigned i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++) {
+        stlf_kernel_fn fn = NULL;
+        char name[48];
+        snprintf(name, sizeof(name), "store %2d B / load %2d B", pairs[i][0], pairs[i][1]);
+        for (int k = 0; k < N_KERNELS; k++)
+            if (kernels[k].st == pairs[i][0] && kernels[k].ld == pairs[i][1] &&
+                isa_require(kernels[k].isa, name, NULL))
+                fn = kernels[k].fn;
+        if (!fn) continue;
+
+        long st = 1024;
+        double base = time_kernel(fn, st, st + 2048);
+        double peak = 0.0;
+        for (long dist = 4096; dist <= 8192; dist += 4096) {
+            for (long d = -64; d <= 64; d++) {
+                double c = time_kernel(fn, st, st + dist + d);
+                fprintf(fp, "alias4k,distance_%ld,%d,%d,%ld,%s,0,0,%.2f,%.2f\n", dist,
+                        pairs[i][0], pairs[i][1], d, overlap_class(pairs[i][0], pairs[i][1], d),
+                        c, c - base);
+                if (c - base > peak) peak = c - base;
+            }
+        }
+        printf("store %2d B / load %2d B: worst 4K-alias extra %.1f cycles\n",
+               pairs[i][0], pairs[i][1], peak);
+    }
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    arena = aligned_alloc(4096, 4 * 4096);
+    memset(arena, 0, 4 * 4096);
+
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("stlf_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening stlf_results.csv\n");
+        return 1;
+    }
+    fprintf(fp, "test,placement,store_size,load_size,offset,overlap,load_line_split,"
+                "load_page_split,cycles,extra_cycles\n");
+
+    forward_matrix(fp);
+    alias_sweep(fp);
+
+    fclose(fp);
+    preflight_save(&pf, "stlf_results.csv");
+    free(arena);
+    printf("All results written to stlf_results.csv (plot with stlf_heatmap.py)\n");
+    return 0;
+}
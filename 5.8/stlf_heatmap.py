@@ -0,0 +1,46 @@
+import sys
+import numpy as np
+import pandas as pd
+import matplotlib.pyplot as plt
+
+# Usage: python stlf_heatmap.py <host>/stlf_results.csv
+file_path = sys.argv[1] if len(sys.argv) > 1 else "stlf_results.csv"
+data = pd.read_csv(file_path)
+
+# ------------------------------
+# Forwarding matrix: one heatmap per store placement
+# rows = (store size, load size), columns = load offset from the store
+# ------------------------------
+fwd = data[data["test"] == "forward"].copy()
+fwd["pair"] = fwd["store_size"].astype(str) + "B -> " + fwd["load_size"].astype(str) + "B"
+placements = fwd["placement"].unique()
+
+fig, axes = plt.subplots(1, len(placements), figsize=(6 * len(placements), 12), sharey=True)
+axes = np.atleast_1d(axes)
+for ax, placement in zip(axes, placements):
+    sub = fwd[fwd["placement"] == placement]
+    grid = sub.pivot_table(index=["store_size", "load_size"], columns="offset",
+                           values="extra_cycles")
+    im = ax.imshow(grid.values, aspect="auto", cmap="magma", vmin=0)
+    ax.set_title(placement, fontsize=13, weight="bold")
+    ax.set_xlabel("load offset from store (bytes)")
+    ax.set_xticks(range(0, len(grid.columns), 8))
+    ax.set_xticklabels(grid.columns[::8])
+    ax.set_yticks(range(len(grid.index)))
+    ax.set_yticklabels([f"{s}B -> {l}B" for s, l in grid.index], fontsize=7)
+fig.colorbar(im, ax=axes.tolist(), label="extra cycles vs. no overlap")
+plt.suptitle("Store-to-Load Forwarding Penalty", fontsize=15, weight="bold")
+
+# ------------------------------
+# 4K aliasing: extra cycles vs low-bit distance
+# ------------------------------
+alias = data[data["test"] == "alias4k"]
+plt.figure(figsize=(10, 5))
+for (dist, st, ld), sub in alias.groupby(["placement", "store_size", "load_size"]):
+    plt.plot(sub["offset"], sub["extra_cycles"], label=f"{dist}: {st}B -> {ld}B")
+plt.xlabel("load address - (store address + 4096*k)  (bytes)")
+plt.ylabel("extra cycles")
+plt.title("4K Aliasing False Dependencies")
+plt.grid(True, linestyle="--", alpha=0.5)
+plt.legend(fontsize=8)
+plt.show()
@@ -1 +1,2 @@
-gcc -O2 -fno-tree-vectorize -march=native -std=c11 -Wall -o super_scalar super_scalar_bench.c
\ No newline at end of file
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -o super_scalar superscalar_bench.c
+gcc -O2 -fno-tree-vectorize -std=c11 -Wall -I../common -o frontend_test frontend_bench.c ../common/timing.c ../common/pmu.c ../common/jit.c ../common/preflight.c ../common/sysfs.c -lpthread
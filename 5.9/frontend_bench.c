@@ -0,0 +1,310 @@
+// frontend_bench.c
+// ===============================================================
+// Compile: ./compile.sh   (builds frontend_test)
+// Run:     taskset -c 0 ./frontend_test
+//
+// Front-end characterization with runtime-generated loops:
+//   top: <body: B bytes of one instruction mix> ; dec rdi ; jnz top ; ret
+//   1: IPC vs body size (64 B .. 8 MB) for every instruction-length mix
+//      -> LSD / DSB (uop cache) / legacy decode / L1I / ITLB knees
+//   2: IPC vs loop start offset within a 64 B line, with the number of
+//      instructions straddling 32 B and 64 B windows for each layout
+//
+// When the PMU is usable the uop source split (LSD.UOPS, IDQ.DSB_UOPS,
+// IDQ.MITE_UOPS) and core cycles come from perf; otherwise IPC is per TSC
+// tick and the DSB, L1I and ITLB boundaries are inferred from IPC knees
+// alone. An LSD-served loop runs at the same IPC as a DSB-served one, so
+// without the PMU the LSD column reads n/a.
+// ===============================================================
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <cpuid.h>
+#include <linux/perf_event.h>
+#include "timing.h"
+#include "pmu.h"
+#include "jit.h"
+#include "preflight.h"
+
+#define TARGET_INSTRS  (16u << 20)   // dynamic instructions per measurement
+#define TRIALS         3
+#define KNEE_RATIO     0.85          // IPC drop that counts as a boundary
+
+typedef void (*loop_fn)(uint64_t iters);
+
+// ------------------ Instruction Mixes ------------------
+enum { NOP1, NOP2, NOP4, NOP7, NOP9, NOP11, NOP15, ADD7 };
+
+static const uint8_t nop_bytes[][15] = {
+    [NOP1]  = { 0x90 },
+    [NOP2]  = { 0x66, 0x90 },
+    [NOP4]  = { 0x0F, 0x1F, 0x40, 0x00 },
+    [NOP7]  = { 0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00 },
+    [NOP9]  = { 0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    [NOP11] = { 0x66, 0x66, 0x2E, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    [NOP15] = { 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x2E, 0x0F, 0x1F, 0x84,
+                0x00, 0x00, 0x00, 0x00, 0x00 },
+};
+static const int insn_len[] = { 1, 2, 4, 7, 9, 11, 15, 7 };
+
+typedef struct {
+    const char *name;
+    int kinds[4];
+    int n_kinds;
+} insn_mix;
+
+static const insn_mix mixes[] = {
+    { "nop1",      { NOP1 }, 1 },
+    { "nop2",      { NOP2 }, 1 },
+    { "nop4",      { NOP4 }, 1 },
+    { "nop7",      { NOP7 }, 1 },
+    { "nop9",      { NOP9 }, 1 },
+    { "nop11",     { NOP11 }, 1 },
+    { "nop15",     { NOP15 }, 1 },
+    { "add_imm32", { ADD7 }, 1 },
+    { "mix_1_9",   { NOP1, NOP9 }, 2 },
+    { "mix_2_4_7", { NOP2, NOP4, NOP7, ADD7 }, 4 },
+};
+#define N_MIXES (int)(sizeof(mixes) / sizeof(mixes[0]))
+
+// add r, imm32 over 8 caller-saved registers so the chain never limits IPC
+static void emit_add7(jit_buf *j, int reg) {
+    static const uint8_t rex[8]   = { 0x48, 0x48, 0x48, 0x48, 0x49, 0x49, 0x49, 0x49 };
+    static const uint8_t modrm[8] = { 0xC0, 0xC1, 0xC2, 0xC6, 0xC0, 0xC1, 0xC2, 0xC3 }; // rax rcx rdx rsi r8-r11
+    uint8_t b[7] = { rex[reg], 0x81, modrm[reg], 0x01, 0x00, 0x00, 0x00 };
+    jit_emit(j, b, sizeof(b));
+}
+
+// ------------------ Code Generation ------------------
+typedef struct {
+    jit_buf code;
+    loop_fn fn;
+    uint64_t instrs;   // per iteration, including dec/jnz
+    int cross32, cross64;
+    int jcc_on_32b;    // loop branch crosses or ends on a 32 B boundary
+} frontend_loop;
+
+static int build_loop(frontend_loop *l, const insn_mix *mix, size_t body_bytes, size_t offset) {
+    static const uint8_t dec_rdi[] = { 0x48, 0xFF, 0xCF };
+    size_t start = 4096 + offset;
+    size_t size = (start + body_bytes + 4096 + 4095) & ~(size_t)4095;
+    if (jit_alloc(&l->code, size)) return -1;
+
+    l->instrs = 2;
+    l->cross32 = l->cross64 = 0;
+    jit_seek(&l->code, start);
+    size_t end = start + body_bytes;
+    for (int k = 0, reg = 0; ; k++) {
+        int kind = mix->kinds[k % mix->n_kinds];
+        size_t here = jit_here(&l->code);
+        if (here + insn_len[kind] > end) break;
+        if (kind == ADD7) emit_add7(&l->code, reg++ & 7);
+        else jit_emit(&l->code, nop_bytes[kind], insn_len[kind]);
+        l->cross32 += (here >> 5) != ((here + insn_len[kind] - 1) >> 5);
+        l->cross64 += (here >> 6) != ((here + insn_len[kind] - 1) >> 6);
+        l->instrs++;
+    }
+    size_t pad = end - jit_here(&l->code);
+    l->instrs += pad;                 // padded with single-byte nops
+    for (size_t i = 0; i < pad; i++) jit_emit8(&l->code, 0x90);
+
+    jit_emit(&l->code, dec_rdi, sizeof(dec_rdi));
+    size_t jcc = jit_here(&l->code);
+    jit_jcc(&l->code, JIT_CC_NE, start);
+    l->jcc_on_32b = (jcc >> 5) != ((jcc + 6) >> 5) || ((jcc + 6) & 31) == 0;
+    jit_ret(&l->code);
+
+    l->fn = (loop_fn)jit_ptr(&l->code, start);
+    return jit_seal(&l->code);
+}
+
+// ------------------ Measurement ------------------
+static pmu_counter cycles_ctr = { -1 };
+static pmu_counter lsd_ctr = { -1 }, dsb_ctr = { -1 }, mite_ctr = { -1 };
+
+typedef struct {
+    double ipc;
+    double lsd, dsb, mite;   // uop source fractions (-1 without PMU)
+} frontend_sample;
+
+static frontend_sample measure_loop(const frontend_loop *l) {
+    uint64_t iters = TARGET_INSTRS / l->instrs;
+    if (iters < 8) iters = 8;
+
+    double ipc[TRIALS];
+    uint64_t u_lsd = 0, u_dsb = 0, u_mite = 0;
+    l->fn(iters > 64 ? 64 : iters); // warm up caches and TLBs
+    for (int t = 0; t < TRIALS; t++) {
+        uint64_t c0 = pmu_read(&cycles_ctr);
+        uint64_t l0 = pmu_read(&lsd_ctr), d0 = pmu_read(&dsb_ctr), m0 = pmu_read(&mite_ctr);
+        uint64_t start = rdtsc_begin();
+        l->fn(iters);
+        uint64_t end = rdtsc_end();
+        uint64_t cycles = pmu_ok(&cycles_ctr) ? pmu_read(&cycles_ctr) - c0 : end - start;
+        u_lsd += pmu_read(&lsd_ctr) - l0;
+        u_dsb += pmu_read(&dsb_ctr) - d0;
+        u_mite += pmu_read(&mite_ctr) - m0;
+        ipc[t] = (double)(l->instrs * iters) / cycles;
+    }
+
+    frontend_sample s = { median(ipc, TRIALS), -1.0, -1.0, -1.0 };
+    uint64_t total = u_lsd + u_dsb + u_mite;
+    if (pmu_ok(&dsb_ctr) && total) {
+        s.lsd = (double)u_lsd / total;
+        s.dsb = (double)u_dsb / total;
+        s.mite = (double)u_mite / total;
+    }
+    return s;
+}
+
+// ------------------ L1I size from CPUID leaf 4 ------------------
+static size_t l1i_bytes(void) {
+    unsigned eax, ebx, ecx, edx;
+    for (int i = 0; ; i++) {
+        __cpuid_count(4, i, eax, ebx, ecx, edx);
+        unsigned type = eax & 0x1F;
+        if (type == 0) break;
+        if (type == 2 && ((eax >> 5) & 0x7) == 1)
+            return (size_t)((ebx & 0xFFF) + 1) * (((ebx >> 22) & 0x3FF) + 1) * (ecx + 1);
+    }
+    return 32 * 1024;
+}
+
+// ------------------ Test 1: Code Size x Instruction Mix ------------------
+static const size_t sizes[] = {
+    64, 128, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288,
+    16384, 24576, 32768, 49152, 65536, 131072, 262144, 524288,
+    1u << 20, 2u << 20, 4u << 20, 8u << 20
+};
+#define N_SIZES (int)(sizeof(sizes) / sizeof(sizes[0]))
+
+static void log_row(FILE *fp, const char *test, const insn_mix *mix, size_t bytes, size_t offset,
+                    const frontend_loop *l, frontend_sample s) {
+    fprintf(fp, "%s,%s,%zu,%zu,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%s\n",
+            test, mix->name, bytes, offset, (unsigned long long)l->instrs, s.ipc,
+            s.ipc * (bytes + 9) / l->instrs, s.lsd, s.dsb, s.mite,
+            l->cross32, l->cross64, l->jcc_on_32b, pmu_ok(&cycles_ctr) ? "core" : "tsc");
+}
+
+static void size_sweep(FILE *fp, FILE *log_fp) {
+    size_t l1i = l1i_bytes();
+
+    fprintf(log_fp, "=== Test 1: IPC vs Code Size (L1I = %zu KB) ===\n", l1i / 1024);
+    fprintf(log_fp, "Largest loop body (bytes) still served by each level; 0 = not observed, "
+                    "n/a = needs the PMU\n");
+    fprintf(log_fp, "%-10s %8s %8s %8s %8s %10s %12s\n", "mix", "LSD", "DSB", "L1I", "ITLB",
+            "legacy IPC", "legacy B/cyc");
+    for (int m = 0; m < N_MIXES; m++) {
+        double ipc[N_SIZES], dsb_frac[N_SIZES], lsd_frac[N_SIZES];
+        for (int i = 0; i < N_SIZES; i++) {
+            frontend_loop l;
+            if (build_loop(&l, &mixes[m], sizes[i], 0)) { perror("jit"); return; }
+            frontend_sample s = measure_loop(&l);
+            log_row(fp, "size", &mixes[m], sizes[i], 0, &l, s);
+            ipc[i] = s.ipc;
+            dsb_frac[i] = s.dsb;
+            lsd_frac[i] = s.lsd;
+            jit_free(&l.code);
+        }
+
+        // Knees: sizes after which IPC falls by more than KNEE_RATIO
+        size_t lsd_end = 0, dsb_end = 0, l1i_end = 0, itlb_end = 0;
+        if (lsd_frac[0] >= 0.0) {
+            for (int i = 0; i < N_SIZES; i++) {
+                if (lsd_frac[i] > 0.5) lsd_end = sizes[i];
+                if (dsb_frac[i] + lsd_frac[i] > 0.5) dsb_end = sizes[i];
+            }
+        }
+        // a knee must hold for two consecutive sizes against the median of
+        // the plateau since the previous knee, so one noisy point is ignored
+        int level_start = 0;
+        for (int i = 1; i < N_SIZES; i++) {
+            double level = median(&ipc[level_start], i - level_start);
+            if (ipc[i] >= level * KNEE_RATIO) continue;
+            if (i + 1 < N_SIZES && ipc[i + 1] >= level * KNEE_RATIO) continue;
+            if (!dsb_end && sizes[i] <= l1i) dsb_end = sizes[i - 1];
+            else if (!l1i_end && sizes[i] > l1i && sizes[i - 1] <= 2 * l1i) l1i_end = sizes[i - 1];
+            else if (!itlb_end && sizes[i - 1] >= 4 * l1i) itlb_end = sizes[i - 1];
+            level_start = i;
+        }
+
+        // Legacy decode: median IPC between the DSB knee and the L1I size
+        double legacy[N_SIZES];
+        int nl = 0;
+        for (int i = 0; i < N_SIZES; i++)
+            if (sizes[i] > dsb_end && sizes[i] <= l1i) legacy[nl++] = ipc[i];
+        double legacy_ipc = nl ? median(legacy, nl) : 0.0;
+
+        double avg_len = 0.0;
+        for (int k = 0; k < mixes[m].n_kinds; k++) avg_len += insn_len[mixes[m].kinds[k]];
+        avg_len /= mixes[m].n_kinds;
+
+        char lsd_s[24] = "n/a";
+        if (lsd_frac[0] >= 0.0) snprintf(lsd_s, sizeof(lsd_s), "%zu", lsd_end);
+        fprintf(log_fp, "%-10s %8s %8zu %8zu %8zu %10.2f %12.2f\n", mixes[m].name, lsd_s,
+                dsb_end, l1i_end, itlb_end, legacy_ipc, legacy_ipc * avg_len);
+    }
+    fprintf(log_fp, "\n");
+}
+
+// ------------------ Test 2: Alignment / Window Crossings ------------------
+static void alignment_sweep(FILE *fp, FILE *log_fp) {
+    static const int align_mixes[] = { 3, 7, 8, 9 };   // nop7, add_imm32, mix_1_9, mix_2_4_7
+    fprintf(log_fp, "=== Test 2: IPC vs Loop Start Offset (192 B body) ===\n");
+    for (int a = 0; a < 4; a++) {
+        const insn_mix *mix = &mixes[align_mixes[a]];
+        double best = 0.0, worst = 1e9;
+        size_t best_off = 0, worst_off = 0;
+        for (size_t off = 0; off < 64; off++) {
+            frontend_loop l;
+            if (build_loop(&l, mix, 192, off)) { perror("jit"); return; }
+            frontend_sample s = measure_loop(&l);
+            log_row(fp, "align", mix, 192, off, &l, s);
+            if (s.ipc > best) { best = s.ipc; best_off = off; }
+            if (s.ipc < worst) { worst = s.ipc; worst_off = off; }
+            jit_free(&l.code);
+        }
+        fprintf(log_fp, "%-10s best IPC %.2f @ +%zu, worst %.2f @ +%zu\n",
+                mix->name, best, best_off, worst, worst_off);
+    }
+}
+
+// ------------------ Main ------------------
+int main(void) {
+    static preflight pf;
+    if (preflight_gate(&pf, -1, stdout)) return 1;
+
+    FILE *fp = fopen("frontend_results.csv", "w");
+    if (!fp) {
+        fprintf(stderr, "Error opening frontend_results.csv\n");
+        return 1;
+    }
+    fprintf(fp, "test,mix,body_bytes,offset,instrs_per_iter,ipc,bytes_per_cycle,"
+                "lsd_frac,dsb_frac,mite_frac,cross32,cross64,jcc_on_32b,clock\n");
+
+    if (pmu_open(&cycles_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES))
+        printf("cycles counter unavailable, IPC is per TSC tick\n");
+    // raw event | umask << 8: LSD.UOPS, IDQ.DSB_UOPS, IDQ.MITE_UOPS
+    if (pmu_open_raw(&lsd_ctr, 0x01A8) || pmu_open_raw(&dsb_ctr, 0x0879) ||
+        pmu_open_raw(&mite_ctr, 0x0479)) {
+        pmu_close(&lsd_ctr); pmu_close(&dsb_ctr); pmu_close(&mite_ctr);
+        printf("uop source counters unavailable, inferring DSB/L1I/ITLB from IPC knees (LSD n/a)\n");
+    }
+
+    FILE *log_fp = fopen("results_frontend.txt", "w");
+    if (!log_fp) log_fp = stdout;
+
+    size_sweep(fp, log_fp);
+    alignment_sweep(fp, log_fp);
+
+    pmu_close(&cycles_ctr);
+    pmu_close(&lsd_ctr); pmu_close(&dsb_ctr); pmu_close(&mite_ctr);
+    fclose(fp);
+    preflight_save(&pf, "frontend_results.csv");
+    if (log_fp != stdout) fclose(log_fp);
+    printf("All results written to results_frontend.txt and frontend_results.csv\n");
+    return 0;
+}
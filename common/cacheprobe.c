@@ -0,0 +1,375 @@
+// cacheprobe.c
+// ===============================================================
+// Calibration puts CAL_LINES lines (one per page, shuffled order) in a
+// known state and times each of them, CAL_ROUNDS times:
+//   L1    loaded right before the timed load
+//   L2    loaded, then 2 x L1D of other data streamed past
+//   LLC   loaded, then 2 x L2 of other data streamed past
+//   DRAM  clflush + mfence
+// Each threshold is the cut between adjacent levels that misclassifies
+// the fewest samples of the two histograms (the middle of the valley
+// when several cuts tie).
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cpuid.h>
+#include <sys/mman.h>
+#include "cacheprobe.h"
+#include "chase.h"
+
+#define PAGE        4096
+#define CAL_LINES   256
+#define CAL_ROUNDS  8
+#define CAL_SAMPLES (CAL_LINES * CAL_ROUNDS)
+#define HIST_MAX    4096
+
+static const char *level_names[CP_LEVELS] = { "L1", "L2", "LLC", "DRAM" };
+
+const char *cp_level_name(cp_level l) {
+    return l >= 0 && l < CP_LEVELS ? level_names[l] : "?";
+}
+
+static inline uint64_t tsc_fenced(void) {
+    unsigned a, d;
+    __asm__ volatile("lfence\n\trdtsc\n\tlfence" : "=a"(a), "=d"(d) :: "memory");
+    return ((uint64_t)d << 32) | a;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t rng_next(uint32_t bound) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state % bound);
+}
+
+static void shuffle(void **v, int n) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = rng_next(i + 1);
+        void *t = v[i]; v[i] = v[j]; v[j] = t;
+    }
+}
+
+// circular chase through v[0..n-1] in array order
+static void link_chase(void **v, int n) {
+    for (int i = 0; i < n; i++) *(void **)v[i] = v[(i + 1) % n];
+}
+
+static void *walk(void *p, int steps) {
+    for (int i = 0; i < steps; i++) p = *(void **)p;
+    return p;
+}
+
+// ------------------ Geometry ------------------
+static int read_geometry(cp_calibration *c) {
+    if (__get_cpuid_max(0, NULL) < 4) return -1;
+    for (unsigned sub = 0; sub < 16; sub++) {
+        unsigned eax, ebx, ecx, edx;
+        __cpuid_count(4, sub, eax, ebx, ecx, edx);
+        unsigned type = eax & 0x1F, level = (eax >> 5) & 0x7;
+        if (!type) break;
+        if (type == 2 || level < 1 || level > 3) continue;   // instruction cache
+        cp_cache *k = &c->cache[level - 1];
+        k->line = (ebx & 0xFFF) + 1;
+        k->ways = ((ebx >> 22) & 0x3FF) + 1;
+        k->sets = ecx + 1;
+        k->size = (size_t)k->line * k->ways * k->sets;
+    }
+    return c->cache[CP_L1].size && c->cache[CP_L2].size ? 0 : -1;
+}
+
+// ------------------ Thresholds ------------------
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double median_u32(const uint32_t *v, int n) {
+    uint32_t *tmp = malloc(n * sizeof(uint32_t));
+    memcpy(tmp, v, n * sizeof(uint32_t));
+    qsort(tmp, n, sizeof(uint32_t), cmp_u32);
+    double m = tmp[n / 2];
+    free(tmp);
+    return m;
+}
+
+// cut t with fast <= t < slow that misclassifies the fewest samples
+static uint32_t split(const uint32_t *fast, int nf, const uint32_t *slow, int ns, double *err) {
+    static uint32_t hf[HIST_MAX], hs[HIST_MAX];
+    memset(hf, 0, sizeof(hf));
+    memset(hs, 0, sizeof(hs));
+    for (int i = 0; i < nf; i++) hf[fast[i] < HIST_MAX ? fast[i] : HIST_MAX - 1]++;
+    for (int i = 0; i < ns; i++) hs[slow[i] < HIST_MAX ? slow[i] : HIST_MAX - 1]++;
+    long fast_le = 0, slow_le = 0, best = -1;
+    uint32_t lo = 0, hi = 0;
+    for (uint32_t t = 0; t < HIST_MAX; t++) {
+        fast_le += hf[t];
+        slow_le += hs[t];
+        long wrong = (nf - fast_le) + slow_le;
+        if (best < 0 || wrong < best) { best = wrong; lo = hi = t; }
+        else if (wrong == best && hi == t - 1) hi = t;
+    }
+    *err = (double)best / (nf + ns);
+    return (lo + hi) / 2;
+}
+
+// ------------------ Calibration ------------------
+typedef struct {
+    void    **lines;        // CAL_LINES targets, shuffled
+    uint8_t  *stream;       // 2 x L2 of filler
+    size_t    l1_stream, l2_stream;
+} cal_set;
+
+static void stream_past(const cal_set *s, size_t bytes) {
+    volatile uint8_t sink = 0;
+    for (size_t i = 0; i < bytes; i += CP_LINE) sink ^= s->stream[i];
+    (void)sink;
+}
+
+static void put_in(const cal_set *s, cp_level level) {
+    for (int i = 0; i < CAL_LINES; i++) {
+        if (level == CP_DRAM) _mm_clflush(s->lines[i]);
+        else (void)*(volatile char *)s->lines[i];
+    }
+    if (level == CP_L2) stream_past(s, s->l1_stream);
+    if (level == CP_LLC) stream_past(s, s->l2_stream);
+    _mm_mfence();
+}
+
+static void sample_level(const cal_set *s, cp_level level, uint32_t *single, uint32_t *batch) {
+    for (int r = 0; r < CAL_ROUNDS; r++) {
+        uint32_t *out = single + r * CAL_LINES;
+        if (level == CP_L1) {
+            for (int i = 0; i < CAL_LINES; i++) {
+                (void)*(volatile char *)s->lines[i];
+                out[i] = cp_reload(s->lines[i]);
+            }
+        } else {
+            put_in(s, level);
+            for (int i = 0; i < CAL_LINES; i++) out[i] = cp_reload(s->lines[i]);
+        }
+        put_in(s, level);
+        cp_reload_batch((const void *const *)s->lines, CAL_LINES, batch + r * CAL_LINES);
+    }
+}
+
+int cp_calibrate(cp_calibration *c, FILE *log) {
+    memset(c, 0, sizeof(*c));
+    if (read_geometry(c)) return -1;
+
+    cal_set s;
+    s.l1_stream = 2 * c->cache[CP_L1].size;
+    s.l2_stream = 2 * c->cache[CP_L2].size;
+    uint8_t *targets = chase_map_pages((size_t)CAL_LINES * PAGE);
+    s.stream = chase_map_pages(s.l2_stream);
+    s.lines = malloc(CAL_LINES * sizeof(void *));
+    if (!targets || !s.stream || !s.lines) {
+        if (targets) munmap(targets, (size_t)CAL_LINES * PAGE);
+        if (s.stream) munmap(s.stream, s.l2_stream);
+        free(s.lines);
+        return -1;
+    }
+    // line i sits at page i, offset i % 64 lines: every L1 set gets a few
+    for (int i = 0; i < CAL_LINES; i++) s.lines[i] = targets + (size_t)i * PAGE + (i % 64) * CP_LINE;
+    shuffle(s.lines, CAL_LINES);
+
+    static uint32_t single[CP_LEVELS][CAL_SAMPLES], batch[CP_LEVELS][CAL_SAMPLES];
+    for (int l = CP_L1; l < CP_LEVELS; l++) {
+        sample_level(&s, l, single[l], batch[l]);
+        c->latency[l] = median_u32(single[l], CAL_SAMPLES);
+        c->batch_latency[l] = median_u32(batch[l], CAL_SAMPLES);
+    }
+    for (int l = CP_L1; l < CP_DRAM; l++) {
+        double e;
+        c->miss_above[l] = split(single[l], CAL_SAMPLES, single[l + 1], CAL_SAMPLES, &c->miss_error[l]);
+        c->batch_miss_above[l] = split(batch[l], CAL_SAMPLES, batch[l + 1], CAL_SAMPLES, &e);
+    }
+
+    // flush+flush: try both orders, keep the one that separates better
+    static uint32_t ff_cached[CAL_SAMPLES], ff_uncached[CAL_SAMPLES];
+    for (int r = 0; r < CAL_ROUNDS; r++)
+        for (int i = 0; i < CAL_LINES; i++) {
+            (void)*(volatile char *)s.lines[i];
+            ff_cached[r * CAL_LINES + i] = cp_flush_timed(s.lines[i]);
+            ff_uncached[r * CAL_LINES + i] = cp_flush_timed(s.lines[i]);
+        }
+    double e_fast;
+    uint32_t t_fast = split(ff_cached, CAL_SAMPLES, ff_uncached, CAL_SAMPLES, &e_fast);
+    c->ff_split = split(ff_uncached, CAL_SAMPLES, ff_cached, CAL_SAMPLES, &c->ff_error);
+    c->ff_cached_slower = 1;
+    if (e_fast < c->ff_error) {
+        c->ff_split = t_fast;
+        c->ff_error = e_fast;
+        c->ff_cached_slower = 0;
+    }
+
+    // prime+probe: a clean set vs one where a foreign line of that set was loaded
+    cp_pp_l1 pp;
+    if (!cp_pp_init(&pp, c)) {
+        static uint32_t clean[CAL_SAMPLES], touched[CAL_SAMPLES];
+        int n = 0;
+        for (int r = 0; n < CAL_SAMPLES; r++)
+            for (int set = 0; set < pp.n_sets && n < CAL_SAMPLES; set++, n++) {
+                cp_pp_prime(&pp, set);
+                clean[n] = cp_pp_probe(&pp, set);
+                (void)*(volatile char *)(targets + (size_t)(r % CAL_LINES) * PAGE + set * CP_LINE);
+                touched[n] = cp_pp_probe(&pp, set);
+            }
+        c->pp_touched_above = split(clean, n, touched, n, &c->pp_error);
+        cp_pp_free(&pp);
+    }
+
+    // batched probe rate on L1 hits
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < 1000; r++) cp_reload_batch((const void *const *)s.lines, CAL_LINES, batch[CP_L1]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double us = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_nsec - t0.tv_nsec) / 1e3;
+    c->batch_lines_per_us = 1000.0 * CAL_LINES / us;
+
+    munmap(targets, (size_t)CAL_LINES * PAGE);
+    munmap(s.stream, s.l2_stream);
+    free(s.lines);
+
+    if (log) {
+        fprintf(log, "cacheprobe: L1D %zu KB %d-way, L2 %zu KB %d-way, LLC %zu KB %d-way\n",
+                c->cache[CP_L1].size >> 10, c->cache[CP_L1].ways, c->cache[CP_L2].size >> 10,
+                c->cache[CP_L2].ways, c->cache[CP_LLC].size >> 10, c->cache[CP_LLC].ways);
+        fprintf(log, "cacheprobe: load ticks (single/batched):");
+        for (int l = CP_L1; l < CP_LEVELS; l++)
+            fprintf(log, " %s %.0f/%.0f", level_names[l], c->latency[l], c->batch_latency[l]);
+        fprintf(log, "\ncacheprobe: miss thresholds (single/batched, error):");
+        for (int l = CP_L1; l < CP_DRAM; l++)
+            fprintf(log, " %s|%s %u/%u %.2f%%", level_names[l], level_names[l + 1], c->miss_above[l],
+                    c->batch_miss_above[l], 100.0 * c->miss_error[l]);
+        fprintf(log, "\ncacheprobe: flush+flush cached %s %u (%.2f%%), prime+probe touched > %u (%.2f%%), "
+                     "batched %.0f lines/us\n",
+                c->ff_cached_slower ? ">" : "<=", c->ff_split, 100.0 * c->ff_error, c->pp_touched_above, 100.0 * c->pp_error,
+                c->batch_lines_per_us);
+    }
+    return 0;
+}
+
+// ------------------ Eviction Sets ------------------
+int cp_evset_build(cp_evset *e, const cp_calibration *c, const void *target, cp_level level, int n_lines) {
+    memset(e, 0, sizeof(*e));
+    if (level != CP_L1 && level != CP_L2) return -1;
+    const cp_cache *k = &c->cache[level];
+    int groups = (int)((size_t)k->sets * k->line / PAGE);
+    if (groups < 1) groups = 1;
+    e->level = level;
+    e->n = n_lines > 0 ? n_lines : 2 * k->ways * groups;
+    e->pool_bytes = (size_t)e->n * PAGE;
+    e->pool = chase_map_pages(e->pool_bytes);
+    e->lines = malloc(e->n * sizeof(void *));
+    if (!e->pool || !e->lines) {
+        cp_evset_free(e);
+        return -1;
+    }
+    size_t offset = (uintptr_t)target & (PAGE - CP_LINE);
+    for (int i = 0; i < e->n; i++) e->lines[i] = (uint8_t *)e->pool + (size_t)i * PAGE + offset;
+    shuffle(e->lines, e->n);
+    link_chase(e->lines, e->n);
+    return 0;
+}
+
+void cp_evset_free(cp_evset *e) {
+    if (e->pool) munmap(e->pool, e->pool_bytes);
+    free(e->lines);
+    memset(e, 0, sizeof(*e));
+}
+
+// two passes: one walk is not always enough against PLRU replacement
+void cp_evict(const cp_evset *e) {
+    void *volatile sink = walk(e->lines[0], 2 * e->n);
+    (void)sink;
+}
+
+int cp_er_probe(const cp_calibration *c, const cp_evset *e, const void *p) {
+    int hit = cp_reload(p) <= c->miss_above[e->level];
+    cp_evict(e);
+    return hit;
+}
+
+// ------------------ Prime+Probe ------------------
+int cp_pp_init(cp_pp_l1 *pp, const cp_calibration *c) {
+    memset(pp, 0, sizeof(*pp));
+    pp->ways = c->cache[CP_L1].ways;
+    pp->n_sets = c->cache[CP_L1].sets < 64 ? c->cache[CP_L1].sets : 64;
+    void *lines[1024];
+    if (pp->ways > 1024) return -1;
+    pp->pool_bytes = (size_t)pp->ways * PAGE;
+    pp->pool = chase_map_pages(pp->pool_bytes);
+    if (!pp->pool) return -1;
+    for (int s = 0; s < pp->n_sets; s++) {
+        for (int w = 0; w < pp->ways; w++) lines[w] = (uint8_t *)pp->pool + (size_t)w * PAGE + s * CP_LINE;
+        shuffle(lines, pp->ways);
+        link_chase(lines, pp->ways);
+        pp->head[s] = (void **)lines[0];
+    }
+    return 0;
+}
+
+void cp_pp_free(cp_pp_l1 *pp) {
+    if (pp->pool) munmap(pp->pool, pp->pool_bytes);
+    memset(pp, 0, sizeof(*pp));
+}
+
+void cp_pp_prime(const cp_pp_l1 *pp, int set) {
+    void *volatile sink = walk(pp->head[set], 2 * pp->ways);
+    (void)sink;
+}
+
+uint32_t cp_pp_probe(const cp_pp_l1 *pp, int set) {
+    uint64_t t0 = tsc_fenced();
+    void *volatile sink = walk(pp->head[set], pp->ways);
+    uint64_t t1 = tsc_fenced();
+    (void)sink;
+    return (uint32_t)(t1 - t0);
+}
+
+int cp_pp_probe_all(const cp_calibration *c, const cp_pp_l1 *pp, uint32_t *ticks, uint8_t *touched) {
+    int n = 0;
+    for (int s = 0; s < pp->n_sets; s++) {
+        ticks[s] = cp_pp_probe(pp, s);
+        touched[s] = cp_pp_touched(c, ticks[s]);
+        n += touched[s];
+    }
+    return n;
+}
+
+// ------------------ Batched ------------------
+// load i, lfence, rdtsc: load i+1 issues alongside that rdtsc, so each
+// delta covers one load plus one fence/timestamp instead of two
+void cp_reload_batch(const void *const *lines, int n, uint32_t *t) {
+    uint32_t prev, now;
+    __asm__ volatile("mfence\n\tlfence\n\trdtsc\n\tlfence" : "=a"(prev) :: "rdx", "memory");
+    for (int i = 0; i < n; i++) {
+        __asm__ volatile("mov (%1), %%rcx\n\tlfence\n\trdtsc"
+                         : "=a"(now) : "r"(lines[i]) : "rcx", "rdx", "memory");
+        t[i] = now - prev;
+        prev = now;
+    }
+}
+
+void cp_flush_batch(const void *const *lines, int n) {
+    for (int i = 0; i < n; i++) _mm_clflush(lines[i]);
+    _mm_mfence();
+}
+
+int cp_fr_batch(const cp_calibration *c, const void *const *lines, int n, uint32_t *t, uint8_t *hit) {
+    uint32_t local[256];
+    int hits = 0;
+    for (int base = 0; base < n; base += 256) {
+        int m = n - base < 256 ? n - base : 256;
+        uint32_t *tt = t ? t + base : local;
+        cp_reload_batch(lines + base, m, tt);
+        for (int i = 0; i < m; i++) {
+            hit[base + i] = tt[i] <= c->batch_miss_above[CP_LLC];
+            hits += hit[base + i];
+        }
+    }
+    cp_flush_batch(lines, n);
+    return hits;
+}
@@ -0,0 +1,162 @@
+// cacheprobe.h
+// ===============================================================
+// Cache timing primitives with per-host thresholds, replacing
+// hit/miss cut-offs picked by eye from histograms:
+//   flush+reload   clflush a line, later time one load of it
+//   flush+flush    time clflush itself (cached and uncached lines differ;
+//                  which one is slower depends on the CPU)
+//   evict+reload   evict with a congruent line set, later time a load
+//   prime+probe    fill one L1D set (or all 64) with our lines, later
+//                  time walking them again
+// cp_calibrate() measures loads served by L1, L2, LLC and DRAM (and
+// cached vs uncached clflush, clean vs disturbed L1 sets) at startup
+// and puts each threshold where the two neighbouring histograms
+// overlap least. The batched calls share one lfence+rdtsc per line
+// and have their own thresholds, since their per-line overhead differs
+// from a single fenced pair.
+// All times are TSC ticks.
+// ===============================================================
+#ifndef BENCH_CACHEPROBE_H
+#define BENCH_CACHEPROBE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <emmintrin.h>
+
+#define CP_LINE 64
+
+typedef enum { CP_L1, CP_L2, CP_LLC, CP_DRAM, CP_LEVELS } cp_level;
+
+typedef struct {
+    int    line, sets, ways;
+    size_t size;
+} cp_cache;
+
+typedef struct {
+    cp_cache cache[CP_DRAM];            // L1D, L2, LLC from CPUID leaf 4
+    // median ticks of a load served by each level
+    double   latency[CP_LEVELS], batch_latency[CP_LEVELS];
+    // a load slower than miss_above[L] was not served by level L or above
+    uint32_t miss_above[CP_DRAM], batch_miss_above[CP_DRAM];
+    double   miss_error[CP_DRAM];       // misclassified fraction at each threshold
+    uint32_t ff_split;                  // clflush time between cached and uncached
+    int      ff_cached_slower;          // 1 if cached lines flush above ff_split
+    double   ff_error;
+    uint32_t pp_touched_above;          // L1 set probe slower than this: set was touched
+    double   pp_error;
+    double   batch_lines_per_us;        // cp_reload_batch rate on L1 hits
+} cp_calibration;
+
+// Fills `c`; takes about a quarter of a second. Writes a summary to
+// `log` unless it is NULL. Returns 0, or -1 if CPUID leaf 4 is missing.
+int cp_calibrate(cp_calibration *c, FILE *log);
+
+// ------------------ Single Line ------------------
+static inline void cp_flush(const void *p) {
+    _mm_clflush(p);
+    _mm_mfence();
+}
+
+static inline uint32_t cp_reload(const void *p) {
+    uint32_t dt;
+    __asm__ volatile("mfence\n\tlfence\n\trdtsc\n\tlfence\n\t"
+                     "mov %%eax, %%esi\n\t"
+                     "mov (%1), %%rcx\n\t"
+                     "lfence\n\trdtsc\n\t"
+                     "sub %%esi, %%eax"
+                     : "=&a"(dt) : "r"(p) : "rcx", "rdx", "rsi", "memory");
+    return dt;
+}
+
+static inline uint32_t cp_flush_timed(const void *p) {
+    uint32_t dt;
+    __asm__ volatile("mfence\n\tlfence\n\trdtsc\n\tlfence\n\t"
+                     "mov %%eax, %%esi\n\t"
+                     "clflush (%1)\n\t"
+                     "mfence\n\tlfence\n\trdtsc\n\t"
+                     "sub %%esi, %%eax"
+                     : "=&a"(dt) : "r"(p) : "rdx", "rsi", "memory");
+    return dt;
+}
+
+// 1 if a load taking `ticks` was served by `level` or a faster one
+static inline int cp_hit(const cp_calibration *c, uint32_t ticks, cp_level level) {
+    return level >= CP_DRAM || ticks <= c->miss_above[level];
+}
+
+// Level a load of `ticks` was most likely served by.
+static inline cp_level cp_classify(const cp_calibration *c, uint32_t ticks) {
+    for (int l = CP_L1; l < CP_DRAM; l++)
+        if (ticks <= c->miss_above[l]) return (cp_level)l;
+    return CP_DRAM;
+}
+
+const char *cp_level_name(cp_level l);   // "L1", "L2", "LLC", "DRAM"
+
+// Flush+Reload: 1 if the line was cached since the last call; flushes it again.
+static inline int cp_fr_probe(const cp_calibration *c, const void *p) {
+    int hit = cp_reload(p) <= c->miss_above[CP_LLC];
+    cp_flush(p);
+    return hit;
+}
+
+// Flush+Flush: 1 if the line was cached; it is uncached afterwards. No load.
+static inline int cp_ff_probe(const cp_calibration *c, const void *p) {
+    return (cp_flush_timed(p) > c->ff_split) == c->ff_cached_slower;
+}
+
+// ------------------ Eviction Sets ------------------
+// Lines congruent with a target in one level, from a private pool of
+// 4 KB pages. L1 and L2 only: set bits above the page offset are
+// covered by taking every candidate of that offset; the LLC needs
+// physical addresses and the slice hash, so it is refused.
+typedef struct {
+    int       level;
+    int       n;
+    void    **lines;     // also a circular chase: *lines[i] == lines[i + 1]
+    void     *pool;
+    size_t    pool_bytes;
+} cp_evset;
+
+// n_lines <= 0 picks 2 x ways x (sets that share the target's page
+// offset). Returns 0, or -1 for the LLC or if the pool cannot be mapped.
+int  cp_evset_build(cp_evset *e, const cp_calibration *c, const void *target, cp_level level, int n_lines);
+void cp_evset_free(cp_evset *e);
+void cp_evict(const cp_evset *e);
+
+// Evict+Reload: 1 if the line came back into `e->level` since the last
+// call; evicts it again.
+int cp_er_probe(const cp_calibration *c, const cp_evset *e, const void *p);
+
+// ------------------ Prime+Probe (L1D sets) ------------------
+// `ways` private pages; set s is the circular chase through line s of
+// every page (the L1D set index is the line's page offset).
+typedef struct {
+    void  **head[64];
+    int     n_sets, ways;
+    void   *pool;
+    size_t  pool_bytes;
+} cp_pp_l1;
+
+int  cp_pp_init(cp_pp_l1 *pp, const cp_calibration *c);
+void cp_pp_free(cp_pp_l1 *pp);
+void cp_pp_prime(const cp_pp_l1 *pp, int set);
+// Walks the set, leaving it primed again; returns ticks for the walk.
+uint32_t cp_pp_probe(const cp_pp_l1 *pp, int set);
+static inline int cp_pp_touched(const cp_calibration *c, uint32_t ticks) {
+    return ticks > c->pp_touched_above;
+}
+// All sets: ticks[s] per set, touched[s] from the calibration. Returns
+// the number of touched sets.
+int cp_pp_probe_all(const cp_calibration *c, const cp_pp_l1 *pp, uint32_t *ticks, uint8_t *touched);
+
+// ------------------ Batched ------------------
+// One lfence+rdtsc per line; t[i] is the time of lines[i].
+void cp_reload_batch(const void *const *lines, int n, uint32_t *t);
+void cp_flush_batch(const void *const *lines, int n);
+// Flush+Reload over n lines: hit[i] as cp_fr_probe, all lines flushed
+// afterwards; t may be NULL. Returns the number of hits.
+int  cp_fr_batch(const cp_calibration *c, const void *const *lines, int n, uint32_t *t, uint8_t *hit);
+
+#endif
@@ -0,0 +1,37 @@
+// chase.c
+// ===============================================================
+// Fisher-Yates over the node indices, then each node is pointed at
+// its successor in that order, the last one back at the first.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "chase.h"
+
+#define PAGE 4096
+
+void *chase_map_pages(size_t bytes) {
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    madvise(p, bytes, MADV_NOHUGEPAGE);
+    memset(p, 0, bytes);
+    return p;
+}
+
+void **chase_build(uint8_t *base, int n, size_t stride, size_t skew, uint64_t *rng) {
+    int *order = malloc(n * sizeof(int));
+    if (!order) return NULL;
+    for (int i = 0; i < n; i++) order[i] = i;
+    for (int i = n - 1; i > 0; i--) {
+        *rng ^= *rng << 13; *rng ^= *rng >> 7; *rng ^= *rng << 17;
+        int j = *rng % (i + 1);
+        int t = order[i]; order[i] = order[j]; order[j] = t;
+    }
+#define NODE(i) ((void **)(base + (size_t)(i) * stride + ((size_t)(i) * skew) % PAGE))
+    for (int i = 0; i < n; i++) *NODE(order[i]) = NODE(order[(i + 1) % n]);
+    void **start = NODE(order[0]);
+#undef NODE
+    free(order);
+    return start;
+}
@@ -0,0 +1,24 @@
+// chase.h
+// ===============================================================
+// Pointer-chase buffers for latency and TLB kernels:
+//   chase_map_pages   anonymous zeroed mapping kept on 4 KB pages
+//                     (MADV_NOHUGEPAGE), so a kernel that walks n pages
+//                     needs n translations
+//   chase_build       cyclic chase over n nodes, node i at
+//                     base + i*stride + (i*skew % 4096), visited in a
+//                     shuffled order the prefetchers cannot follow
+// The order comes from a xorshift64 state the caller owns, so a fixed
+// seed gives the same chase on every run. Both return NULL on failure.
+// ===============================================================
+#ifndef BENCH_CHASE_H
+#define BENCH_CHASE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+void *chase_map_pages(size_t bytes);
+
+// returns the first node; each node holds the address of the next
+void **chase_build(uint8_t *base, int n, size_t stride, size_t skew, uint64_t *rng);
+
+#endif
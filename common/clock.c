@@ -0,0 +1,176 @@
+// clock.c
+// ===============================================================
+// One frequency source per process, opened by clk_open(). Without it
+// every call behaves as the probe source.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include "clock.h"
+#include "pmu.h"
+
+#define MSR_MPERF 0xE7
+#define MSR_APERF 0xE8
+
+static double tsc_ghz;
+static clk_source src = CLK_SRC_PROBE;
+static pmu_counter cycles_ctr = { -1 }, ref_ctr = { -1 };
+static int msr_fd = -1;
+
+static const char *src_name[] = { "perf", "msr", "probe" };
+
+// ------------------ TSC ------------------
+double clk_calibrate(void) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t c0 = clk_tsc();
+    do clock_gettime(CLOCK_MONOTONIC, &t1);
+    while ((t1.tv_sec - t0.tv_sec) * 1000000000L + (t1.tv_nsec - t0.tv_nsec) < 50000000L);
+    uint64_t c1 = clk_tsc();
+    double ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    tsc_ghz = (double)(c1 - c0) / ns;
+    return tsc_ghz;
+}
+
+double clk_tsc_ghz(void) {
+    return tsc_ghz > 0.0 ? tsc_ghz : clk_calibrate();
+}
+
+// dependent add chain: CLK_PROBE_ADDS core cycles regardless of clock speed.
+// reg, reg form: newer cores fold `add reg, imm` chains at rename.
+uint64_t clk_probe_ticks(void) {
+    long n = CLK_PROBE_ADDS / 8;
+    uint64_t start = clk_tsc();
+    __asm__ volatile("1:\n\t"
+                     ".rept 8\n\tadd %%rax, %%rax\n\t.endr\n\t"
+                     "dec %[n]\n\t"
+                     "jnz 1b\n\t"
+                     : [n] "+r"(n) :: "rax", "cc");
+    return clk_tsc() - start;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// ------------------ Frequency Sources ------------------
+static uint64_t read_msr(uint32_t reg) {
+    uint64_t v = 0;
+    if (pread(msr_fd, &v, sizeof(v), reg) != sizeof(v)) return 0;
+    return v;
+}
+
+clk_source clk_open(void) {
+    clk_tsc_ghz();
+    if (pmu_open(&cycles_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES) == 0 &&
+        pmu_open(&ref_ctr, PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES) == 0)
+        return src = CLK_SRC_PERF;
+    pmu_close(&cycles_ctr);
+    pmu_close(&ref_ctr);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/dev/cpu/%d/msr", sched_getcpu());
+    msr_fd = open(path, O_RDONLY);
+    if (msr_fd >= 0 && read_msr(MSR_MPERF) != 0) return src = CLK_SRC_MSR;
+    if (msr_fd >= 0) close(msr_fd);
+    msr_fd = -1;
+    return src = CLK_SRC_PROBE;
+}
+
+void clk_close(void) {
+    pmu_close(&cycles_ctr);
+    pmu_close(&ref_ctr);
+    if (msr_fd >= 0) close(msr_fd);
+    msr_fd = -1;
+    src = CLK_SRC_PROBE;
+}
+
+clk_source clk_src(void) {
+    return src;
+}
+
+const char *clk_source_name(clk_source s) {
+    return src_name[s];
+}
+
+clk_mark clk_read(void) {
+    clk_mark m = { 0, 0 };
+    if (src == CLK_SRC_PERF) {
+        m.actual = pmu_read(&cycles_ctr);
+        m.reference = pmu_read(&ref_ctr);
+    } else if (src == CLK_SRC_MSR) {
+        m.actual = read_msr(MSR_APERF);
+        m.reference = read_msr(MSR_MPERF);
+    }
+    return m;
+}
+
+// one ~1 us window: a single probe chain, or the counters around one
+static double sample_ghz(void) {
+    if (src == CLK_SRC_PROBE) return clk_tsc_ghz() * CLK_PROBE_ADDS / (double)clk_probe_ticks();
+    clk_mark a = clk_read();
+    clk_probe_ticks();
+    clk_mark b = clk_read();
+    if (b.reference == a.reference) return 0.0;
+    return clk_tsc_ghz() * (double)(b.actual - a.actual) / (double)(b.reference - a.reference);
+}
+
+// Median of CLK_PROBES windows. An interrupt inside a window makes it
+// read far too slow, so single windows are never used on their own;
+// *spread gets the interquartile range relative to the median.
+static double median_ghz(double *spread) {
+    double g[CLK_PROBES];
+    for (int i = 0; i < CLK_PROBES; i++) g[i] = sample_ghz();
+    qsort(g, CLK_PROBES, sizeof(double), cmp_double);
+    double med = g[CLK_PROBES / 2];
+    if (spread) *spread = med > 0.0 ? (g[3 * CLK_PROBES / 4] - g[CLK_PROBES / 4]) / med : 0.0;
+    return med;
+}
+
+double clk_ghz_between(clk_mark a, clk_mark b) {
+    if (src == CLK_SRC_PROBE) return median_ghz(NULL);
+    if (b.reference == a.reference) return 0.0;
+    return clk_tsc_ghz() * (double)(b.actual - a.actual) / (double)(b.reference - a.reference);
+}
+
+double clk_ghz_now(void) {
+    return median_ghz(NULL);
+}
+
+// ------------------ Per Measurement ------------------
+void clk_begin(clk_span *s) {
+    s->ghz_before = median_ghz(&s->spread);
+    s->mark0 = clk_read();
+    s->tsc0 = clk_tsc();
+}
+
+void clk_end(clk_span *s) {
+    uint64_t tsc1 = clk_tsc();
+    clk_mark mark1 = clk_read();
+    double spread_after;
+    s->ghz_after = median_ghz(&spread_after);
+    if (spread_after > s->spread) s->spread = spread_after;
+    s->ticks = tsc1 - s->tsc0;
+    s->ns = clk_ns((double)s->ticks);
+    s->ghz = src == CLK_SRC_PROBE ? 0.5 * (s->ghz_before + s->ghz_after)
+                                  : clk_ghz_between(s->mark0, mark1);
+    s->cycles = clk_cycles(s, (double)s->ticks);
+    // a move within the probes' own spread is not evidence of a change
+    double frac = CLK_CHANGE_FRAC + s->spread;
+    double lo = s->ghz * (1.0 - frac), hi = s->ghz * (1.0 + frac);
+    s->freq_changed = s->ghz_before < lo || s->ghz_before > hi || s->ghz_after < lo || s->ghz_after > hi;
+}
+
+double clk_cycles(const clk_span *s, double ticks) {
+    return s->ghz > 0.0 ? ticks * s->ghz / clk_tsc_ghz() : ticks;
+}
+
+double clk_ns(double ticks) {
+    return ticks / clk_tsc_ghz();
+}
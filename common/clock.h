@@ -0,0 +1,81 @@
+// clock.h
+// ===============================================================
+// TSC ticks vs core cycles. The TSC runs at a fixed rate; the core
+// clock moves with turbo, AVX licenses and power limits, so a tick
+// count is only a cycle count when the two happen to match. This
+// module calibrates the TSC against CLOCK_MONOTONIC and tracks the
+// core clock from, in order of preference:
+//   perf   cycles / ref-cycles on the calling thread
+//   msr    APERF / MPERF from /dev/cpu/N/msr (caller must be pinned)
+//   probe  a CLK_PROBE_ADDS-deep dependent `add reg, reg` chain (one
+//          add per core cycle) timed in TSC ticks
+// Every clock reading is the median of CLK_PROBES such ~1 us windows,
+// since one window hit by an interrupt reads far too slow.
+// clk_begin()/clk_end() around a measurement give its TSC ticks, core
+// cycles and nanoseconds, plus the core clock sampled just before and
+// just after: a measurement whose endpoints differ from its average by
+// more than CLK_CHANGE_FRAC plus the probes' own spread is flagged as
+// having changed frequency.
+// ===============================================================
+#ifndef BENCH_CLOCK_H
+#define BENCH_CLOCK_H
+
+#include <stdint.h>
+
+#define CLK_PROBE_ADDS  2000
+#define CLK_PROBES      9
+#define CLK_CHANGE_FRAC 0.02
+
+typedef enum { CLK_SRC_PERF, CLK_SRC_MSR, CLK_SRC_PROBE } clk_source;
+
+static inline uint64_t clk_tsc(void) {
+    unsigned a, d;
+    __asm__ __volatile__("lfence\n\trdtsc\n\tlfence" : "=a"(a), "=d"(d) :: "memory");
+    return ((uint64_t)d << 32) | a;
+}
+
+// Measures the TSC rate over 50 ms and returns it in GHz. clk_tsc_ghz()
+// calls it on first use.
+double clk_calibrate(void);
+double clk_tsc_ghz(void);
+
+// TSC ticks of CLK_PROBE_ADDS dependent adds.
+uint64_t clk_probe_ticks(void);
+
+// Picks the best available source for the calling thread / its CPU.
+clk_source  clk_open(void);
+void        clk_close(void);
+clk_source  clk_src(void);
+const char *clk_source_name(clk_source s);
+
+typedef struct { uint64_t actual, reference; } clk_mark;
+
+clk_mark clk_read(void);
+// Core GHz between two marks; the probe source times its own chains.
+double   clk_ghz_between(clk_mark a, clk_mark b);
+// Core GHz right now (median of CLK_PROBES short windows).
+double   clk_ghz_now(void);
+
+// ------------------ Per Measurement ------------------
+typedef struct {
+    uint64_t tsc0;
+    clk_mark mark0;
+    // filled by clk_end()
+    uint64_t ticks;
+    double   ns;
+    double   ghz;                    // average core clock over the span
+    double   cycles;                 // ticks * ghz / TSC GHz
+    double   ghz_before, ghz_after;
+    double   spread;                 // larger relative IQR of the two readings
+    int      freq_changed;
+} clk_span;
+
+void clk_begin(clk_span *s);
+void clk_end(clk_span *s);
+
+// Converts ticks measured inside `s` (a per-op figure, a kernel's own
+// count) with the span's average clock.
+double clk_cycles(const clk_span *s, double ticks);
+double clk_ns(double ticks);
+
+#endif
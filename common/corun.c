@@ -0,0 +1,134 @@
+// corun.c
+// ===============================================================
+// The victim thread drives the schedule: it publishes the window kind,
+// releases the barrier, times its work, raises `stop` and waits for the
+// stressor at the closing barrier. A `quit` flag read after the opening
+// barrier ends the stressor thread, so both threads are always joined.
+// ===============================================================
+#define _GNU_SOURCE
+#include <sched.h>
+#include <time.h>
+#include <immintrin.h>
+#include "corun.h"
+
+static inline uint64_t rdtscp_serialized(void) {
+    unsigned lo, hi, aux;
+    __asm__ __volatile__("rdtscp" : "=a"(lo), "=d"(hi), "=c"(aux) :: "memory");
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// ------------------ Spin Barrier ------------------
+void corun_barrier_init(corun_barrier *b, int n) {
+    b->n = n;
+    atomic_store(&b->waiting, 0);
+    atomic_store(&b->phase, 0);
+}
+
+// last arrival resets the count and flips the phase; the rest spin on it
+void corun_barrier_wait(corun_barrier *b) {
+    int phase = atomic_load(&b->phase);
+    if (atomic_fetch_add(&b->waiting, 1) == b->n - 1) {
+        atomic_store(&b->waiting, 0);
+        atomic_store(&b->phase, phase + 1);
+        return;
+    }
+    while (atomic_load(&b->phase) == phase) _mm_pause();
+}
+
+int corun_spawn_pinned(pthread_t *thread, int cpu, void *(*fn)(void *), void *arg) {
+    cpu_set_t cs;
+    CPU_ZERO(&cs);
+    CPU_SET(cpu, &cs);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    int err = pthread_attr_setaffinity_np(&attr, sizeof(cs), &cs);
+    if (!err) err = pthread_create(thread, &attr, fn, arg);
+    pthread_attr_destroy(&attr);
+    return err;
+}
+
+// ------------------ Co-run ------------------
+// B S S B | B S S B | ...
+int corun_window_stressed(int w) {
+    return ((w >> 1) ^ w) & 1;
+}
+
+typedef struct {
+    corun_plan   *plan;
+    corun_barrier start, end;
+    atomic_int    stressed, stop, quit;
+} corun_shared;
+
+static void *stressor_main(void *arg) {
+    corun_shared *sh = arg;
+    const corun_task *t = &sh->plan->stressor;
+    struct timespec nap = { 0, 20000 };
+    for (;;) {
+        corun_barrier_wait(&sh->start);
+        if (atomic_load(&sh->quit)) break;
+        if (atomic_load(&sh->stressed)) {
+            while (!atomic_load_explicit(&sh->stop, memory_order_relaxed)) t->run(t->state, t->iters);
+        } else {
+            // sleeping, not spinning: an idle sibling leaves the whole core to the victim
+            while (!atomic_load(&sh->stop)) nanosleep(&nap, NULL);
+        }
+        corun_barrier_wait(&sh->end);
+    }
+    return NULL;
+}
+
+static void *victim_main(void *arg) {
+    corun_shared *sh = arg;
+    corun_plan *p = sh->plan;
+    const corun_task *t = &p->victim;
+    int total = CORUN_WARMUP + p->windows, tries = 0;
+    p->n_baseline = p->n_stressed = 0;
+    for (int w = 0; w < total; w++) {
+        int stressed = corun_window_stressed(w), screened = p->screen && w >= CORUN_WARMUP;
+        perturb_mark mark;
+        atomic_store(&sh->stressed, stressed);
+        atomic_store(&sh->stop, 0);
+        corun_barrier_wait(&sh->start);
+        if (screened) perturb_begin(p->screen, &mark);
+        uint64_t t0 = rdtscp_serialized();
+        t->run(t->state, t->iters);
+        uint64_t ticks = rdtscp_serialized() - t0;
+        atomic_store(&sh->stop, 1);
+        int perturbed = screened && perturb_end(p->screen, &mark);
+        corun_barrier_wait(&sh->end);
+        if (w < CORUN_WARMUP) continue;
+        if (perturbed && ++tries < PERTURB_RETRIES) {
+            w--;
+            continue;
+        }
+        if (perturbed) perturb_keep(p->screen);
+        tries = 0;
+        if (stressed) p->stressed[p->n_stressed++] = ticks;
+        else          p->baseline[p->n_baseline++] = ticks;
+    }
+    atomic_store(&sh->quit, 1);
+    corun_barrier_wait(&sh->start);
+    return NULL;
+}
+
+int corun_run(corun_plan *p) {
+    corun_shared sh = { .plan = p };
+    corun_barrier_init(&sh.start, 2);
+    corun_barrier_init(&sh.end, 2);
+    atomic_store(&sh.quit, 0);
+
+    pthread_t stressor, victim;
+    int err = corun_spawn_pinned(&stressor, p->stressor_cpu, stressor_main, &sh);
+    if (err) return err;
+    err = corun_spawn_pinned(&victim, p->victim_cpu, victim_main, &sh);
+    if (err) {
+        // release the stressor from its first barrier and let it exit
+        atomic_store(&sh.quit, 1);
+        corun_barrier_wait(&sh.start);
+        pthread_join(stressor, NULL);
+        return err;
+    }
+    pthread_join(victim, NULL);
+    pthread_join(stressor, NULL);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// corun.h
+// ===============================================================
+// Co-run scheduler for victim/stressor studies (SMT, shared LLC, ...).
+// Two threads, created already pinned, meet on a spin barrier at the
+// start of every window. The victim runs a fixed amount of work and
+// times it. The stressor runs its kernel in chunks until the victim
+// raises the shared stop flag, or, in a baseline window, sleeps until
+// then so its CPU is idle. Both meet again before the next window.
+//
+// Baseline and stressed windows alternate in ABBA order (B S S B B S ...)
+// so slow drift (frequency, temperature, background load) hits both
+// sides equally. Hundreds of windows run in one process, and every
+// stressed sample has a baseline taken next to it.
+// ===============================================================
+#ifndef BENCH_CORUN_H
+#define BENCH_CORUN_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "perturb.h"
+
+// ------------------ Spin Barrier ------------------
+typedef struct {
+    int        n;
+    atomic_int waiting;
+    atomic_int phase;
+} corun_barrier;
+
+void corun_barrier_init(corun_barrier *b, int n);
+void corun_barrier_wait(corun_barrier *b);
+
+// Starts fn(arg) on a thread already pinned to `cpu` (affinity is set on
+// the attribute, so the creator is never moved). Returns 0 or an errno.
+int corun_spawn_pinned(pthread_t *thread, int cpu, void *(*fn)(void *), void *arg);
+
+// ------------------ Co-run ------------------
+typedef struct {
+    void (*run)(void *state, long iters);
+    void  *state;    // caller-owned, passed to run()
+    long   iters;    // victim: work per window; stressor: chunk between stop checks
+} corun_task;
+
+#define CORUN_WARMUP 2   // untimed windows (one of each kind) before sampling
+
+typedef struct {
+    int        victim_cpu, stressor_cpu;
+    int        windows;                 // recorded windows, baseline + stressed
+    corun_task victim, stressor;
+    // out: caller-allocated, (windows + 1) / 2 entries each (TSC ticks per window)
+    uint64_t  *baseline, *stressed;
+    int        n_baseline, n_stressed;
+    // optional, opened on victim_cpu: recorded windows hit by a switch,
+    // interrupt or SMI on the victim are rerun (same kind, same slot)
+    perturb   *screen;
+} corun_plan;
+
+// 1 if window w (0-based, warm-up included) runs the stressor.
+int corun_window_stressed(int w);
+
+// Runs CORUN_WARMUP + p->windows windows. Returns 0, or an errno if a
+// thread could not be started on its CPU.
+int corun_run(corun_plan *p);
+
+#endif
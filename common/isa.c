@@ -0,0 +1,188 @@
+// isa.c
+// ===============================================================
+// A feature is usable only when CPUID reports it *and* the OS saves
+// its register state (XCR0 via xgetbv); AMX additionally needs the
+// per-process XTILEDATA permission from arch_prctl. Detection runs
+// once; call it from main before spawning workers.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <cpuid.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "isa.h"
+
+#define ARCH_REQ_XCOMP_PERM  0x1023
+#define XFEATURE_XTILEDATA   18
+
+#define XCR0_AVX     0x00000006u   // SSE | AVX (YMM_Hi128)
+#define XCR0_AVX512  0x000000E6u   // + opmask, ZMM_Hi256, Hi16_ZMM
+#define XCR0_AMX     0x00060000u   // XTILECFG | XTILEDATA
+
+static const char *names[ISA_COUNT] = {
+    "baseline", "avx", "avx2", "avx512", "amx", "avx512_vnni", "avx512_bf16",
+};
+
+static int probed;
+static const char *reason[ISA_COUNT];   // NULL = supported
+static char cap_msg[64];
+static int cap_tier = ISA_AMX;
+
+// raw CPUID words and XCR0, for isa_has()
+enum { REG_ECX1, REG_EDX1, REG_EBX7, REG_ECX7, REG_EAX71, N_REGS };
+static unsigned regs[N_REGS], xcr0_bits;
+
+static const struct {
+    const char *name;
+    int         reg, bit;
+    unsigned    state;     // XCR0 bits the OS must enable
+    isa_feature tier;      // for ISA_MAX
+} features[] = {
+    { "sse",         REG_EDX1,  25, 0,           ISA_BASELINE },
+    { "sse2",        REG_EDX1,  26, 0,           ISA_BASELINE },
+    { "sse3",        REG_ECX1,   0, 0,           ISA_BASELINE },
+    { "ssse3",       REG_ECX1,   9, 0,           ISA_BASELINE },
+    { "sse4.1",      REG_ECX1,  19, 0,           ISA_BASELINE },
+    { "sse4.2",      REG_ECX1,  20, 0,           ISA_BASELINE },
+    { "avx",         REG_ECX1,  28, XCR0_AVX,    ISA_AVX },
+    { "fma",         REG_ECX1,  12, XCR0_AVX,    ISA_AVX2 },
+    { "avx2",        REG_EBX7,   5, XCR0_AVX,    ISA_AVX2 },
+    { "avx512f",     REG_EBX7,  16, XCR0_AVX512, ISA_AVX512 },
+    { "avx512dq",    REG_EBX7,  17, XCR0_AVX512, ISA_AVX512 },
+    { "avx512cd",    REG_EBX7,  28, XCR0_AVX512, ISA_AVX512 },
+    { "avx512bw",    REG_EBX7,  30, XCR0_AVX512, ISA_AVX512 },
+    { "avx512vl",    REG_EBX7,  31, XCR0_AVX512, ISA_AVX512 },
+    { "avx512vnni",  REG_ECX7,  11, XCR0_AVX512, ISA_AVX512 },
+    { "avx512bf16",  REG_EAX71,  5, XCR0_AVX512, ISA_AVX512 },
+};
+
+static isa_feature tier_of(isa_feature f) {
+    return f > ISA_AMX ? ISA_AVX512 : f;
+}
+
+static int all_bits(unsigned reg, unsigned mask) {
+    return (reg & mask) == mask;
+}
+
+static void probe(void) {
+    unsigned eax, ebx, ecx, edx;
+    unsigned ecx1 = 0, edx1 = 0, ebx7 = 0, ecx7 = 0, edx7 = 0, eax71 = 0, xcr0 = 0;
+    unsigned max_leaf = __get_cpuid_max(0, NULL);
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        ecx1 = ecx;
+        edx1 = edx;
+    }
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        ebx7 = ebx; ecx7 = ecx; edx7 = edx;
+        if (eax >= 1) {
+            __cpuid_count(7, 1, eax, ebx, ecx, edx);
+            eax71 = eax;
+        }
+    }
+    int osxsave = (ecx1 >> 27) & 1;
+    if (osxsave) {
+        unsigned hi;
+        __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(hi) : "c"(0));
+    }
+    regs[REG_ECX1] = ecx1;
+    regs[REG_EDX1] = edx1;
+    regs[REG_EBX7] = ebx7;
+    regs[REG_ECX7] = ecx7;
+    regs[REG_EAX71] = eax71;
+    xcr0_bits = xcr0;
+
+    reason[ISA_BASELINE] = NULL;
+
+    if (!((ecx1 >> 28) & 1))                 reason[ISA_AVX] = "CPU lacks AVX";
+    else if (!osxsave)                       reason[ISA_AVX] = "OSXSAVE disabled";
+    else if (!all_bits(xcr0, XCR0_AVX))      reason[ISA_AVX] = "OS does not enable AVX state in XCR0";
+
+    if (reason[ISA_AVX])                     reason[ISA_AVX2] = reason[ISA_AVX];
+    else if (!all_bits(ebx7, 1u << 5 | 1u << 3 | 1u << 8) || !((ecx1 >> 12) & 1))
+                                             reason[ISA_AVX2] = "CPU lacks AVX2/FMA/BMI";
+
+    if (reason[ISA_AVX2])                    reason[ISA_AVX512] = reason[ISA_AVX2];
+    else if (!all_bits(ebx7, 1u << 16 | 1u << 17 | 1u << 28 | 1u << 30 | 1u << 31))
+                                             reason[ISA_AVX512] = "CPU lacks AVX-512 F/CD/BW/DQ/VL";
+    else if (!all_bits(xcr0, XCR0_AVX512))   reason[ISA_AVX512] = "OS does not enable AVX-512 state in XCR0";
+
+    if (reason[ISA_AVX512])                  reason[ISA_AVX512_VNNI] = reason[ISA_AVX512];
+    else if (!((ecx7 >> 11) & 1))            reason[ISA_AVX512_VNNI] = "CPU lacks AVX512_VNNI";
+
+    if (reason[ISA_AVX512])                  reason[ISA_AVX512_BF16] = reason[ISA_AVX512];
+    else if (!((eax71 >> 5) & 1))            reason[ISA_AVX512_BF16] = "CPU lacks AVX512_BF16";
+
+    if (!all_bits(edx7, 1u << 22 | 1u << 24 | 1u << 25))
+                                             reason[ISA_AMX] = "CPU lacks AMX-TILE/INT8/BF16";
+    else if (!osxsave)                       reason[ISA_AMX] = "OSXSAVE disabled";
+    else if (!all_bits(xcr0, XCR0_AMX))      reason[ISA_AMX] = "OS does not enable XTILECFG/XTILEDATA in XCR0";
+    else if (syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA))
+                                             reason[ISA_AMX] = "arch_prctl(ARCH_REQ_XCOMP_PERM) refused";
+
+    const char *cap = getenv("ISA_MAX");
+    if (cap && *cap) {
+        int tier = -1;
+        for (int t = ISA_BASELINE; t <= ISA_AMX; t++)
+            if (!strcmp(cap, names[t])) tier = t;
+        if (tier >= 0) {
+            cap_tier = tier;
+            snprintf(cap_msg, sizeof(cap_msg), "capped by ISA_MAX=%s", cap);
+            for (int f = 0; f < ISA_COUNT; f++)
+                if ((int)tier_of(f) > tier && !reason[f]) reason[f] = cap_msg;
+        } else {
+            fprintf(stderr, "isa: ignoring unknown ISA_MAX=%s\n", cap);
+        }
+    }
+    probed = 1;
+}
+
+int isa_supported(isa_feature f) {
+    if (f < 0 || f >= ISA_COUNT) return 0;
+    if (!probed) probe();
+    return reason[f] == NULL;
+}
+
+const char *isa_reason(isa_feature f) {
+    if (f < 0 || f >= ISA_COUNT) return "unknown ISA feature";
+    if (!probed) probe();
+    return reason[f] ? reason[f] : "supported";
+}
+
+static int has_one(const char *name, size_t len) {
+    for (size_t i = 0; i < sizeof(features) / sizeof(features[0]); i++) {
+        if (strlen(features[i].name) != len || strncmp(name, features[i].name, len)) continue;
+        return (regs[features[i].reg] >> features[i].bit & 1) &&
+               all_bits(xcr0_bits, features[i].state) && (int)features[i].tier <= cap_tier;
+    }
+    return 0;
+}
+
+int isa_has(const char *features_list) {
+    if (!probed) probe();
+    const char *s = features_list;
+    for (;;) {
+        size_t len = strcspn(s, ",");
+        if (!has_one(s, len)) return 0;
+        if (!s[len]) return 1;
+        s += len + 1;
+    }
+}
+
+const char *isa_name(isa_feature f) {
+    return f >= 0 && f < ISA_COUNT ? names[f] : "?";
+}
+
+isa_feature isa_best(void) {
+    isa_feature best = ISA_BASELINE;
+    for (int t = ISA_AVX; t <= ISA_AMX; t++)
+        if (isa_supported(t)) best = t;
+    return best;
+}
+
+int isa_require(isa_feature f, const char *kernel, FILE *log) {
+    if (isa_supported(f)) return 1;
+    fprintf(log ? log : stdout, "%s: skipped (needs %s: %s)\n", kernel, isa_name(f), isa_reason(f));
+    return 0;
+}
@@ -0,0 +1,63 @@
+// isa.h
+// ===============================================================
+// Runtime ISA dispatch. Benchmarks are built for the x86-64 baseline
+// (no -march=native) so one binary runs on every host from Sandy
+// Bridge to Sapphire Rapids; each kernel that needs more is compiled
+// for its own tier with ISA_TARGET_* and only called after
+// isa_supported() says the CPU *and* the OS (XCR0, AMX permission)
+// allow it. Kernels the host cannot run are reported as skipped.
+//
+// ISA_MAX=<tier> in the environment caps detection at that tier, e.g.
+// ISA_MAX=avx makes a Sapphire Rapids host dispatch like Sandy Bridge.
+// ===============================================================
+#ifndef BENCH_ISA_H
+#define BENCH_ISA_H
+
+#include <stdio.h>
+
+// Ordered tiers first, then the AVX-512 extensions a few kernels need
+// (these count as the avx512 tier for ISA_MAX).
+typedef enum {
+    ISA_BASELINE,      // x86-64: SSE2
+    ISA_AVX,           // Sandy Bridge
+    ISA_AVX2,          // Haswell: AVX2, FMA, BMI1/2
+    ISA_AVX512,        // Skylake-SP: F, CD, BW, DQ, VL
+    ISA_AMX,           // Sapphire Rapids: AMX-TILE/INT8/BF16 + XTILEDATA permission
+    ISA_AVX512_VNNI,
+    ISA_AVX512_BF16,
+    ISA_COUNT
+} isa_feature;
+
+#define ISA_TARGET_AVX          __attribute__((target("avx")))
+#define ISA_TARGET_AVX2         __attribute__((target("avx2,fma,bmi,bmi2")))
+#define ISA_TARGET_AVX512       __attribute__((target("avx512f,avx512cd,avx512bw,avx512dq,avx512vl")))
+#define ISA_TARGET_AVX512_VNNI  __attribute__((target("avx512f,avx512vnni")))
+#define ISA_TARGET_AVX512_BF16  __attribute__((target("avx512f,avx512bf16")))
+#define ISA_TARGET_AMX          __attribute__((target("amx-tile,amx-int8,amx-bf16")))
+
+// 1 when kernels built for `f` may run in this process. The first call
+// probes CPUID/XCR0 and, for AMX, requests XTILEDATA via arch_prctl.
+int isa_supported(isa_feature f);
+
+// Why isa_supported(f) is 0 ("CPU lacks AVX2", "OS does not enable
+// AVX-512 state in XCR0", "capped by ISA_MAX=avx", ...), or "supported".
+const char *isa_reason(isa_feature f);
+
+// CPUID features by their GCC target() names, comma-separated as in
+// ISA_TARGET_* ("fma", "avx2,fma", "avx512bw", ...): 1 when the CPU
+// reports exactly those bits, the OS enables the register state they
+// use, and ISA_MAX does not cap their tier. For code that needs a few
+// extensions rather than a whole tier.
+int isa_has(const char *features);
+
+const char *isa_name(isa_feature f);
+
+// Highest supported tier, ISA_BASELINE..ISA_AMX.
+isa_feature isa_best(void);
+
+// Dispatch guard: returns 1 if `kernel` can run, otherwise prints
+// "<kernel>: skipped (needs <isa>: <reason>)" to `log` (stdout if NULL)
+// and returns 0.
+int isa_require(isa_feature f, const char *kernel, FILE *log);
+
+#endif
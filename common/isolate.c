@@ -0,0 +1,182 @@
+// isolate.c
+// ===============================================================
+// IRQs are moved by rewriting /proc/irq/N/smp_affinity_list to the
+// online CPUs minus ours; per-CPU and managed IRQs refuse the write
+// (EIO) and are counted as stuck. The saved lists are written back in
+// isolate_leave(), or, if the process ends without it, by an atexit()
+// hook and by handlers for the terminating signals. The handlers only
+// open/write/close the paths recorded at move time, then re-raise.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include "isolate.h"
+#include "topology.h"
+#include "sysfs.h"
+
+#define PAGE 4096
+
+// ------------------ IRQs ------------------
+// moved IRQs not yet restored, for the exit hooks
+static isolate_irq *volatile pending;
+static volatile int n_pending;
+
+static void restore_pending(void) {
+    isolate_irq *p = pending;
+    int n = n_pending;
+    pending = NULL;
+    n_pending = 0;
+    for (int i = 0; p && i < n; i++)
+        if (p[i].affinity) sysfs_write_str(p[i].path, p[i].affinity);
+}
+
+static void on_fatal_signal(int sig) {
+    restore_pending();
+    raise(sig);   // SA_RESETHAND: the default action now runs
+}
+
+static void install_exit_hooks(void) {
+    static int installed;
+    static const int sigs[] = { SIGINT, SIGTERM, SIGHUP, SIGQUIT, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+    if (installed) return;
+    installed = 1;
+    atexit(restore_pending);
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_fatal_signal;
+    sa.sa_flags = SA_RESETHAND | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    for (size_t i = 0; i < sizeof(sigs) / sizeof(sigs[0]); i++) {
+        struct sigaction old;
+        // a benchmark's own handler stays in charge of its signal
+        if (sigaction(sigs[i], NULL, &old) == 0 && old.sa_handler == SIG_DFL)
+            sigaction(sigs[i], &sa, NULL);
+    }
+}
+
+static void move_irqs(isolate *s) {
+    char buf[4096], target[4096];
+    cpu_set_t others;
+    if (sysfs_read_line("/sys/devices/system/cpu/online", buf, sizeof(buf))) return;
+    sysfs_parse_cpulist(buf, &others);
+    CPU_CLR(s->cpu, &others);
+    sysfs_format_cpulist(&others, target, sizeof(target));
+
+    DIR *d = opendir("/proc/irq");
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        if (e->d_name[0] < '0' || e->d_name[0] > '9') continue;
+        char path[300];
+        cpu_set_t cur;
+        snprintf(path, sizeof(path), "/proc/irq/%s/smp_affinity_list", e->d_name);
+        if (sysfs_read_line(path, buf, sizeof(buf))) continue;
+        sysfs_parse_cpulist(buf, &cur);
+        if (!CPU_ISSET(s->cpu, &cur)) continue;
+        if (!CPU_COUNT(&others) || sysfs_write_str(path, target)) {
+            s->irqs_stuck++;
+            continue;
+        }
+        isolate_irq *saved = realloc(s->saved, (s->n_saved + 1) * sizeof(isolate_irq));
+        if (!saved) {
+            sysfs_write_str(path, buf);   // cannot be restored later: put it back now
+            break;
+        }
+        s->saved = saved;
+        isolate_irq *m = &saved[s->n_saved];
+        m->irq = atoi(e->d_name);
+        snprintf(m->path, sizeof(m->path), "/proc/irq/%d/smp_affinity_list", m->irq);
+        m->affinity = strdup(buf);
+        s->n_saved++;
+        s->irqs_moved++;
+    }
+    closedir(d);
+}
+
+static void restore_irqs(isolate *s) {
+    n_pending = 0;
+    pending = NULL;
+    for (int i = 0; i < s->n_saved; i++) {
+        if (s->saved[i].affinity) sysfs_write_str(s->saved[i].path, s->saved[i].affinity);
+        free(s->saved[i].affinity);
+    }
+    free(s->saved);
+    s->saved = NULL;
+    s->n_saved = 0;
+}
+
+// ------------------ Public ------------------
+int isolate_requested(void) {
+    const char *v = getenv("BENCH_ISOLATE");
+    return v && *v && strcmp(v, "0");
+}
+
+void isolate_enter(isolate *s, int cpu) {
+    memset(s, 0, sizeof(*s));
+    s->active = 1;
+    if (cpu < 0) {
+        static topology topo;
+        cpu = topo_load(&topo) ? sched_getcpu() : topo_quiet_cpu(&topo);
+    }
+    s->cpu = cpu;
+    s->pinned = topo_pin_self(cpu) == 0;
+    char buf[4096];
+    cpu_set_t iso;
+    if (sysfs_read_line("/sys/devices/system/cpu/isolated", buf, sizeof(buf)) == 0) {
+        sysfs_parse_cpulist(buf, &iso);
+        s->cpu_isolated = CPU_ISSET(cpu, &iso);
+    }
+
+    s->locked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+
+    struct sched_param sp;
+    pthread_getschedparam(pthread_self(), &s->old_policy, &sp);
+    s->old_priority = sp.sched_priority;
+    s->priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    sp.sched_priority = s->priority;
+    s->fifo = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) == 0;
+
+    // the terminating signals wait until the hooks can see every moved IRQ
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGTERM);
+    sigaddset(&block, SIGHUP);
+    sigaddset(&block, SIGQUIT);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    install_exit_hooks();
+    move_irqs(s);
+    pending = s->saved;
+    n_pending = s->n_saved;
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+void isolate_leave(isolate *s) {
+    if (!s->active) return;
+    restore_irqs(s);
+    if (s->fifo) {
+        struct sched_param sp = { .sched_priority = s->old_priority };
+        pthread_setschedparam(pthread_self(), s->old_policy, &sp);
+    }
+    if (s->locked) munlockall();
+    s->active = 0;
+}
+
+void isolate_report(const isolate *s, FILE *fp) {
+    fprintf(fp, "Isolation on CPU %d: pinned %s, isolcpus %s, mlockall %s, SCHED_FIFO %s",
+            s->cpu, s->pinned ? "yes" : "no", s->cpu_isolated ? "yes" : "no",
+            s->locked ? "yes" : "no (prefault only)", s->fifo ? "yes" : "no");
+    if (s->fifo) fprintf(fp, " (prio %d)", s->priority);
+    fprintf(fp, ", IRQs moved %d, stuck %d\n", s->irqs_moved, s->irqs_stuck);
+}
+
+void isolate_prefault(void *p, size_t bytes) {
+    volatile char *c = p;
+    for (size_t i = 0; i < bytes; i += PAGE) c[i] = c[i];
+    if (bytes) c[bytes - 1] = c[bytes - 1];
+}
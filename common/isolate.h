@@ -0,0 +1,56 @@
+// isolate.h
+// ===============================================================
+// Real-time isolated execution for the measuring thread, opt-in with
+// BENCH_ISOLATE=1 in the environment:
+//   memory   mlockall(MCL_CURRENT | MCL_FUTURE): mapped pages are faulted
+//            in and later allocations are populated when mapped, so no
+//            first-touch page fault lands in a timed region
+//   CPU      pinned to an isolated CPU (topo_quiet_cpu() unless given)
+//   policy   SCHED_FIFO, one below the maximum priority
+//   IRQs     every movable IRQ whose affinity includes the CPU is moved
+//            to the other online CPUs, and restored by isolate_leave();
+//            a process that exits, crashes or is killed by SIGINT/SIGTERM
+//            without calling it gets them restored by exit hooks
+// Each step is tried on its own. Without CAP_IPC_LOCK / CAP_SYS_NICE /
+// root, a step that fails is recorded and the run goes on without it;
+// isolate_report() says which isolations actually took effect.
+// isolate_prefault() covers buffers that exist before isolate_enter()
+// or when mlockall was refused.
+// ===============================================================
+#ifndef BENCH_ISOLATE_H
+#define BENCH_ISOLATE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+typedef struct {
+    int irq;
+    char path[48];       // its smp_affinity_list file
+    char *affinity;      // smp_affinity_list before the move
+} isolate_irq;
+
+typedef struct {
+    int          active;          // isolate_enter() ran and isolate_leave() has not
+    int          cpu;
+    int          pinned, cpu_isolated;
+    int          locked;          // mlockall succeeded
+    int          fifo, priority;  // SCHED_FIFO succeeded, at this priority
+    int          irqs_moved, irqs_stuck;
+    int          n_saved;
+    isolate_irq *saved;
+    int          old_policy, old_priority;
+} isolate;
+
+// 1 if BENCH_ISOLATE is set to something other than "0".
+int  isolate_requested(void);
+
+// Enters the mode for the calling thread on `cpu` (-1: topo_quiet_cpu()).
+void isolate_enter(isolate *s, int cpu);
+// Restores IRQ affinities and the scheduling policy, and unlocks memory.
+void isolate_leave(isolate *s);
+void isolate_report(const isolate *s, FILE *fp);
+
+// Writes every page of [p, p + bytes) once, keeping its contents.
+void isolate_prefault(void *p, size_t bytes);
+
+#endif
@@ -0,0 +1,131 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "jit.h"
+
+int jit_alloc(jit_buf *j, size_t size) {
+    j->base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (j->base == MAP_FAILED) {
+        j->base = NULL;
+        return -1;
+    }
+    j->size = size;
+    j->pos = 0;
+    memset(j->base, 0xCC, size); // int3 anywhere we did not emit
+    return 0;
+}
+
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+#ifndef MFD_HUGE_2MB
+#define MFD_HUGE_2MB (21U << 26)
+#endif
+#define HUGE_2MB (2UL * 1024 * 1024)
+
+int jit_alloc_backed(jit_buf *j, size_t size, int backing) {
+    if (backing == JIT_PAGES_4K) {
+        size = (size + 4095) & ~(size_t)4095;
+        if (jit_alloc(j, size)) return -1;
+        madvise(j->base, size, MADV_NOHUGEPAGE);
+        return 0;
+    }
+
+    size = (size + HUGE_2MB - 1) & ~(HUGE_2MB - 1);
+    if (backing == JIT_PAGES_2M_HUGETLB) {
+        int fd = memfd_create("jit_huge", MFD_HUGETLB | MFD_HUGE_2MB);
+        if (fd < 0) return -1;
+        if (ftruncate(fd, size)) {
+            close(fd);
+            return -1;
+        }
+        void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return -1;
+        j->base = p;
+    } else {
+        // over-map, then trim to a 2 MB-aligned window THP can back
+        uint8_t *p = mmap(NULL, size + HUGE_2MB, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return -1;
+        uint8_t *aligned = (uint8_t *)(((uintptr_t)p + HUGE_2MB - 1) & ~(HUGE_2MB - 1));
+        if (aligned > p) munmap(p, aligned - p);
+        munmap(aligned + size, (p + HUGE_2MB) - aligned);
+        madvise(aligned, size, MADV_HUGEPAGE);
+        j->base = aligned;
+    }
+    j->size = size;
+    j->pos = 0;
+    memset(j->base, 0xCC, size); // also faults every huge page in
+    return 0;
+}
+
+int jit_seal(jit_buf *j) {
+    __builtin___clear_cache((char *)j->base, (char *)j->base + j->size);
+    return mprotect(j->base, j->size, PROT_READ | PROT_EXEC);
+}
+
+void jit_free(jit_buf *j) {
+    if (j->base) munmap(j->base, j->size);
+    j->base = NULL;
+}
+
+void jit_emit(jit_buf *j, const void *bytes, size_t n) {
+    memcpy(j->base + j->pos, bytes, n);
+    j->pos += n;
+}
+
+void jit_emit8(jit_buf *j, uint8_t b) {
+    j->base[j->pos++] = b;
+}
+
+void jit_emit32(jit_buf *j, uint32_t v) {
+    memcpy(j->base + j->pos, &v, 4);
+    j->pos += 4;
+}
+
+static void emit_rel32(jit_buf *j, size_t target) {
+    int64_t rel = (int64_t)target - (int64_t)(j->pos + 4);
+    jit_emit32(j, (uint32_t)(int32_t)rel);
+}
+
+void jit_call(jit_buf *j, size_t target) {
+    jit_emit8(j, 0xE8);
+    emit_rel32(j, target);
+}
+
+void jit_jmp(jit_buf *j, size_t target) {
+    jit_emit8(j, 0xE9);
+    emit_rel32(j, target);
+}
+
+void jit_jcc(jit_buf *j, uint8_t cc, size_t target) {
+    jit_emit8(j, 0x0F);
+    jit_emit8(j, 0x80 | cc);
+    emit_rel32(j, target);
+}
+
+void jit_ret(jit_buf *j) {
+    jit_emit8(j, 0xC3);
+}
+
+void jit_nops(jit_buf *j, size_t n) {
+    static const uint8_t nop[9][9] = {
+        { 0x90 },
+        { 0x66, 0x90 },
+        { 0x0F, 0x1F, 0x00 },
+        { 0x0F, 0x1F, 0x40, 0x00 },
+        { 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+        { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+        { 0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00 },
+        { 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    };
+    while (n > 0) {
+        size_t k = n > 9 ? 9 : n;
+        jit_emit(j, nop[k - 1], k);
+        n -= k;
+    }
+}
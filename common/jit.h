@@ -0,0 +1,53 @@
+// jit.h
+// ===============================================================
+// Minimal x86-64 code emitter for benchmarks that need code at
+// controlled addresses (branch targets, stubs spread over pages).
+// Offsets are relative to the start of the arena; relative branch
+// helpers resolve to rel32 forms so any layout within 2 GB works.
+// ===============================================================
+#ifndef BENCH_JIT_H
+#define BENCH_JIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t pos;      // emit cursor
+} jit_buf;
+
+// Writable, not yet executable arena of `size` bytes. Returns 0 on success.
+int  jit_alloc(jit_buf *j, size_t size);
+
+// Page backing for jit_alloc_backed(); size is rounded up to the page size.
+enum {
+    JIT_PAGES_4K,          // anonymous, THP explicitly disabled
+    JIT_PAGES_2M_HUGETLB,  // memfd_create(MFD_HUGETLB | MFD_HUGE_2MB), needs nr_hugepages
+    JIT_PAGES_2M_THP,      // 2 MB-aligned anonymous + MADV_HUGEPAGE (best effort)
+};
+int  jit_alloc_backed(jit_buf *j, size_t size, int backing);
+// Flip the arena to read+execute; call before running emitted code.
+int  jit_seal(jit_buf *j);
+void jit_free(jit_buf *j);
+
+static inline void  *jit_ptr(const jit_buf *j, size_t off) { return j->base + off; }
+static inline void   jit_seek(jit_buf *j, size_t off) { j->pos = off; }
+static inline size_t jit_here(const jit_buf *j) { return j->pos; }
+
+void jit_emit(jit_buf *j, const void *bytes, size_t n);
+void jit_emit8(jit_buf *j, uint8_t b);
+void jit_emit32(jit_buf *j, uint32_t v);
+
+// Control flow to arena offsets (always the rel32 encodings).
+void jit_call(jit_buf *j, size_t target);
+void jit_jmp(jit_buf *j, size_t target);
+void jit_jcc(jit_buf *j, uint8_t cc, size_t target);   // cc: 0x4 = e/z, 0x5 = ne/nz
+void jit_ret(jit_buf *j);
+// Recommended multi-byte NOPs, filling exactly n bytes.
+void jit_nops(jit_buf *j, size_t n);
+
+#define JIT_CC_E  0x4
+#define JIT_CC_NE 0x5
+
+#endif
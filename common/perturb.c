@@ -0,0 +1,141 @@
+// perturb.c
+// ===============================================================
+// /proc/interrupts is kept open and re-read from offset 0 each time;
+// only the column of the pinned CPU is summed over all rows. The
+// rows without per-CPU columns (ERR, MIS) are skipped.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include "perturb.h"
+
+#define MSR_SMI_COUNT 0x34
+
+// whole file into p->buf; returns its length or -1
+static long read_interrupts(perturb *p) {
+    size_t len = 0;
+    if (lseek(p->irq_fd, 0, SEEK_SET) < 0) return -1;
+    for (;;) {
+        if (len + 4096 > p->buf_size) {
+            size_t size = p->buf_size ? 2 * p->buf_size : 65536;
+            char *b = realloc(p->buf, size);
+            if (!b) return -1;
+            p->buf = b;
+            p->buf_size = size;
+        }
+        ssize_t r = read(p->irq_fd, p->buf + len, p->buf_size - len - 1);
+        if (r < 0) return -1;
+        if (r == 0) break;
+        len += r;
+    }
+    p->buf[len] = '\0';
+    return (long)len;
+}
+
+// header "           CPU0       CPU1 ..." -> column of `cpu`
+static int find_column(const char *buf, int cpu) {
+    const char *eol = strchr(buf, '\n');
+    int col = 0;
+    for (const char *s = buf; (s = strstr(s, "CPU")) && (!eol || s < eol); s += 3, col++)
+        if (atoi(s + 3) == cpu) return col;
+    return -1;
+}
+
+static uint64_t cpu_interrupts(perturb *p) {
+    if (p->irq_fd < 0 || read_interrupts(p) < 0) return 0;
+    uint64_t sum = 0;
+    char *line = strchr(p->buf, '\n');
+    while (line && *++line) {
+        char *s = strchr(line, ':'), *next = strchr(line, '\n');
+        if (!s || (next && s > next)) break;
+        s++;
+        for (int c = 0; c <= p->irq_col; c++) {
+            char *end;
+            unsigned long long v = strtoull(s, &end, 10);
+            if (end == s) break;
+            if (c == p->irq_col) sum += v;
+            s = end;
+        }
+        line = next;
+    }
+    return sum;
+}
+
+static uint64_t smi_count(const perturb *p) {
+    uint64_t v = 0;
+    if (p->msr_fd >= 0 && pread(p->msr_fd, &v, sizeof(v), MSR_SMI_COUNT) != sizeof(v)) v = 0;
+    return v;
+}
+
+static long switches(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru)) return 0;
+    return ru.ru_nvcsw + ru.ru_nivcsw;
+}
+
+// ------------------ Public ------------------
+int perturb_open(perturb *p, int cpu) {
+    memset(p, 0, sizeof(*p));
+    p->cpu = cpu >= 0 ? cpu : sched_getcpu();
+    p->irq_col = -1;
+    p->irq_fd = open("/proc/interrupts", O_RDONLY);
+    if (p->irq_fd >= 0 && read_interrupts(p) > 0) p->irq_col = find_column(p->buf, p->cpu);
+    if (p->irq_col < 0 && p->irq_fd >= 0) {
+        close(p->irq_fd);
+        p->irq_fd = -1;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/dev/cpu/%d/msr", p->cpu);
+    p->msr_fd = open(path, O_RDONLY);
+    if (p->msr_fd >= 0 && pread(p->msr_fd, &(uint64_t){0}, 8, MSR_SMI_COUNT) != 8) {
+        close(p->msr_fd);
+        p->msr_fd = -1;
+    }
+    struct rusage ru;
+    return p->irq_fd < 0 && getrusage(RUSAGE_THREAD, &ru) ? -1 : 0;
+}
+
+void perturb_close(perturb *p) {
+    if (p->irq_fd >= 0) close(p->irq_fd);
+    if (p->msr_fd >= 0) close(p->msr_fd);
+    free(p->buf);
+    p->irq_fd = p->msr_fd = -1;
+    p->buf = NULL;
+    p->buf_size = 0;
+}
+
+void perturb_begin(perturb *p, perturb_mark *m) {
+    m->irqs = cpu_interrupts(p);
+    m->smis = smi_count(p);
+    m->switches = switches();   // last: the cheapest, closest to the sample
+}
+
+int perturb_end(perturb *p, const perturb_mark *m) {
+    int cause = 0;
+    if (switches() != m->switches) cause |= PERTURB_SWITCH;
+    if (cpu_interrupts(p) != m->irqs) cause |= PERTURB_IRQ;
+    if (smi_count(p) != m->smis) cause |= PERTURB_SMI;
+    if (!cause) {
+        p->clean++;
+        return 0;
+    }
+    p->rejected++;
+    for (int i = 0; i < 3; i++)
+        if (cause & (1 << i)) p->by_cause[i]++;
+    return cause;
+}
+
+void perturb_keep(perturb *p) {
+    p->kept_perturbed++;
+}
+
+void perturb_summary(const perturb *p, FILE *fp, const char *name) {
+    char smi[24] = "n/a";
+    if (p->msr_fd >= 0) snprintf(smi, sizeof(smi), "%ld", p->by_cause[2]);
+    fprintf(fp, "%s: %ld clean, %ld rejected (switch %ld, irq %ld, smi %s), %ld kept perturbed\n",
+            name, p->clean, p->rejected, p->by_cause[0], p->by_cause[1], smi, p->kept_perturbed);
+}
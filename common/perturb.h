@@ -0,0 +1,70 @@
+// perturb.h
+// ===============================================================
+// Per-sample perturbation detection. perturb_begin() / perturb_end()
+// go just outside a timed region and compare three counters:
+//   context switches   getrusage(RUSAGE_THREAD), voluntary + involuntary
+//   interrupts         this CPU's column of /proc/interrupts (device
+//                      IRQs, local timer, IPIs, ...)
+//   SMIs               MSR_SMI_COUNT (0x34) via /dev/cpu/N/msr, only
+//                      when that is readable (root + msr module)
+// A sample during which any of them moved is rejected and rerun, so
+// the distributions are built from clean samples only instead of from
+// heavy oversampling and a median.
+// The thread must stay pinned to `cpu` for the interrupt count to
+// mean anything.
+// ===============================================================
+#ifndef BENCH_PERTURB_H
+#define BENCH_PERTURB_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define PERTURB_RETRIES 10   // tries per sample; the last one is kept even if perturbed
+
+enum { PERTURB_SWITCH = 1, PERTURB_IRQ = 2, PERTURB_SMI = 4 };
+
+typedef struct {
+    int      cpu;
+    int      irq_fd, irq_col;   // /proc/interrupts, column of `cpu`
+    int      msr_fd;            // -1 without SMI counts
+    char    *buf;
+    size_t   buf_size;
+    // counts since perturb_open
+    long     clean, rejected, kept_perturbed;
+    long     by_cause[3];       // switch, irq, smi
+} perturb;
+
+typedef struct {
+    long     switches;
+    uint64_t irqs, smis;
+} perturb_mark;
+
+// cpu -1: the CPU the caller is on now. Returns 0, or -1 if neither
+// getrusage nor /proc/interrupts works.
+int  perturb_open(perturb *p, int cpu);
+void perturb_close(perturb *p);
+
+void perturb_begin(perturb *p, perturb_mark *m);
+// 0 if nothing happened since `m`, else a mask of PERTURB_* causes.
+int  perturb_end(perturb *p, const perturb_mark *m);
+
+// Records that a perturbed sample was kept after PERTURB_RETRIES.
+void perturb_keep(perturb *p);
+
+// "<name>: N clean, N rejected (switch N, irq N, smi N|n/a), N kept perturbed"
+void perturb_summary(const perturb *p, FILE *fp, const char *name);
+
+// Runs the statement (one timed sample) until it is not perturbed, at
+// most PERTURB_RETRIES times.
+#define PERTURB_SAMPLE(p, ...)                                             \
+    do {                                                                   \
+        perturb_mark pm_;                                                  \
+        for (int try_ = 1;; try_++) {                                      \
+            perturb_begin((p), &pm_);                                      \
+            __VA_ARGS__;                                                   \
+            if (!perturb_end((p), &pm_)) break;                            \
+            if (try_ == PERTURB_RETRIES) { perturb_keep(p); break; }       \
+        }                                                                  \
+    } while (0)
+
+#endif
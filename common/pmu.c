@@ -0,0 +1,35 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "pmu.h"
+
+int pmu_open(pmu_counter *c, uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    c->fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return c->fd >= 0 ? 0 : -1;
+}
+
+int pmu_open_raw(pmu_counter *c, uint64_t config) {
+    return pmu_open(c, PERF_TYPE_RAW, config);
+}
+
+uint64_t pmu_read(const pmu_counter *c) {
+    uint64_t v = 0;
+    if (c->fd < 0) return 0;
+    if (read(c->fd, &v, sizeof(v)) != sizeof(v)) return 0;
+    return v;
+}
+
+void pmu_close(pmu_counter *c) {
+    if (c->fd >= 0) close(c->fd);
+    c->fd = -1;
+}
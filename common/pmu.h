@@ -0,0 +1,31 @@
+// pmu.h
+// ===============================================================
+// Thin perf_event_open wrapper for user-space event counts.
+// Every caller must cope with pmu_open() failing (VMs, containers,
+// perf_event_paranoid > 2) and fall back to a timing estimate.
+// ===============================================================
+#ifndef BENCH_PMU_H
+#define BENCH_PMU_H
+
+#include <stdint.h>
+
+typedef struct {
+    int fd;       // -1 when the event is unavailable
+} pmu_counter;
+
+// Opens a user-only counter on the calling thread, any CPU.
+// type/config follow struct perf_event_attr (PERF_TYPE_HARDWARE, ...).
+// Returns 0 on success, -1 if the event cannot be counted here.
+int pmu_open(pmu_counter *c, uint32_t type, uint64_t config);
+
+// Raw (x86 PERFEVTSEL-encoded) event, e.g. 0x010e for UOPS_ISSUED.ANY.
+int pmu_open_raw(pmu_counter *c, uint64_t config);
+
+static inline int pmu_ok(const pmu_counter *c) { return c->fd >= 0; }
+
+// Current count, or 0 if the counter is not open.
+uint64_t pmu_read(const pmu_counter *c);
+
+void pmu_close(pmu_counter *c);
+
+#endif
@@ -0,0 +1,249 @@
+// preflight.c
+// ===============================================================
+// Everything is read from sysfs/procfs; a file that cannot be read
+// leaves its field unknown rather than failing. Issues are the
+// settings known to add noise to TSC-timed loops.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include "preflight.h"
+#include "sysfs.h"
+
+#define WAKE_SAMPLES   1000
+#define WAKE_PERIOD_NS 100000
+#define SPIN_NS        100000000
+#define GAP_NS         2000
+
+// ------------------ sysfs ------------------
+// CPUs in "0-3,8,10-11"; *has is set if `cpu` is one of them
+static int count_cpulist(const char *s, int cpu, int *has) {
+    cpu_set_t set;
+    sysfs_parse_cpulist(s, &set);
+    *has = cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &set);
+    return CPU_COUNT(&set);
+}
+
+static int in_cpulist_file(const char *path, int cpu) {
+    char buf[4096];
+    int has = 0;
+    if (sysfs_read_line(path, buf, sizeof(buf)) == 0) count_cpulist(buf, cpu, &has);
+    return has;
+}
+
+static void add_issue(preflight *pf, const char *fmt, ...) {
+    if (pf->n_issues >= PF_MAX_ISSUES) return;
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(pf->issues[pf->n_issues++], sizeof(pf->issues[0]), fmt, ap);
+    va_end(ap);
+}
+
+// ------------------ Settings ------------------
+static void read_cpufreq(preflight *pf) {
+    char path[160];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", pf->cpu);
+    if (sysfs_read_line(path, pf->governor, sizeof(pf->governor))) pf->governor[0] = '\0';
+
+    int v;
+    pf->turbo = -1;
+    if (sysfs_read_int("/sys/devices/system/cpu/intel_pstate/no_turbo", &v) == 0) pf->turbo = !v;
+    else if (sysfs_read_int("/sys/devices/system/cpu/cpufreq/boost", &v) == 0) pf->turbo = v;
+}
+
+static void read_cstates(preflight *pf) {
+    if (sysfs_read_line("/sys/module/intel_idle/parameters/max_cstate", pf->max_cstate, sizeof(pf->max_cstate)))
+        pf->max_cstate[0] = '\0';
+    pf->deep_cstates = -1;
+    for (int s = 0;; s++) {
+        char path[160];
+        int latency, disabled = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpuidle/state%d/latency", pf->cpu, s);
+        if (sysfs_read_int(path, &latency)) break;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpuidle/state%d/disable", pf->cpu, s);
+        sysfs_read_int(path, &disabled);
+        if (pf->deep_cstates < 0) pf->deep_cstates = 0;
+        if (latency > 10 && !disabled) pf->deep_cstates++;
+    }
+}
+
+static void read_smt(preflight *pf) {
+    char path[160], buf[256];
+    int has;
+    if (sysfs_read_int("/sys/devices/system/cpu/smt/active", &pf->smt_active)) pf->smt_active = -1;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", pf->cpu);
+    pf->siblings = sysfs_read_line(path, buf, sizeof(buf)) ? 1 : count_cpulist(buf, pf->cpu, &has);
+}
+
+static void read_isolation(preflight *pf) {
+    pf->isolated = in_cpulist_file("/sys/devices/system/cpu/isolated", pf->cpu);
+    pf->nohz_full = in_cpulist_file("/sys/devices/system/cpu/nohz_full", pf->cpu);
+}
+
+// effective affinity where the kernel reports it (x86 since 4.15)
+static void read_irqs(preflight *pf) {
+    pf->irqs = pf->irqs_here = 0;
+    DIR *d = opendir("/proc/irq");
+    if (!d) {
+        pf->irqs = pf->irqs_here = -1;
+        return;
+    }
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        if (e->d_name[0] < '0' || e->d_name[0] > '9') continue;
+        char path[300], buf[4096];
+        int has;
+        snprintf(path, sizeof(path), "/proc/irq/%s/effective_affinity_list", e->d_name);
+        if (sysfs_read_line(path, buf, sizeof(buf)) || !buf[0]) {
+            snprintf(path, sizeof(path), "/proc/irq/%s/smp_affinity_list", e->d_name);
+            if (sysfs_read_line(path, buf, sizeof(buf))) continue;
+        }
+        count_cpulist(buf, pf->cpu, &has);
+        pf->irqs++;
+        pf->irqs_here += has;
+    }
+    closedir(d);
+}
+
+static void read_misc(preflight *pf) {
+    char buf[128];
+    pf->thp[0] = '\0';
+    if (sysfs_read_line("/sys/kernel/mm/transparent_hugepage/enabled", buf, sizeof(buf)) == 0) {
+        char *l = strchr(buf, '['), *r = l ? strchr(l, ']') : NULL;
+        if (l && r && r - l - 1 < (long)sizeof(pf->thp)) {
+            memcpy(pf->thp, l + 1, r - l - 1);
+            pf->thp[r - l - 1] = '\0';
+        }
+    }
+    pf->loadavg = -1;
+    if (sysfs_read_line("/proc/loadavg", buf, sizeof(buf)) == 0) pf->loadavg = atof(buf);
+}
+
+// ------------------ Jitter ------------------
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void measure_wakeup(preflight *pf) {
+    static int64_t late[WAKE_SAMPLES];
+    int64_t next = now_ns();
+    for (int i = 0; i < WAKE_SAMPLES; i++) {
+        next += WAKE_PERIOD_NS;
+        struct timespec ts = { next / 1000000000, next % 1000000000 };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        late[i] = now_ns() - next;
+        if (late[i] > WAKE_PERIOD_NS) next = now_ns();   // don't let one stall cascade
+    }
+    qsort(late, WAKE_SAMPLES, sizeof(int64_t), cmp_i64);
+    pf->wake_p50_us = late[WAKE_SAMPLES / 2] / 1e3;
+    pf->wake_p99_us = late[WAKE_SAMPLES * 99 / 100] / 1e3;
+    pf->wake_max_us = late[WAKE_SAMPLES - 1] / 1e3;
+}
+
+static void measure_stolen(preflight *pf) {
+    int64_t start = now_ns(), prev = start, stolen = 0, worst = 0;
+    long gaps = 0;
+    while (prev - start < SPIN_NS) {
+        int64_t t = now_ns();
+        if (t - prev > GAP_NS) {
+            gaps++;
+            stolen += t - prev;
+            if (t - prev > worst) worst = t - prev;
+        }
+        prev = t;
+    }
+    double span = (double)(prev - start);
+    pf->stolen_per_s = gaps / (span / 1e9);
+    pf->stolen_pct = 100.0 * stolen / span;
+    pf->stolen_max_us = worst / 1e3;
+}
+
+// ------------------ Public ------------------
+void preflight_run(preflight *pf, int cpu) {
+    memset(pf, 0, sizeof(*pf));
+    pf->cpu = cpu >= 0 ? cpu : sched_getcpu();
+
+    cpu_set_t old, cs;
+    int moved = pthread_getaffinity_np(pthread_self(), sizeof(old), &old) == 0;
+    CPU_ZERO(&cs);
+    CPU_SET(pf->cpu, &cs);
+    if (moved) moved = pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs) == 0;
+
+    read_cpufreq(pf);
+    read_cstates(pf);
+    read_smt(pf);
+    read_isolation(pf);
+    read_irqs(pf);
+    read_misc(pf);
+    measure_wakeup(pf);
+    measure_stolen(pf);
+    if (moved) pthread_setaffinity_np(pthread_self(), sizeof(old), &old);
+
+    if (pf->governor[0] && strcmp(pf->governor, "performance"))
+        add_issue(pf, "governor is %s, not performance", pf->governor);
+    if (pf->turbo == 1) add_issue(pf, "turbo is on");
+    if (pf->deep_cstates > 0) add_issue(pf, "%d deep C-states enabled", pf->deep_cstates);
+    if (pf->siblings > 1) add_issue(pf, "SMT sibling of the bench CPU is online");
+    if (!pf->isolated) add_issue(pf, "bench CPU is not in isolcpus=");
+    if (pf->irqs_here > 0) add_issue(pf, "%d device IRQs may fire on the bench CPU", pf->irqs_here);
+    if (!strcmp(pf->thp, "always")) add_issue(pf, "THP is %s: page size varies between runs", pf->thp);
+    if (pf->loadavg > 1.0) add_issue(pf, "load average %.2f", pf->loadavg);
+    if (pf->wake_p99_us > 50) add_issue(pf, "timer wake-up p99 %.1f us", pf->wake_p99_us);
+    if (pf->stolen_pct > 0.5) add_issue(pf, "%.2f%% of a spin loop lost to interruptions", pf->stolen_pct);
+}
+
+static const char *tri(int v, const char *yes, const char *no) {
+    return v < 0 ? "unknown" : v ? yes : no;
+}
+
+void preflight_report(const preflight *pf, FILE *fp, const char *prefix) {
+    char deep[16];
+    snprintf(deep, sizeof(deep), "%d", pf->deep_cstates);
+    fprintf(fp, "%sPreflight on CPU %d: governor %s, turbo %s, max_cstate %s, deep C-states %s\n", prefix,
+            pf->cpu, pf->governor[0] ? pf->governor : "unknown", tri(pf->turbo, "on", "off"),
+            pf->max_cstate[0] ? pf->max_cstate : "-", pf->deep_cstates < 0 ? "unknown" : deep);
+    fprintf(fp, "%s  SMT %s, %d thread(s) on this core, isolcpus %s, nohz_full %s, IRQs here %d of %d\n",
+            prefix, tri(pf->smt_active, "on", "off"), pf->siblings, pf->isolated ? "yes" : "no",
+            pf->nohz_full ? "yes" : "no", pf->irqs_here, pf->irqs);
+    fprintf(fp, "%s  THP %s, load %.2f\n", prefix, pf->thp[0] ? pf->thp : "unknown", pf->loadavg);
+    fprintf(fp, "%s  wake-up overshoot p50 %.1f / p99 %.1f / max %.1f us; "
+                "spin gaps %.0f/s, %.3f%% lost, max %.1f us\n", prefix,
+            pf->wake_p50_us, pf->wake_p99_us, pf->wake_max_us,
+            pf->stolen_per_s, pf->stolen_pct, pf->stolen_max_us);
+    if (!pf->n_issues) fprintf(fp, "%s  no issues\n", prefix);
+    for (int i = 0; i < pf->n_issues; i++) fprintf(fp, "%s  issue: %s\n", prefix, pf->issues[i]);
+}
+
+int preflight_save(const preflight *pf, const char *results) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s.env", results);
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    preflight_report(pf, fp, "");
+    fclose(fp);
+    return 0;
+}
+
+int preflight_gate(preflight *pf, int cpu, FILE *fp) {
+    preflight_run(pf, cpu);
+    if (fp) preflight_report(pf, fp, "");
+    for (int i = 0; i < pf->n_issues; i++) fprintf(stderr, "preflight: %s\n", pf->issues[i]);
+    const char *strict = getenv("BENCH_STRICT");
+    if (strict && *strict && strcmp(strict, "0") && pf->n_issues) {
+        fprintf(stderr, "preflight: BENCH_STRICT is set, refusing to run with %d issue(s)\n", pf->n_issues);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+// preflight.h
+// ===============================================================
+// Environment check run before a measurement. The headers ask for the
+// performance governor, no turbo and a pinned quiet core; this records
+// what the host actually had, so every result set carries it:
+//   cpufreq governor of the bench CPU, turbo (intel_pstate/no_turbo or
+//   cpufreq/boost), enabled deep C-states, SMT and whether the CPU's
+//   sibling is online, isolcpus= / nohz_full=, device IRQs that may
+//   fire on the CPU, THP mode, 1-minute load average
+// plus two jitter measurements taken on the CPU itself:
+//   wake-up   overshoot of 1000 100-us clock_nanosleep()s (cyclictest)
+//   stolen    gaps over 2 us in a 100 ms clock_gettime() spin, i.e.
+//             interrupts and preemption
+// Set BENCH_STRICT=1 in the environment and preflight_gate() refuses
+// to go on when any issue is found.
+// ===============================================================
+#ifndef BENCH_PREFLIGHT_H
+#define BENCH_PREFLIGHT_H
+
+#include <stdio.h>
+
+#define PF_MAX_ISSUES 16
+
+typedef struct {
+    int    cpu;
+    char   governor[32];      // "" when cpufreq is not exposed
+    int    turbo;             // 1 on, 0 off, -1 unknown
+    char   max_cstate[16];    // intel_idle.max_cstate, "" if not loaded
+    int    deep_cstates;      // enabled idle states with exit latency > 10 us, -1 unknown
+    int    smt_active;        // /sys/devices/system/cpu/smt/active, -1 unknown
+    int    siblings;          // online threads on this CPU's core, this one included
+    int    isolated, nohz_full;
+    int    irqs_here, irqs;   // device IRQs whose affinity includes the CPU / all
+    char   thp[16];           // selected THP mode
+    double loadavg;
+    // wake-up overshoot, microseconds
+    double wake_p50_us, wake_p99_us, wake_max_us;
+    // spin-loop gaps over 2 us
+    double stolen_per_s, stolen_pct, stolen_max_us;
+    int    n_issues;
+    char   issues[PF_MAX_ISSUES][96];
+} preflight;
+
+// Runs all checks on `cpu` (-1: the CPU the caller is on). The calling
+// thread is moved to `cpu` for the jitter tests and back afterwards.
+void preflight_run(preflight *pf, int cpu);
+
+// Multi-line report, every line starting with `prefix` ("" or "# ").
+void preflight_report(const preflight *pf, FILE *fp, const char *prefix);
+
+// Writes the report next to a results file: "<results>.env".
+int preflight_save(const preflight *pf, const char *results);
+
+// preflight_run + report to `fp` (when not NULL) + issues to stderr.
+// Returns 0, or -1 if BENCH_STRICT is set and an issue was found.
+int preflight_gate(preflight *pf, int cpu, FILE *fp);
+
+#endif
@@ -0,0 +1,207 @@
+// rapl.c
+// ===============================================================
+// Powercap zones are matched by name, not index: intel-rapl:N is
+// "package-<id>" and its subzones intel-rapl:N:M are "core", "uncore"
+// and "dram". The MSR path reads the same three counters; note that
+// some server parts count DRAM in a fixed 15.3 uJ unit instead of
+// the one in MSR_RAPL_POWER_UNIT, which powercap corrects for and this
+// fallback does not.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sched.h>
+#include "rapl.h"
+
+#define POWERCAP_DIR "/sys/class/powercap"
+
+#define MSR_RAPL_POWER_UNIT   0x606
+#define MSR_PKG_ENERGY_STATUS 0x611
+#define MSR_DRAM_ENERGY_STATUS 0x619
+#define MSR_PP0_ENERGY_STATUS 0x639
+
+static const char *domain_names[RAPL_DOMAINS] = { "package", "core", "dram" };
+static const char *source_names[] = { "none", "powercap", "msr" };
+static const uint32_t domain_msr[RAPL_DOMAINS] = {
+    MSR_PKG_ENERGY_STATUS, MSR_PP0_ENERGY_STATUS, MSR_DRAM_ENERGY_STATUS
+};
+
+static int read_u64_file(const char *path, uint64_t *v) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    unsigned long long x;
+    int ok = fscanf(f, "%llu", &x) == 1;
+    fclose(f);
+    if (!ok) return -1;
+    *v = x;
+    return 0;
+}
+
+static int read_name(const char *zone, char *buf, size_t len) {
+    char path[300];
+    snprintf(path, sizeof(path), POWERCAP_DIR "/%s/name", zone);
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (!ok) return -1;
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ------------------ Sources ------------------
+static int add_zone(rapl *r, rapl_domain d, const char *zone) {
+    uint64_t v, range;
+    char path[300];
+    snprintf(path, sizeof(path), POWERCAP_DIR "/%s/max_energy_range_uj", zone);
+    if (read_u64_file(path, &range)) return -1;
+    snprintf(path, sizeof(path), POWERCAP_DIR "/%s/energy_uj", zone);
+    if (strlen(path) >= sizeof(r->path[d]) || read_u64_file(path, &v)) return -1;
+    strcpy(r->path[d], path);
+    r->range_uj[d] = (double)range + 1.0;
+    r->present[d] = 1;
+    return 0;
+}
+
+static int open_powercap(rapl *r) {
+    DIR *dir = opendir(POWERCAP_DIR);
+    if (!dir) return -1;
+    char want[32], pkg_zone[64] = "";
+    snprintf(want, sizeof(want), "package-%d", r->package);
+    struct dirent *e;
+    while ((e = readdir(dir))) {
+        char name[64];
+        if (strncmp(e->d_name, "intel-rapl:", 11) || strchr(e->d_name + 11, ':')) continue;
+        if (read_name(e->d_name, name, sizeof(name)) == 0 && !strcmp(name, want) &&
+            strlen(e->d_name) < sizeof(pkg_zone))
+            strcpy(pkg_zone, e->d_name);
+    }
+    if (!pkg_zone[0] || add_zone(r, RAPL_PKG, pkg_zone)) {
+        closedir(dir);
+        return -1;
+    }
+    rewinddir(dir);
+    size_t n = strlen(pkg_zone);
+    while ((e = readdir(dir))) {
+        char name[64];
+        if (strncmp(e->d_name, pkg_zone, n) || e->d_name[n] != ':') continue;
+        if (read_name(e->d_name, name, sizeof(name))) continue;
+        if (!strcmp(name, "core")) add_zone(r, RAPL_CORE, e->d_name);
+        if (!strcmp(name, "dram")) add_zone(r, RAPL_DRAM, e->d_name);
+    }
+    closedir(dir);
+    return 0;
+}
+
+static int read_msr(int fd, uint32_t reg, uint64_t *v) {
+    return pread(fd, v, sizeof(*v), reg) == sizeof(*v) ? 0 : -1;
+}
+
+static int open_msr(rapl *r, int cpu) {
+    char path[64];
+    uint64_t unit, v;
+    snprintf(path, sizeof(path), "/dev/cpu/%d/msr", cpu);
+    r->msr_fd = open(path, O_RDONLY);
+    if (r->msr_fd < 0) return -1;
+    if (read_msr(r->msr_fd, MSR_RAPL_POWER_UNIT, &unit)) {
+        close(r->msr_fd);
+        r->msr_fd = -1;
+        return -1;
+    }
+    r->unit_uj = 1e6 / (double)(1ull << ((unit >> 8) & 0x1F));
+    for (int d = 0; d < RAPL_DOMAINS; d++) {
+        // an unimplemented domain faults or reads as a constant zero
+        r->present[d] = read_msr(r->msr_fd, domain_msr[d], &v) == 0 && v != 0;
+        r->range_uj[d] = 4294967296.0 * r->unit_uj;
+    }
+    return r->present[RAPL_PKG] ? 0 : -1;
+}
+
+// ------------------ Public ------------------
+int rapl_open(rapl *r, int cpu) {
+    memset(r, 0, sizeof(*r));
+    r->msr_fd = -1;
+    if (cpu < 0) cpu = sched_getcpu();
+    char path[128];
+    uint64_t pkg = 0;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    read_u64_file(path, &pkg);
+    r->package = (int)pkg;
+
+    if (open_powercap(r) == 0) {
+        r->source = RAPL_SRC_POWERCAP;
+        return 0;
+    }
+    memset(r->present, 0, sizeof(r->present));
+    if (open_msr(r, cpu) == 0) {
+        r->source = RAPL_SRC_MSR;
+        return 0;
+    }
+    memset(r->present, 0, sizeof(r->present));
+    r->source = RAPL_SRC_NONE;
+    return -1;
+}
+
+void rapl_close(rapl *r) {
+    if (r->msr_fd >= 0) close(r->msr_fd);
+    r->msr_fd = -1;
+    r->source = RAPL_SRC_NONE;
+}
+
+const char *rapl_domain_name(rapl_domain d) {
+    return domain_names[d];
+}
+
+const char *rapl_source_name(rapl_source s) {
+    return source_names[s];
+}
+
+static void read_all(const rapl *r, uint64_t *raw) {
+    for (int d = 0; d < RAPL_DOMAINS; d++) {
+        raw[d] = 0;
+        if (!r->present[d]) continue;
+        if (r->source == RAPL_SRC_POWERCAP) read_u64_file(r->path[d], &raw[d]);
+        else if (r->source == RAPL_SRC_MSR && read_msr(r->msr_fd, domain_msr[d], &raw[d]) == 0)
+            raw[d] &= 0xFFFFFFFFull;
+    }
+}
+
+void rapl_begin(const rapl *r, rapl_mark *m) {
+    read_all(r, m->raw);
+    m->t = now_sec();
+}
+
+void rapl_end(const rapl *r, const rapl_mark *m, rapl_energy *e) {
+    uint64_t raw[RAPL_DOMAINS];
+    double t = now_sec();
+    read_all(r, raw);
+    memset(e, 0, sizeof(*e));
+    e->seconds = t - m->t;
+    for (int d = 0; d < RAPL_DOMAINS; d++) {
+        if (!r->present[d]) continue;
+        double delta = (double)raw[d] - (double)m->raw[d];
+        if (r->source == RAPL_SRC_MSR) delta *= r->unit_uj;
+        if (delta < 0) delta += r->range_uj[d];
+        e->valid[d] = 1;
+        e->joules[d] = delta * 1e-6;
+        e->watts[d] = e->seconds > 0 ? e->joules[d] / e->seconds : 0.0;
+    }
+}
+
+void rapl_print(const rapl_energy *e, FILE *fp) {
+    for (int d = 0; d < RAPL_DOMAINS; d++) {
+        if (d) fprintf(fp, ", ");
+        if (e->valid[d]) fprintf(fp, "%s %.4f J %.2f W", domain_names[d], e->joules[d], e->watts[d]);
+        else fprintf(fp, "%s n/a", domain_names[d]);
+    }
+}
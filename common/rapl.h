@@ -0,0 +1,65 @@
+// rapl.h
+// ===============================================================
+// RAPL energy around a timed region, for one package:
+//   package   whole socket
+//   core      PP0, the cores only
+//   dram      memory controller / DIMMs
+// Sources, in order of preference:
+//   powercap  /sys/class/powercap/intel-rapl:N[:M]/energy_uj (the zone
+//             whose name is "package-<id>" for the CPU's package)
+//   msr       MSR_PKG/PP0/DRAM_ENERGY_STATUS from /dev/cpu/N/msr,
+//             scaled by MSR_RAPL_POWER_UNIT
+// Each counter wraps (powercap at max_energy_range_uj, the MSRs at
+// 32 bits); one wrap per region is undone, so a region must stay under
+// the wrap period (about a minute at full package power).
+// The counters update about once per millisecond: regions shorter than
+// ~100 ms give coarse numbers. Domains a host does not expose are
+// marked unavailable; without RAPL at all rapl_open() fails and every
+// figure is reported as missing.
+// ===============================================================
+#ifndef BENCH_RAPL_H
+#define BENCH_RAPL_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef enum { RAPL_PKG, RAPL_CORE, RAPL_DRAM, RAPL_DOMAINS } rapl_domain;
+typedef enum { RAPL_SRC_NONE, RAPL_SRC_POWERCAP, RAPL_SRC_MSR } rapl_source;
+
+typedef struct {
+    rapl_source source;
+    int         package;
+    int         present[RAPL_DOMAINS];
+    char        path[RAPL_DOMAINS][128];   // powercap energy_uj files
+    double      range_uj[RAPL_DOMAINS];    // counter wraps here
+    int         msr_fd;
+    double      unit_uj;                   // MSR energy status unit
+} rapl;
+
+typedef struct {
+    uint64_t raw[RAPL_DOMAINS];
+    double   t;                            // CLOCK_MONOTONIC seconds
+} rapl_mark;
+
+typedef struct {
+    int    valid[RAPL_DOMAINS];
+    double joules[RAPL_DOMAINS];
+    double watts[RAPL_DOMAINS];
+    double seconds;
+} rapl_energy;
+
+// Counters for the package of `cpu` (-1: the CPU the caller is on).
+// Returns 0, or -1 (source RAPL_SRC_NONE) when no domain is readable.
+int  rapl_open(rapl *r, int cpu);
+void rapl_close(rapl *r);
+
+const char *rapl_domain_name(rapl_domain d);   // "package", "core", "dram"
+const char *rapl_source_name(rapl_source s);
+
+void rapl_begin(const rapl *r, rapl_mark *m);
+void rapl_end(const rapl *r, const rapl_mark *m, rapl_energy *e);
+
+// "pkg 12.3 J 45.6 W, core ..., dram n/a"
+void rapl_print(const rapl_energy *e, FILE *fp);
+
+#endif
@@ -0,0 +1,73 @@
+// sysfs.c
+// ===============================================================
+// stdio for reads; writes go through open/write/close only, as the
+// isolation exit hooks restore IRQ affinities from a signal handler.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "sysfs.h"
+
+// ------------------ Files ------------------
+int sysfs_read_line(const char *path, char *buf, size_t len) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (!ok) return -1;
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+int sysfs_read_int(const char *path, int *v) {
+    char buf[64];
+    if (sysfs_read_line(path, buf, sizeof(buf))) return -1;
+    char *end;
+    long x = strtol(buf, &end, 10);
+    if (end == buf) return -1;
+    *v = (int)x;
+    return 0;
+}
+
+int sysfs_write_str(const char *path, const char *s) {
+    int fd = open(path, O_WRONLY);
+    if (fd < 0) return -1;
+    ssize_t n = write(fd, s, strlen(s));
+    close(fd);
+    return n == (ssize_t)strlen(s) ? 0 : -1;
+}
+
+// ------------------ cpulist ------------------
+int sysfs_parse_cpulist(const char *s, cpu_set_t *set) {
+    int lowest = -1;
+    CPU_ZERO(set);
+    while (*s) {
+        char *end;
+        long lo = strtol(s, &end, 10), hi = lo;
+        if (end == s) break;
+        if (*end == '-') hi = strtol(end + 1, &end, 10);
+        for (long c = lo; c <= hi && c < CPU_SETSIZE; c++) {
+            CPU_SET(c, set);
+            if (lowest < 0) lowest = (int)c;
+        }
+        if (*end != ',') break;
+        s = end + 1;
+    }
+    return lowest;
+}
+
+void sysfs_format_cpulist(const cpu_set_t *set, char *buf, size_t len) {
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (int c = 0; c < CPU_SETSIZE && pos < len; c++) {
+        if (!CPU_ISSET(c, set)) continue;
+        int hi = c;
+        while (hi + 1 < CPU_SETSIZE && CPU_ISSET(hi + 1, set)) hi++;
+        pos += snprintf(buf + pos, len - pos, pos ? ",%d" : "%d", c);
+        if (hi > c && pos < len) pos += snprintf(buf + pos, len - pos, "-%d", hi);
+        c = hi;
+    }
+}
@@ -0,0 +1,27 @@
+// sysfs.h
+// ===============================================================
+// sysfs/procfs file access shared by the topology, preflight and
+// isolation modules:
+//   sysfs_read_line   first line of a file, trailing newline removed
+//   sysfs_read_int    that line as a decimal integer
+//   sysfs_write_str   a string written with one open/write/close, so
+//                     it is safe to call from a signal handler
+//   cpulist           the "0-3,8,10-11" format of cpu lists, parsed
+//                     into and formatted from a cpu_set_t
+// Functions return 0 on success and -1 on failure.
+// ===============================================================
+#ifndef BENCH_SYSFS_H
+#define BENCH_SYSFS_H
+
+#include <stddef.h>
+#include <sched.h>
+
+int sysfs_read_line(const char *path, char *buf, size_t len);
+int sysfs_read_int(const char *path, int *v);
+int sysfs_write_str(const char *path, const char *s);
+
+// returns the lowest CPU in the list, or -1 if it is empty
+int sysfs_parse_cpulist(const char *s, cpu_set_t *set);
+void sysfs_format_cpulist(const cpu_set_t *set, char *buf, size_t len);
+
+#endif
@@ -0,0 +1,33 @@
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+
+// ---------- median helpers ----------
+static int cmp_double(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t ua = *(const uint64_t *)a, ub = *(const uint64_t *)b;
+    return (ua > ub) - (ua < ub);
+}
+
+double median(double *vals, int n) {
+    if (n <= 0) return 0.0;
+    double *tmp = malloc(n * sizeof(double));
+    memcpy(tmp, vals, n * sizeof(double));
+    qsort(tmp, n, sizeof(double), cmp_double);
+    double med = (n % 2) ? tmp[n/2] : 0.5*(tmp[n/2-1]+tmp[n/2]);
+    free(tmp);
+    return med;
+}
+
+uint64_t median_u64(uint64_t *vals, int n) {
+    if (n <= 0) return 0;
+    uint64_t *tmp = malloc(n * sizeof(uint64_t));
+    memcpy(tmp, vals, n * sizeof(uint64_t));
+    qsort(tmp, n, sizeof(uint64_t), cmp_u64);
+    uint64_t med = tmp[n/2];
+    free(tmp);
+    return med;
+}
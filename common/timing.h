@@ -0,0 +1,38 @@
+// timing.h
+// ===============================================================
+// Shared cycle-timing helpers for the benchmark sections.
+// rdtsc_begin/rdtsc_end are the cpuid-fenced pair from 5.3's
+// cache_study.c; median() is used to collapse trial vectors.
+// ===============================================================
+#ifndef BENCH_TIMING_H
+#define BENCH_TIMING_H
+
+#include <stdint.h>
+
+// ---------- timing helpers ----------
+static inline uint64_t rdtsc_begin(void) {
+    unsigned a, d;
+    __asm__ __volatile__("cpuid\n\t"
+                         "rdtsc\n\t"
+                         : "=a"(a), "=d"(d)
+                         :
+                         : "rbx", "rcx");
+    return ((uint64_t)d << 32) | a;
+}
+static inline uint64_t rdtsc_end(void) {
+    unsigned a, d;
+    __asm__ __volatile__("rdtscp\n\t"
+                         "mov %%eax, %0\n\t"
+                         "mov %%edx, %1\n\t"
+                         "cpuid\n\t"
+                         : "=r"(a), "=r"(d)
+                         :
+                         : "rax","rbx","rcx","rdx");
+    return ((uint64_t)d << 32) | a;
+}
+
+// ---------- median helpers ----------
+double median(double *vals, int n);
+uint64_t median_u64(uint64_t *vals, int n);
+
+#endif
@@ -0,0 +1,269 @@
+// topology.c
+// ===============================================================
+// sysfs first, CPUID for whatever sysfs does not expose. The CPUID
+// ids come from the x2APIC id split at the SMT and package shifts of
+// leaf 0x1F (or 0xB), and the LLC id from the sharing width in leaf 4.
+// ===============================================================
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cpuid.h>
+#include "topology.h"
+#include "sysfs.h"
+
+// ------------------ sysfs ------------------
+// lowest CPU sharing the highest-level data/unified cache with `cpu`
+static int sysfs_llc(int cpu) {
+    int best_level = -1, llc = -1;
+    for (int i = 0; ; i++) {
+        char path[128], buf[4096];
+        int level;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, i);
+        if (sysfs_read_int(path, &level)) break;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/type", cpu, i);
+        if (sysfs_read_line(path, buf, sizeof(buf)) || !strncmp(buf, "Instruction", 11)) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, i);
+        if (level <= best_level || sysfs_read_line(path, buf, sizeof(buf))) continue;
+        cpu_set_t set;
+        int lowest = sysfs_parse_cpulist(buf, &set);
+        if (lowest >= 0) {
+            best_level = level;
+            llc = lowest;
+        }
+    }
+    return llc;
+}
+
+static void sysfs_nodes(topology *t) {
+    DIR *d = opendir("/sys/devices/system/node");
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        int node;
+        char path[300], buf[4096];
+        if (sscanf(e->d_name, "node%d", &node) != 1) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/node/%s/cpulist", e->d_name);
+        if (sysfs_read_line(path, buf, sizeof(buf))) continue;
+        cpu_set_t set;
+        sysfs_parse_cpulist(buf, &set);
+        for (int i = 0; i < t->n; i++)
+            if (CPU_ISSET(t->cpus[i].cpu, &set)) t->cpus[i].node = node;
+    }
+    closedir(d);
+}
+
+// ------------------ CPUID ------------------
+typedef struct {
+    uint32_t apic_id;
+    int      smt_shift, pkg_shift, llc_shift;
+} cpuid_ids;
+
+static int ceil_log2(unsigned v) {
+    int s = 0;
+    while ((1u << s) < v) s++;
+    return s;
+}
+
+// must run on the CPU being described
+static void cpuid_read(cpuid_ids *id) {
+    unsigned eax, ebx, ecx, edx, max_leaf = __get_cpuid_max(0, NULL);
+    memset(id, 0, sizeof(*id));
+
+    unsigned leaf = 0;
+    if (max_leaf >= 0x1F) {
+        __cpuid_count(0x1F, 0, eax, ebx, ecx, edx);
+        if (ebx) leaf = 0x1F;
+    }
+    if (!leaf && max_leaf >= 0xB) {
+        __cpuid_count(0xB, 0, eax, ebx, ecx, edx);
+        if (ebx) leaf = 0xB;
+    }
+    if (leaf) {
+        for (unsigned sub = 0; sub < 8; sub++) {
+            __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+            unsigned type = (ecx >> 8) & 0xFF;
+            if (!type) break;
+            if (type == 1) id->smt_shift = eax & 0x1F;
+            id->pkg_shift = eax & 0x1F;   // the last level spans the package
+            id->apic_id = edx;
+        }
+    } else {
+        // legacy: 8-bit APIC id, logical processors per package from leaf 1
+        __cpuid(1, eax, ebx, ecx, edx);
+        id->apic_id = ebx >> 24;
+        id->pkg_shift = ceil_log2((ebx >> 16) & 0xFF);
+    }
+
+    id->llc_shift = id->pkg_shift;
+    if (max_leaf >= 4) {
+        int best = 0;
+        for (unsigned sub = 0; sub < 16; sub++) {
+            __cpuid_count(4, sub, eax, ebx, ecx, edx);
+            unsigned type = eax & 0x1F, level = (eax >> 5) & 0x7;
+            if (!type) break;
+            if (type == 2 || (int)level <= best) continue;   // instruction cache
+            best = level;
+            id->llc_shift = ceil_log2(((eax >> 14) & 0xFFF) + 1);
+        }
+    }
+}
+
+// ------------------ Load ------------------
+int topo_load(topology *t) {
+    memset(t, 0, sizeof(*t));
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed)) return -1;
+
+    cpu_set_t isolated;
+    char buf[4096];
+    CPU_ZERO(&isolated);
+    if (!sysfs_read_line("/sys/devices/system/cpu/isolated", buf, sizeof(buf)))
+        sysfs_parse_cpulist(buf, &isolated);
+
+    int used_sysfs = 0, used_cpuid = 0;
+    for (int c = 0; c < CPU_SETSIZE && t->n < TOPO_MAX_CPUS; c++) {
+        if (!CPU_ISSET(c, &allowed)) continue;
+        topo_cpu *p = &t->cpus[t->n++];
+        p->cpu = c;
+        p->isolated = CPU_ISSET(c, &isolated) != 0;
+
+        cpuid_ids id = { 0 };
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(c, &one);
+        if (!sched_setaffinity(0, sizeof(one), &one)) cpuid_read(&id);
+        p->apic_id = id.apic_id;
+
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c);
+        int have_pkg = !sysfs_read_int(path, &p->package);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", c);
+        int have_core = !sysfs_read_int(path, &p->core);
+        p->llc = sysfs_llc(c);
+        used_sysfs |= have_pkg || have_core || p->llc >= 0;
+        if (!have_pkg || !have_core || p->llc < 0) used_cpuid = 1;
+        if (!have_pkg)  p->package = (int)(id.apic_id >> id.pkg_shift);
+        if (!have_core) p->core = (int)((id.apic_id & ((1u << id.pkg_shift) - 1)) >> id.smt_shift);
+        // offset keeps CPUID ids apart from the sysfs "lowest CPU" ids
+        if (p->llc < 0) p->llc = TOPO_MAX_CPUS + (int)(id.apic_id >> id.llc_shift);
+    }
+    sched_setaffinity(0, sizeof(allowed), &allowed);
+    if (!t->n) return -1;
+    sysfs_nodes(t);
+    t->source = used_sysfs && used_cpuid ? "sysfs+cpuid" : used_sysfs ? "sysfs" : "cpuid";
+
+    for (int i = 0; i < t->n; i++) {
+        topo_cpu *p = &t->cpus[i];
+        int first_core = 1, first_pkg = 1, first_llc = 1, first_node = 1;
+        for (int j = 0; j < i; j++) {
+            const topo_cpu *q = &t->cpus[j];
+            if (topo_same_core(p, q)) { p->smt++; first_core = 0; }
+            if (q->package == p->package) first_pkg = 0;
+            if (q->llc == p->llc) first_llc = 0;
+            if (q->node == p->node) first_node = 0;
+        }
+        t->n_cores += first_core;
+        t->n_packages += first_pkg;
+        t->n_llcs += first_llc;
+        t->n_nodes += first_node;
+        t->n_isolated += p->isolated;
+        t->has_smt |= p->smt > 0;
+    }
+    return 0;
+}
+
+void topo_describe(const topology *t, FILE *fp) {
+    fprintf(fp, "Topology: %d CPUs, %d package(s), %d core(s)%s, %d LLC domain(s), "
+                "%d NUMA node(s), %d isolated (from %s)\n",
+            t->n, t->n_packages, t->n_cores, t->has_smt ? " with SMT" : "", t->n_llcs,
+            t->n_nodes, t->n_isolated, t->source);
+}
+
+const topo_cpu *topo_find(const topology *t, int cpu) {
+    for (int i = 0; i < t->n; i++)
+        if (t->cpus[i].cpu == cpu) return &t->cpus[i];
+    return NULL;
+}
+
+int topo_same_core(const topo_cpu *a, const topo_cpu *b) {
+    return a->package == b->package && a->core == b->core;
+}
+
+// ------------------ Placement ------------------
+static const char *placement_names[TOPO_PLACEMENT_COUNT] = { "smt", "llc", "socket" };
+
+const char *topo_placement_name(topo_placement p) {
+    return p >= 0 && p < TOPO_PLACEMENT_COUNT ? placement_names[p] : "?";
+}
+
+int topo_placement_parse(const char *name) {
+    for (int p = 0; p < TOPO_PLACEMENT_COUNT; p++)
+        if (!strcmp(name, placement_names[p])) return p;
+    return -1;
+}
+
+static int pair_fits(topo_placement p, const topo_cpu *a, const topo_cpu *b) {
+    switch (p) {
+    case TOPO_SMT_PAIR:    return topo_same_core(a, b);
+    case TOPO_LLC_PAIR:    return !topo_same_core(a, b) && a->llc == b->llc;
+    case TOPO_SOCKET_PAIR: return a->package != b->package;
+    default:               return 0;
+    }
+}
+
+// lower is better: isolated CPUs first, CPU 0 last
+static int cpu_cost(const topo_cpu *c) {
+    return (c->isolated ? 0 : 2) + (c->cpu == 0 ? 1 : 0);
+}
+
+int topo_pair(const topology *t, topo_placement p, int *a, int *b) {
+    int best = -1;
+    for (int i = 0; i < t->n; i++)
+        for (int j = i + 1; j < t->n; j++) {
+            if (!pair_fits(p, &t->cpus[i], &t->cpus[j])) continue;
+            int cost = cpu_cost(&t->cpus[i]) + cpu_cost(&t->cpus[j]);
+            if (best < 0 || cost < best) {
+                best = cost;
+                *a = t->cpus[i].cpu;
+                *b = t->cpus[j].cpu;
+            }
+        }
+    return best < 0 ? -1 : 0;
+}
+
+int topo_quiet_cpu(const topology *t) {
+    for (int i = 0; i < t->n; i++)
+        if (t->cpus[i].isolated) return t->cpus[i].cpu;
+    for (int i = t->n - 1; i >= 0; i--)
+        if (t->cpus[i].smt == 0) return t->cpus[i].cpu;
+    return t->n ? t->cpus[0].cpu : 0;
+}
+
+static int cmp_spread(const void *a, const void *b) {
+    const topo_cpu *x = a, *y = b;
+    if (x->smt != y->smt) return x->smt - y->smt;
+    if (x->package != y->package) return x->package - y->package;
+    return x->core != y->core ? x->core - y->core : x->cpu - y->cpu;
+}
+
+static int cmp_packed(const void *a, const void *b) {
+    const topo_cpu *x = a, *y = b;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->core != y->core) return x->core - y->core;
+    return x->smt - y->smt;
+}
+
+void topo_order(const topology *t, int order, topo_cpu *out) {
+    memcpy(out, t->cpus, t->n * sizeof(topo_cpu));
+    qsort(out, t->n, sizeof(topo_cpu), order == TOPO_PACKED ? cmp_packed : cmp_spread);
+}
+
+int topo_pin_self(int cpu) {
+    cpu_set_t cs;
+    CPU_ZERO(&cs);
+    CPU_SET(cpu, &cs);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs) ? -1 : 0;
+}
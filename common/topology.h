@@ -0,0 +1,81 @@
+// topology.h
+// ===============================================================
+// CPU topology of the CPUs this process may run on, so benchmarks pick
+// their own placements instead of taking CPU numbers on the command
+// line. Sources, in order of trust:
+//   /sys/devices/system/cpu/cpuN/topology   package, core
+//   /sys/devices/system/cpu/cpuN/cache      last-level cache sharing
+//   /sys/devices/system/node/nodeN/cpulist  NUMA node
+//   /sys/devices/system/cpu/isolated        isolcpus= list
+//   CPUID 0x1F / 0xB (and 4 for the LLC)    x2APIC ids, read on each
+//                                           CPU; fills whatever sysfs
+//                                           hides (containers, old kernels)
+// ===============================================================
+#ifndef BENCH_TOPOLOGY_H
+#define BENCH_TOPOLOGY_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define TOPO_MAX_CPUS 1024
+
+typedef struct {
+    int      cpu;        // logical CPU number
+    int      package;
+    int      core;       // core id within the package
+    int      smt;        // 0 for the first allowed thread of its core, 1 for the next...
+    int      llc;        // LLC domain id (only compared for equality)
+    int      node;       // NUMA node, 0 without NUMA information
+    int      isolated;   // listed in isolcpus=
+    uint32_t apic_id;    // x2APIC id from CPUID
+} topo_cpu;
+
+typedef struct {
+    int      n;                        // allowed CPUs, ascending cpu number
+    topo_cpu cpus[TOPO_MAX_CPUS];
+    int      n_packages, n_cores, n_llcs, n_nodes, n_isolated;
+    int      has_smt;                  // some core has two allowed threads
+    const char *source;                // "sysfs", "cpuid" or "sysfs+cpuid"
+} topology;
+
+// Fills `t` for the calling thread's affinity mask. Returns 0 on success.
+// Briefly migrates the calling thread to each CPU for CPUID and then
+// restores its affinity, so call it before pinning anything.
+int topo_load(topology *t);
+
+// One-line summary: CPUs, packages, cores, LLCs, nodes, isolated, source.
+void topo_describe(const topology *t, FILE *fp);
+
+const topo_cpu *topo_find(const topology *t, int cpu);
+int topo_same_core(const topo_cpu *a, const topo_cpu *b);
+
+// Two-thread placements, in increasing distance.
+typedef enum {
+    TOPO_SMT_PAIR,       // SMT siblings of one physical core
+    TOPO_LLC_PAIR,       // different cores sharing a last-level cache
+    TOPO_SOCKET_PAIR,    // different packages
+    TOPO_PLACEMENT_COUNT
+} topo_placement;
+
+const char *topo_placement_name(topo_placement p);   // "smt", "llc", "socket"
+int topo_placement_parse(const char *name);          // -1 if unknown
+
+// Picks a pair for `p`, preferring isolated CPUs and avoiding CPU 0.
+// Returns 0 and sets *a, *b, or -1 if the allowed CPUs have no such pair.
+int topo_pair(const topology *t, topo_placement p, int *a, int *b);
+
+// CPU for a single-threaded measurement: an isolated CPU if there is
+// one, else the first thread of the last allowed core (CPU 0 takes most
+// housekeeping interrupts).
+int topo_quiet_cpu(const topology *t);
+
+// Worker orders for scaling runs, copied into out[0..t->n-1]:
+//   spread  one thread per physical core before any SMT sibling
+//   packed  both SMT siblings of a core before the next core
+enum { TOPO_SPREAD, TOPO_PACKED };
+void topo_order(const topology *t, int order, topo_cpu *out);
+
+// Pins the calling thread. Returns 0 on success.
+int topo_pin_self(int cpu);
+
+#endif